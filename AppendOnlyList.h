@@ -0,0 +1,77 @@
+#ifndef APPEND_ONLY_LIST_H
+#define APPEND_ONLY_LIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+// Append-only list that readers can walk without locking while another
+// thread appends. Elements live in segments that double in size and never
+// move; an append fills its slot first and then publishes the new size,
+// so any index below size() is safe to read. Appends are serialized.
+template <typename T>
+class AppendOnlyList {
+private:
+    static constexpr std::size_t FIRST_SEGMENT_BITS = 3;                 // 8 slots
+    static constexpr std::size_t MAX_SEGMENTS = 48;
+
+    std::atomic<T*> segments[MAX_SEGMENTS] = {};
+    std::atomic<std::size_t> count{0};
+    std::mutex appendMutex;
+
+    // Segment k holds indices [8 * (2^k - 1), 8 * (2^(k+1) - 1))
+    static std::size_t segmentOf(std::size_t index, std::size_t& offset) {
+        std::size_t biased = (index >> FIRST_SEGMENT_BITS) + 1;
+        std::size_t seg = 0;
+        while ((biased >> (seg + 1)) != 0) ++seg;
+        offset = index - ((((std::size_t)1 << seg) - 1) << FIRST_SEGMENT_BITS);
+        return seg;
+    }
+
+    static std::size_t segmentSize(std::size_t seg) {
+        return (std::size_t)1 << (seg + FIRST_SEGMENT_BITS);
+    }
+
+public:
+    AppendOnlyList() = default;
+    ~AppendOnlyList() { clear(); }
+
+    AppendOnlyList(const AppendOnlyList&) = delete;
+    AppendOnlyList& operator=(const AppendOnlyList&) = delete;
+
+    void push_back(const T& value) {
+        std::lock_guard<std::mutex> lock(appendMutex);
+        std::size_t index = count.load(std::memory_order_relaxed);
+        std::size_t offset;
+        std::size_t seg = segmentOf(index, offset);
+
+        T* block = segments[seg].load(std::memory_order_relaxed);
+        if (!block) {
+            block = new T[segmentSize(seg)]();
+            segments[seg].store(block, std::memory_order_release);
+        }
+        block[offset] = value;
+        count.store(index + 1, std::memory_order_release);
+    }
+
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    // index must be below a size() this thread has already observed
+    const T& operator[](std::size_t index) const {
+        std::size_t offset;
+        std::size_t seg = segmentOf(index, offset);
+        return segments[seg].load(std::memory_order_acquire)[offset];
+    }
+
+    // Not safe against concurrent readers
+    void clear() {
+        std::lock_guard<std::mutex> lock(appendMutex);
+        for (std::size_t i = 0; i < MAX_SEGMENTS; ++i) {
+            delete[] segments[i].exchange(nullptr, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_release);
+    }
+};
+
+#endif // APPEND_ONLY_LIST_H
@@ -1,41 +1,15 @@
 #include "AuthenticationService.h"
+#include "RenderBuffer.h"
+#include "LatencyTrace.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 
-const std::string AuthenticationService::USERS_FILE = "users.txt";
+AuthenticationService::AuthenticationService(UserDirectory& users) : directory(users) {}
 
-AuthenticationService::AuthenticationService() {
-    loadUsersFromFile();
-}
-
-void AuthenticationService::loadUsersFromFile() {
-    std::ifstream in(USERS_FILE);
-    if (!in.is_open()) return;
-
-    int id;
-    std::string u, p;
-    while (in >> id >> u >> p) {
-        users.emplace_back(id, u, p);
-        usernameToUserId[u] = id;
-        nextUserId = std::max(nextUserId, id + 1);
-    }
-    in.close();
-}
-
-void AuthenticationService::saveUsersToFile() const {
-    std::ofstream out(USERS_FILE);
-    if (!out.is_open()) return;
-
-    for (const auto& user : users) {
-        out << user.getUserId() << " "
-            << user.getUsername() << " "
-            << user.getPassword() << "\n";
-    }
-    out.close();
-}
-
-bool AuthenticationService::registerUser(const std::string& username, const std::string& password) {
+bool AuthenticationService::registerUser(const std::string& username, const std::string& password,
+                                         const std::string& displayName) {
+    TRACE_SCOPE("AuthenticationService::registerUser");
     if (username.empty() || username.find(' ') != std::string::npos) {
         std::cout << "Invalid username.\n";
         return false;
@@ -44,75 +18,83 @@ bool AuthenticationService::registerUser(const std::string& username, const std:
         std::cout << "Password too short (min 8 chars).\n";
         return false;
     }
-    if (usernameToUserId.count(username)) {
+    if (directory.findByName(username)) {
         std::cout << "Username already exists.\n";
         return false;
     }
 
-    int newId = nextUserId++;
-    users.emplace_back(newId, username, password);
-    usernameToUserId[username] = newId;
-    saveUsersToFile();
+    User* user = directory.addUser(username, password, displayName);
+    if (!user) {
+        std::cout << "Invalid username.\n";
+        return false;
+    }
 
-    std::cout << "User created: " << username << " (ID " << newId << ")\n";
+    std::cout << "User created: " << username << " (ID " << user->getUserId() << ")\n";
     return true;
 }
 
 int AuthenticationService::login(const std::string& username, const std::string& password) const {
-    auto it = usernameToUserId.find(username);
-    if (it == usernameToUserId.end()) {
+    TRACE_SCOPE("AuthenticationService::login");
+    const User* user = directory.findByName(username);
+    if (!user) {
         std::cout << "User not found.\n";
         return -1;
     }
 
-    int id = it->second;
-    for (const auto& u : users) {
-        if (u.getUserId() == id && u.getPassword() == password) {
-            std::cout << "Login successful: " << username << "\n";
-            return id;
-        }
+    // Accounts created from the messenger have no password yet
+    if (!user->getPasswordView().empty() && user->getPasswordView() == password) {
+        std::cout << "Login successful: " << username << "\n";
+        return user->getUserId();
     }
     std::cout << "Incorrect password.\n";
     return -1;
 }
 
+std::string AuthenticationService::startSession(const std::string& username, const std::string& password) {
+    int userId = login(username, password);
+    return userId == -1 ? std::string() : sessions.create(userId);
+}
+
+int AuthenticationService::validateSession(const std::string& token) {
+    return sessions.validate(token);
+}
+
+bool AuthenticationService::endSession(const std::string& token) {
+    return sessions.end(token);
+}
+
 User* AuthenticationService::findUserById(int id) {
-    for (auto& u : users) {
-        if (u.getUserId() == id) return &u;
-    }
-    return nullptr;
+    return directory.findById(id);
 }
 
 const User* AuthenticationService::findUserById(int id) const {
-    for (const auto& u : users) {
-        if (u.getUserId() == id) return &u;
-    }
-    return nullptr;
+    return static_cast<const UserDirectory&>(directory).findById(id);
 }
 
 User* AuthenticationService::findUserByUsername(const std::string& username) {
-    auto it = usernameToUserId.find(username);
-    if (it == usernameToUserId.end()) return nullptr;
-    return findUserById(it->second);
+    return directory.findByName(username);
 }
 
 const User* AuthenticationService::findUserByUsername(const std::string& username) const {
-    auto it = usernameToUserId.find(username);
-    if (it == usernameToUserId.end()) return nullptr;
-    return findUserById(it->second);
+    return static_cast<const UserDirectory&>(directory).findByName(username);
 }
 
 void AuthenticationService::listAllUsers() const {
-    std::cout << "\nRegistered users:\n";
-    for (const auto& u : users) {
-        u.printBasicInfo();
+    RenderBuffer out;
+    out << "\nRegistered users:\n";
+    for (const auto& u : directory.getUsers()) {
+        u.printBasicInfo(out);
     }
 }
 
-std::vector<User>& AuthenticationService::getUsers() {
-    return users;
+std::deque<User>& AuthenticationService::getUsers() {
+    return directory.getUsers();
+}
+
+UserDirectory& AuthenticationService::getDirectory() {
+    return directory;
 }
 
-std::map<std::string, int>& AuthenticationService::getUsernameToIdMap() {
-    return usernameToUserId;
+SessionTable& AuthenticationService::getSessions() {
+    return sessions;
 }
\ No newline at end of file
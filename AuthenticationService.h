@@ -2,28 +2,35 @@
 #define AUTHENTICATION_SERVICE_H
 
 #include "User.h"
-#include <vector>
-#include <map>
+#include "UserDirectory.h"
+#include "SessionTable.h"
+#include <deque>
 #include <string>
 
+// Registration and login for the social side, on top of the shared
+// UserDirectory (the messenger uses the same accounts). Logins can be
+// held as session tokens (SessionTable) that any request can present.
 class AuthenticationService {
 private:
-    std::vector<User> users;
-    std::map<std::string, int> usernameToUserId;
+    UserDirectory& directory;
+    SessionTable sessions;
 
-    int nextUserId = 1;
+public:
+    explicit AuthenticationService(UserDirectory& users);
 
-    static const std::string USERS_FILE;
+    bool registerUser(const std::string& username, const std::string& password,
+                      const std::string& displayName = "");
 
-    void loadUsersFromFile();
-    void saveUsersToFile() const;
+    int login(const std::string& username, const std::string& password) const;
 
-public:
-    AuthenticationService();
+    // Logs in and returns a session token, or "" if the login failed
+    std::string startSession(const std::string& username, const std::string& password);
 
-    bool registerUser(const std::string& username, const std::string& password);
+    // The user ID behind a token, or -1 if it is unknown or has expired;
+    // each successful check restarts the session's idle timeout
+    int validateSession(const std::string& token);
 
-    int login(const std::string& username, const std::string& password) const;
+    bool endSession(const std::string& token);
 
     User*       findUserById(int id);
     const User* findUserById(int id) const;
@@ -34,8 +41,9 @@ public:
     void listAllUsers() const;
 
     // Allow FriendService / SocialNetwork to access users
-    std::vector<User>&       getUsers();
-    std::map<std::string, int>& getUsernameToIdMap();
+    std::deque<User>&        getUsers();
+    UserDirectory&           getDirectory();
+    SessionTable&            getSessions();
 };
 
 #endif // AUTHENTICATION_SERVICE_H
\ No newline at end of file
@@ -0,0 +1,194 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One parsed script line. args[0] is the command name; text(i) is the
+// rest of the line from argument i on, spacing kept, for message bodies.
+struct BatchCommand {
+    std::vector<std::string> args;
+    std::string line;
+    std::vector<std::size_t> offsets;    // where each argument starts in line
+
+    std::size_t size() const { return args.size(); }
+    const std::string& operator[](std::size_t i) const { return args[i]; }
+
+    std::string text(std::size_t from) const {
+        return from < offsets.size() ? line.substr(offsets[from]) : std::string();
+    }
+};
+
+// Headless driver for the front ends. Commands are registered by name with
+// a handler that returns false when the operation was refused. A script
+// (one command per line; lines starting with '#' are comments) is run
+// with the services' console output discarded, and every call is timed.
+// report() prints per-command throughput and latency percentiles.
+class BatchRunner {
+public:
+    using Handler = std::function<bool(const BatchCommand&)>;
+
+private:
+    struct Command {
+        std::size_t minArgs;
+        std::string usage;
+        Handler handler;
+    };
+
+    struct Stats {
+        std::vector<std::uint64_t> samples;    // nanoseconds per call
+        std::size_t failures = 0;
+        std::uint64_t totalNs = 0;
+    };
+
+    // Discards everything written to it
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    std::map<std::string, Command> commands;
+    std::map<std::string, Stats> stats;
+    std::size_t errors = 0;
+    double wallSeconds = 0;
+
+    static BatchCommand parse(const std::string& line) {
+        BatchCommand cmd;
+        cmd.line = line;
+        std::size_t i = 0;
+        while (true) {
+            i = line.find_first_not_of(" \t\r", i);
+            if (i == std::string::npos || (line[i] == '#' && cmd.args.empty())) break;
+            std::size_t end = line.find_first_of(" \t\r", i);
+            if (end == std::string::npos) end = line.size();
+            cmd.offsets.push_back(i);
+            cmd.args.push_back(line.substr(i, end - i));
+            i = end;
+        }
+        return cmd;
+    }
+
+    static double percentile(const std::vector<std::uint64_t>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        std::size_t rank = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[rank]);
+    }
+
+public:
+    // minArgs counts the arguments after the command name
+    void add(const std::string& name, std::size_t minArgs, const std::string& usage, Handler handler) {
+        commands[name] = Command{minArgs, usage, std::move(handler)};
+    }
+
+    // Runs every line of the script; malformed lines are reported on
+    // `diagnostics` and skipped. Returns false if any line was malformed.
+    bool run(std::istream& script, std::ostream& diagnostics = std::cerr) {
+        NullBuffer null;
+        std::string line;
+        std::size_t lineNumber = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        while (std::getline(script, line)) {
+            ++lineNumber;
+            BatchCommand cmd = parse(line);
+            if (cmd.args.empty()) continue;
+
+            auto it = commands.find(cmd[0]);
+            if (it == commands.end()) {
+                diagnostics << "line " << lineNumber << ": unknown command '" << cmd[0] << "'\n";
+                ++errors;
+                continue;
+            }
+            if (cmd.size() - 1 < it->second.minArgs) {
+                diagnostics << "line " << lineNumber << ": usage: " << cmd[0] << " " << it->second.usage << "\n";
+                ++errors;
+                continue;
+            }
+
+            std::streambuf* saved = std::cout.rdbuf(&null);
+            auto t0 = std::chrono::steady_clock::now();
+            bool ok = it->second.handler(cmd);
+            auto t1 = std::chrono::steady_clock::now();
+            std::cout.rdbuf(saved);
+
+            std::uint64_t ns = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            Stats& s = stats[cmd[0]];
+            s.samples.push_back(ns);
+            s.totalNs += ns;
+            if (!ok) ++s.failures;
+        }
+
+        wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return errors == 0;
+    }
+
+    // Runs the script at `path` ("-" for standard input), prints the report
+    // and returns a process exit code
+    int runFile(const std::string& path) {
+        bool ok;
+        if (path == "-") {
+            ok = run(std::cin);
+        } else {
+            std::ifstream script(path);
+            if (!script.is_open()) {
+                std::cerr << "Cannot open script " << path << "\n";
+                return 1;
+            }
+            ok = run(script);
+        }
+        report(std::cout);
+        return ok ? 0 : 1;
+    }
+
+    void report(std::ostream& out) const {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        std::size_t total = 0;
+        out << std::left << std::setw(18) << "command" << std::right
+            << std::setw(9) << "calls" << std::setw(8) << "failed" << std::setw(12) << "ops/s"
+            << std::setw(11) << "mean us" << std::setw(11) << "p50 us" << std::setw(11) << "p99 us"
+            << std::setw(11) << "max us" << "\n";
+
+        for (const auto& [name, s] : stats) {
+            std::vector<std::uint64_t> sorted = s.samples;
+            std::sort(sorted.begin(), sorted.end());
+            double calls = static_cast<double>(sorted.size());
+            total += sorted.size();
+
+            out << std::left << std::setw(18) << name << std::right
+                << std::setw(9) << sorted.size() << std::setw(8) << s.failures
+                << std::fixed << std::setprecision(0)
+                << std::setw(12) << (s.totalNs ? calls * 1e9 / static_cast<double>(s.totalNs) : 0.0)
+                << std::setprecision(1)
+                << std::setw(11) << static_cast<double>(s.totalNs) / calls / 1e3
+                << std::setw(11) << percentile(sorted, 0.50) / 1e3
+                << std::setw(11) << percentile(sorted, 0.99) / 1e3
+                << std::setw(11) << static_cast<double>(sorted.back()) / 1e3 << "\n";
+        }
+
+        out << std::setprecision(3) << total << " commands in " << wallSeconds << " s";
+        if (wallSeconds > 0) {
+            out << std::setprecision(0) << " (" << static_cast<double>(total) / wallSeconds << " commands/s)";
+        }
+        if (errors) out << ", " << errors << " malformed lines";
+        out << "\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,167 @@
+#include "CategoryRegistry.h"
+#include "Post.h"
+#include "User.h"
+#include "RenderBuffer.h"
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+CategoryRegistry::CategoryRegistry() {
+    Post::addObserver(this);
+}
+
+CategoryRegistry::~CategoryRegistry() {
+    Post::removeObserver(this);
+}
+
+std::string CategoryRegistry::normalize(std::string_view name) {
+    std::size_t first = name.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return std::string();
+    std::size_t last = name.find_last_not_of(" \t");
+
+    std::string key(name.substr(first, last - first + 1));
+    for (char& c : key) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+
+int CategoryRegistry::internLocked(std::string_view name) {
+    std::string key = normalize(name);
+    auto it = idsByKey.find(key);
+    if (it != idsByKey.end()) return it->second;
+
+    int id = static_cast<int>(names.size());
+    std::size_t first = name.find_first_not_of(" \t");
+    std::size_t last = name.find_last_not_of(" \t");
+    names.emplace_back(first == std::string_view::npos ? std::string_view()
+                                                       : name.substr(first, last - first + 1));
+    postsByCategory.emplace_back();
+    idsByKey.emplace(std::move(key), id);
+    return id;
+}
+
+int CategoryRegistry::findLocked(std::string_view name) const {
+    auto it = idsByKey.find(normalize(name));
+    return it != idsByKey.end() ? it->second : -1;
+}
+
+void CategoryRegistry::removeLocked(int postId, time_t createdAt) {
+    auto it = categoryOfPost.find(postId);
+    if (it == categoryOfPost.end()) return;
+
+    postsByCategory[it->second].erase(PostKey{createdAt, postId});
+    categoryOfPost.erase(it);
+}
+
+int CategoryRegistry::intern(std::string_view name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return internLocked(name);
+}
+
+int CategoryRegistry::findCategory(std::string_view name) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return findLocked(name);
+}
+
+std::string CategoryRegistry::getCategoryName(int categoryId) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (categoryId < 0 || categoryId >= static_cast<int>(names.size())) return std::string();
+    return names[categoryId];
+}
+
+void CategoryRegistry::addPost(Post* post) {
+    if (!post || post->isDeletedPost()) return;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    removeLocked(post->getPostId(), post->getCreationTime());
+
+    int id = internLocked(post->getCategoryView());
+    postsByCategory[id].emplace(PostKey{post->getCreationTime(), post->getPostId()}, post);
+    categoryOfPost[post->getPostId()] = id;
+}
+
+std::vector<CategorySummary> CategoryRegistry::listCategories() const {
+    std::vector<CategorySummary> result;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (std::size_t id = 0; id < names.size(); ++id) {
+            if (!postsByCategory[id].empty()) {
+                result.push_back({static_cast<int>(id), names[id], postsByCategory[id].size()});
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const CategorySummary& a, const CategorySummary& b) { return a.name < b.name; });
+    return result;
+}
+
+FeedPage CategoryRegistry::getCategoryPage(std::string_view name, std::size_t pageSize,
+                                           const FeedCursor& cursor) const {
+    FeedPage page;
+    if (pageSize == 0) return page;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    int id = findLocked(name);
+    if (id < 0) return page;
+
+    const PostList& list = postsByCategory[id];
+    auto it = cursor.fromNewest ? list.begin()
+                                : list.upper_bound(PostKey{cursor.createdAt, cursor.postId});
+
+    for (; it != list.end() && page.posts.size() < pageSize; ++it) {
+        page.posts.push_back(it->second);
+    }
+
+    if (!page.posts.empty()) {
+        const Post* last = page.posts.back();
+        page.next.createdAt = last->getCreationTime();
+        page.next.postId = last->getPostId();
+        page.next.fromNewest = false;
+    }
+    page.hasMore = (it != list.end());
+    return page;
+}
+
+void CategoryRegistry::showCategories() const {
+    std::vector<CategorySummary> categories = listCategories();
+    if (categories.empty()) {
+        std::cout << "No categories yet. Create a post first!\n";
+        return;
+    }
+
+    RenderBuffer out;
+    out << "\nCategories:\n";
+    out.repeat('-', 40) << '\n';
+    for (const CategorySummary& c : categories) {
+        out << "  ";
+        out.left(c.name, 25) << c.postCount << (c.postCount == 1 ? " post" : " posts") << '\n';
+    }
+    out.repeat('-', 40) << '\n';
+}
+
+// ─────────────── PostObserver ───────────────
+
+void CategoryRegistry::onPostDeleted(const Post& post) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    removeLocked(post.getPostId(), post.getCreationTime());
+}
+
+void CategoryRegistry::onCategoryChanged(const Post& post, const std::string& /*oldCategory*/) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = categoryOfPost.find(post.getPostId());
+    if (it == categoryOfPost.end()) return;     // not registered yet
+
+    PostKey key{post.getCreationTime(), post.getPostId()};
+    PostList& from = postsByCategory[it->second];
+    auto node = from.find(key);
+    if (node == from.end()) return;
+
+    Post* stored = node->second;
+    from.erase(node);
+
+    int id = internLocked(post.getCategoryView());
+    postsByCategory[id].emplace(key, stored);
+    it->second = id;
+}
@@ -0,0 +1,90 @@
+#ifndef CATEGORY_REGISTRY_H
+#define CATEGORY_REGISTRY_H
+
+#include "FeedService.h"
+#include "PostObserver.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <ctime>
+#include <cstddef>
+
+class Post;
+
+struct CategorySummary {
+    int categoryId;
+    std::string name;
+    std::size_t postCount;
+};
+
+// Interned post categories with a time-ordered post list per category.
+// Names are matched case-insensitively and ignoring surrounding spaces;
+// the first spelling seen is the one displayed. Lists are kept current
+// through the PostObserver hooks for deletion and category changes, so a
+// category page costs O(log n + pageSize).
+class CategoryRegistry : public PostObserver {
+private:
+    struct PostKey {
+        time_t createdAt;
+        int postId;
+    };
+
+    struct NewestFirst {
+        bool operator()(const PostKey& a, const PostKey& b) const {
+            if (a.createdAt != b.createdAt) return a.createdAt > b.createdAt;
+            return a.postId > b.postId;
+        }
+    };
+
+    using PostList = std::map<PostKey, Post*, NewestFirst>;
+
+    std::vector<std::string> names;                   // category ID -> display name
+    std::unordered_map<std::string, int> idsByKey;    // normalized name -> category ID
+    std::vector<PostList> postsByCategory;            // category ID -> posts, newest first
+    std::unordered_map<int, int> categoryOfPost;      // post ID -> category ID
+
+    // Hooks can arrive from whichever thread deletes or recategorizes a post
+    mutable std::mutex registryMutex;
+
+    static std::string normalize(std::string_view name);
+
+    // Callers hold registryMutex
+    int internLocked(std::string_view name);
+    int findLocked(std::string_view name) const;
+    void removeLocked(int postId, time_t createdAt);
+
+public:
+    CategoryRegistry();
+    ~CategoryRegistry() override;
+
+    CategoryRegistry(const CategoryRegistry&) = delete;
+    CategoryRegistry& operator=(const CategoryRegistry&) = delete;
+
+    // Returns the category's ID, creating it on first use
+    int intern(std::string_view name);
+
+    // -1 if no post has ever used the category
+    int findCategory(std::string_view name) const;
+    std::string getCategoryName(int categoryId) const;
+
+    // Call once a post has been created; deleted posts are ignored
+    void addPost(Post* post);
+
+    // Categories that currently hold posts, by name
+    std::vector<CategorySummary> listCategories() const;
+
+    // Newest-first page of a category's posts starting after cursor
+    FeedPage getCategoryPage(std::string_view name, std::size_t pageSize,
+                             const FeedCursor& cursor = FeedCursor()) const;
+
+    void showCategories() const;
+
+    // PostObserver
+    void onPostDeleted(const Post& post) override;
+    void onCategoryChanged(const Post& post, const std::string& oldCategory) override;
+};
+
+#endif // CATEGORY_REGISTRY_H
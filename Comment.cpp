@@ -1,9 +1,9 @@
 #include "Comment.h"
 #include "User.h"
 #include "Post.h"
+#include "RenderBuffer.h"
 
 #include <iostream>
-#include <iomanip>
 #include <limits>
 #include <ctime>
 #include <string>
@@ -11,16 +11,18 @@
 using namespace std;
 
 // Static member initialization
-int Comment::nextId = 1;
+atomic<int> Comment::nextId{1};
 
 // Constructor
-Comment::Comment(User* user, Post* postPtr, const string& content, size_t capacity)
+Comment::Comment(User* user, Post* postPtr, const string& content, size_t capacity,
+                 time_t at, int parent)
     : commentId(nextId++),
       author(user),
       post(postPtr),
       maxCapacity(capacity),
+      createdAt(at ? at : time(nullptr)),
       isDeleted(false),
-      createdAt(time(nullptr))
+      parentId(parent)
 {
     if (content.length() <= maxCapacity) {
         text = content;
@@ -31,7 +33,7 @@ Comment::Comment(User* user, Post* postPtr, const string& content, size_t capaci
 }
 
 // Interactive creation
-Comment* Comment::createComment(User* user, Post* postPtr, size_t capacity) {
+Comment* Comment::createComment(User* user, Post* postPtr, size_t capacity, int parent) {
     if (!user || !postPtr) {
         cout << "Error: Invalid user or post.\n";
         return nullptr;
@@ -39,7 +41,7 @@ Comment* Comment::createComment(User* user, Post* postPtr, size_t capacity) {
 
     string content;
 
-    cout << "\n--- Add Comment ---\n";
+    cout << (parent ? "\n--- Reply to Comment ---\n" : "\n--- Add Comment ---\n");
     cout << "Enter comment (max " << capacity << " characters):\n";
 
     // Clear leftover newline from menu choice
@@ -60,8 +62,11 @@ Comment* Comment::createComment(User* user, Post* postPtr, size_t capacity) {
         content = content.substr(0, capacity);
     }
 
-    Comment* newComment = new Comment(user, postPtr, content, capacity);
-    postPtr->addComment(newComment);
+    Comment* newComment = postPtr->addComment(user, content, capacity, 0, parent);
+    if (!newComment) {
+        cout << "Cannot comment on this post.\n";
+        return nullptr;
+    }
     cout << "Comment added successfully! (ID: " << newComment->getCommentId() << ")\n";
 
     return newComment;
@@ -96,22 +101,23 @@ void Comment::deleteComment() {
 
 // Display comment
 void Comment::viewComment() const {
+    RenderBuffer out;
+    viewComment(out);
+}
+
+void Comment::viewComment(RenderBuffer& out) const {
     if (isDeleted) {
-        cout << "[Deleted comment]\n";
+        out << "[Deleted comment]\n";
         return;
     }
 
     if (!author) {
-        cout << "Unknown user: " << text << "\n";
+        out << "Unknown user: " << text << '\n';
         return;
     }
 
-    tm* timeinfo = localtime(&createdAt);
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-
-    cout << left << setw(15) << author->getUsername() << ": "
-         << text << "  (" << buffer << ")\n";
+    out.left(author->getUsernameView(), 15) << ": " << text << "  (";
+    out.timestamp(createdAt) << ")\n";
 }
 
 // Getters
@@ -119,8 +125,11 @@ int     Comment::getCommentId()     const { return commentId; }
 User*   Comment::getAuthor()        const { return author; }
 Post*   Comment::getPost()          const { return post; }
 string  Comment::getText()          const { return text; }
+string_view Comment::getTextView()  const { return text; }
 time_t  Comment::getCreationTime()  const { return createdAt; }
 bool    Comment::isDeletedComment() const { return isDeleted; }
 size_t  Comment::getMaxCapacity()   const { return maxCapacity; }
+int     Comment::getParentId()      const { return parentId; }
+bool    Comment::isReply()          const { return parentId != 0; }
 
 
@@ -2,17 +2,20 @@
 #define COMMENT_H
 
 #include <string>
+#include <string_view>
 #include <ctime>
 #include <iostream>
+#include <atomic>
 
 using namespace std;
 
 class User; // forward declaration
 class Post; // forward declaration
+class RenderBuffer;
 
 class Comment {
 private:
-    static int nextId;   // static variable for auto-increment
+    static atomic<int> nextId;   // static variable for auto-increment (thread-safe)
     int commentId;       // unique comment ID
     User* author;        // pointer to author
     Post* post;          // pointer to the post this comment belongs to
@@ -20,13 +23,15 @@ private:
     const size_t maxCapacity; // max allowed characters
     time_t createdAt;    // timestamp
     bool isDeleted;      // deleted flag
+    int parentId;        // comment this replies to, 0 for top-level
 
 public:
-    // Constructor
-    Comment(User* user, Post* postPtr, const string& content, size_t capacity = 200);
+    // Constructor (at == 0 means now)
+    Comment(User* user, Post* postPtr, const string& content, size_t capacity = 200,
+            time_t at = 0, int parent = 0);
 
-    //Interactive creation
-    static Comment* createComment(User* user, Post* postPtr, size_t capacity = 200);
+    //Interactive creation; parent != 0 creates a reply to that comment
+    static Comment* createComment(User* user, Post* postPtr, size_t capacity = 200, int parent = 0);
 
     // Lifecycle
     void editComment(const string& newText);
@@ -34,15 +39,19 @@ public:
 
     // Display
     void viewComment() const;
+    void viewComment(RenderBuffer& out) const;
 
     // Getters
     int getCommentId() const;
     User* getAuthor() const;
     Post* getPost() const;
     string getText() const;
+    string_view getTextView() const;     // non-owning; invalidated by edits
     time_t getCreationTime() const;
     bool isDeletedComment() const;
     size_t getMaxCapacity() const;
+    int getParentId() const;
+    bool isReply() const;
 };
 
 #endif
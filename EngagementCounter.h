@@ -0,0 +1,84 @@
+#ifndef ENGAGEMENT_COUNTER_H
+#define ENGAGEMENT_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+
+// Thread-safe counter for likes/shares on a post. Updates go to a single
+// atomic until the counter has seen VIRAL_THRESHOLD updates; after that
+// each thread adds into its own cache-line-sized shard so writers on a hot
+// post stop bouncing one line between cores. Reads sum base + shards.
+class EngagementCounter {
+public:
+    static constexpr std::size_t SHARDS = 16;
+    static constexpr long long VIRAL_THRESHOLD = 4096;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<long long> value{0};
+    };
+
+    std::atomic<long long> base{0};
+    std::atomic<long long> updates{0};
+    std::atomic<Shard*> shards{nullptr};
+
+    static std::size_t threadShard() {
+        static std::atomic<std::size_t> nextThread{0};
+        thread_local std::size_t slot = nextThread.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return slot;
+    }
+
+    void promote() {
+        Shard* fresh = new Shard[SHARDS];
+        Shard* expected = nullptr;
+        if (!shards.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+            delete[] fresh;   // another thread promoted first
+        }
+    }
+
+public:
+    EngagementCounter() = default;
+    ~EngagementCounter() { delete[] shards.load(std::memory_order_relaxed); }
+
+    EngagementCounter(const EngagementCounter&) = delete;
+    EngagementCounter& operator=(const EngagementCounter&) = delete;
+
+    void add(long long delta) {
+        Shard* s = shards.load(std::memory_order_acquire);
+        if (s) {
+            s[threadShard()].value.fetch_add(delta, std::memory_order_relaxed);
+            return;
+        }
+        base.fetch_add(delta, std::memory_order_relaxed);
+        if (updates.fetch_add(1, std::memory_order_relaxed) + 1 == VIRAL_THRESHOLD) {
+            promote();
+        }
+    }
+
+    void increment() { add(1); }
+    void decrement() { add(-1); }
+
+    long long get() const {
+        long long total = base.load(std::memory_order_relaxed);
+        if (Shard* s = shards.load(std::memory_order_acquire)) {
+            for (std::size_t i = 0; i < SHARDS; ++i) {
+                total += s[i].value.load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    // Only meaningful when no other thread is updating
+    void reset() {
+        base.store(0, std::memory_order_relaxed);
+        if (Shard* s = shards.load(std::memory_order_acquire)) {
+            for (std::size_t i = 0; i < SHARDS; ++i) {
+                s[i].value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool isSharded() const { return shards.load(std::memory_order_acquire) != nullptr; }
+};
+
+#endif // ENGAGEMENT_COUNTER_H
@@ -0,0 +1,173 @@
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Deferred freeing for data that readers use without a lock.
+//
+//   {
+//       EpochGuard guard;
+//       Engagement* e = engagement.load(std::memory_order_acquire);
+//       ... read e ...
+//   }
+//
+// A reader pins the current epoch for as long as it holds pointers into
+// shared data. A writer that has unlinked something retires it instead of
+// deleting it: retire() stamps it with the epoch and advances the epoch,
+// and it is freed once no thread is still pinned at or before that stamp.
+// Nothing is ever waited for; with no reader pinned, retire() frees at once.
+//
+// Every thread pins through its own slot, taken on first use and handed
+// back when the thread exits. Slots are never freed, so collect() can walk
+// them while threads come and go. Guards nest.
+class EpochReclaimer {
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> pinned{0};    // 0: not reading
+        std::atomic<bool> taken{false};
+        Slot* next = nullptr;
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        std::function<void()> free;
+    };
+
+    // This thread's slot and guard depth
+    struct Local {
+        Slot* slot = nullptr;
+        int depth = 0;
+
+        ~Local() {
+            if (slot) slot->taken.store(false, std::memory_order_release);
+        }
+    };
+
+    std::atomic<std::uint64_t> epoch{1};
+    std::atomic<Slot*> slots{nullptr};
+    std::mutex retiredMutex;
+    std::vector<Retired> retired;
+    std::atomic<std::size_t> retiredCount{0};
+
+    EpochReclaimer() = default;
+
+    ~EpochReclaimer() {
+        // Static destruction: no reader is left
+        for (Retired& r : retired) r.free();
+        for (Slot* s = slots.load(); s;) {
+            Slot* next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    Slot* acquireSlot() {
+        for (Slot* s = slots.load(std::memory_order_acquire); s; s = s->next) {
+            bool expected = false;
+            if (s->taken.compare_exchange_strong(expected, true)) return s;
+        }
+        Slot* fresh = new Slot();
+        fresh->taken.store(true, std::memory_order_relaxed);
+        Slot* head = slots.load(std::memory_order_relaxed);
+        do {
+            fresh->next = head;
+        } while (!slots.compare_exchange_weak(head, fresh, std::memory_order_release, std::memory_order_relaxed));
+        return fresh;
+    }
+
+    static Local& local() {
+        thread_local Local mine;
+        return mine;
+    }
+
+    // Frees what every pinned reader has moved past
+    void collect() {
+        std::uint64_t oldestPinned = std::numeric_limits<std::uint64_t>::max();
+        for (Slot* s = slots.load(std::memory_order_acquire); s; s = s->next) {
+            std::uint64_t p = s->pinned.load();
+            if (p != 0 && p < oldestPinned) oldestPinned = p;
+        }
+
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            auto keep = retired.begin();
+            for (auto it = retired.begin(); it != retired.end(); ++it) {
+                if (it->epoch < oldestPinned) {
+                    ready.push_back(std::move(*it));
+                } else {
+                    *keep++ = std::move(*it);
+                }
+            }
+            retired.erase(keep, retired.end());
+            retiredCount.store(retired.size(), std::memory_order_relaxed);
+        }
+        for (Retired& r : ready) r.free();
+    }
+
+public:
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    static EpochReclaimer& instance() {
+        static EpochReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    void pin() {
+        Local& l = local();
+        if (l.depth++ > 0) return;
+        if (!l.slot) l.slot = acquireSlot();
+
+        // Re-read after publishing: a retire() that missed this slot has
+        // advanced the epoch, and then the pin moves past it
+        std::uint64_t e = epoch.load();
+        while (true) {
+            l.slot->pinned.store(e);
+            std::uint64_t now = epoch.load();
+            if (now == e) break;
+            e = now;
+        }
+    }
+
+    void unpin() {
+        Local& l = local();
+        if (--l.depth > 0) return;
+        l.slot->pinned.store(0, std::memory_order_release);
+        if (retiredCount.load(std::memory_order_relaxed) != 0) collect();
+    }
+
+    // obj must already be unreachable for readers that pin from now on
+    template <typename T>
+    void retire(T* obj) {
+        if (!obj) return;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            retired.push_back(Retired{epoch.fetch_add(1), [obj] { delete obj; }});
+            retiredCount.store(retired.size(), std::memory_order_relaxed);
+        }
+        collect();
+    }
+
+    // Retired objects not yet freed
+    std::size_t pending() const { return retiredCount.load(std::memory_order_relaxed); }
+};
+
+// Pins the current epoch for the enclosing scope
+class EpochGuard {
+public:
+    EpochGuard() { EpochReclaimer::instance().pin(); }
+    ~EpochGuard() { EpochReclaimer::instance().unpin(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+#endif // EPOCH_RECLAIMER_H
@@ -0,0 +1,418 @@
+#include "FeedService.h"
+#include "Post.h"
+#include "User.h"
+#include "RenderBuffer.h"
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <string>
+
+// ─────────────── TimelineBuffer ───────────────
+
+TimelineBuffer::TimelineBuffer(std::size_t capacity) : ring(capacity) {}
+
+void TimelineBuffer::push(const FeedEntry& entry) {
+    if (ring.empty()) return;
+
+    if (count < ring.size()) {
+        ring[(head + count) % ring.size()] = entry;
+        ++count;
+    } else {
+        ring[head] = entry;                 // overwrite the oldest
+        head = (head + 1) % ring.size();
+        dropped = true;
+    }
+}
+
+std::size_t TimelineBuffer::size() const {
+    return count;
+}
+
+std::size_t TimelineBuffer::capacity() const {
+    return ring.size();
+}
+
+// A full ring may also have been filled by a backfill that left older posts out
+bool TimelineBuffer::hasDropped() const {
+    return dropped || (count == ring.size() && count > 0);
+}
+
+const FeedEntry& TimelineBuffer::newest(std::size_t i) const {
+    return ring[(head + count - 1 - i) % ring.size()];
+}
+
+void TimelineBuffer::mergeIn(const std::vector<FeedEntry>& entries) {
+    if (ring.empty() || entries.empty()) return;
+
+    std::vector<FeedEntry> all;
+    all.reserve(count + entries.size());
+    for (std::size_t i = count; i-- > 0; ) {
+        all.push_back(newest(i));
+    }
+    all.insert(all.end(), entries.begin(), entries.end());
+
+    std::sort(all.begin(), all.end(), [](const FeedEntry& a, const FeedEntry& b) {
+        if (a.createdAt != b.createdAt) return a.createdAt < b.createdAt;
+        return a.postId < b.postId;
+    });
+    all.erase(std::unique(all.begin(), all.end(), [](const FeedEntry& a, const FeedEntry& b) {
+        return a.postId == b.postId;
+    }), all.end());
+
+    std::size_t keep = std::min(all.size(), ring.size());
+    std::copy(all.end() - keep, all.end(), ring.begin());
+    head = 0;
+    count = keep;
+    if (keep < all.size()) dropped = true;
+}
+
+// ─────────────── Merge sources ───────────────
+
+namespace {
+
+// Feeds are ordered by (creation time, post ID), newest first
+bool keyBefore(time_t t1, int id1, time_t t2, int id2) {
+    return t1 != t2 ? t1 < t2 : id1 < id2;
+}
+
+bool olderThanCursor(time_t t, int id, const FeedCursor& cursor) {
+    return cursor.fromNewest || keyBefore(t, id, cursor.createdAt, cursor.postId);
+}
+
+// Newest-first walk over either one author's posts (stored oldest first,
+// as User::addPost appends them) or a precomputed timeline
+class MergeSource {
+private:
+    const std::vector<Post*>* posts = nullptr;
+    std::size_t remaining = 0;             // posts[remaining - 1] is current
+
+    const TimelineBuffer* timeline = nullptr;
+    const FeedService* feed = nullptr;
+    std::size_t index = 0;                 // timeline->newest(index) is current
+
+    Post* head = nullptr;
+
+    void settle() {
+        head = nullptr;
+        if (posts) {
+            while (remaining > 0) {
+                Post* p = (*posts)[remaining - 1];
+                if (p && !p->isDeletedPost()) { head = p; return; }
+                --remaining;
+            }
+        } else if (timeline) {
+            while (index < timeline->size()) {
+                Post* p = feed->findPost(timeline->newest(index).postId);
+                if (p && !p->isDeletedPost()) { head = p; return; }
+                ++index;
+            }
+        }
+    }
+
+public:
+    MergeSource(const std::vector<Post*>& authorPosts, const FeedCursor& cursor)
+        : posts(&authorPosts) {
+        auto it = std::lower_bound(authorPosts.begin(), authorPosts.end(), cursor,
+            [](const Post* p, const FeedCursor& c) {
+                return olderThanCursor(p->getCreationTime(), p->getPostId(), c);
+            });
+        remaining = static_cast<std::size_t>(it - authorPosts.begin());
+        settle();
+    }
+
+    MergeSource(const TimelineBuffer& buffer, const FeedService& owner, const FeedCursor& cursor)
+        : timeline(&buffer), feed(&owner) {
+        // newest(i) gets older as i grows; find the first entry past the cursor
+        std::size_t lo = 0, hi = buffer.size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            const FeedEntry& e = buffer.newest(mid);
+            if (olderThanCursor(e.createdAt, e.postId, cursor)) hi = mid;
+            else lo = mid + 1;
+        }
+        index = lo;
+        settle();
+    }
+
+    Post* current() const { return head; }
+
+    void advance() {
+        if (posts) --remaining;
+        else ++index;
+        settle();
+    }
+
+    // A timeline that has dropped older entries may run out before the
+    // feed has ended
+    bool mayHaveDropped() const {
+        return timeline && timeline->hasDropped();
+    }
+};
+
+FeedPage mergeSources(std::vector<MergeSource>& sources, std::size_t pageSize,
+                      const FeedCursor& cursor) {
+    auto newerHead = [&sources](std::size_t a, std::size_t b) {
+        const Post* pa = sources[a].current();
+        const Post* pb = sources[b].current();
+        return keyBefore(pa->getCreationTime(), pa->getPostId(),
+                         pb->getCreationTime(), pb->getPostId());
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(newerHead)> heap(newerHead);
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i].current()) heap.push(i);
+    }
+
+    FeedPage page;
+    page.next = cursor;
+    bool truncated = false;
+
+    while (!heap.empty() && page.posts.size() < pageSize) {
+        std::size_t i = heap.top();
+        heap.pop();
+
+        Post* p = sources[i].current();
+        // The same post can come from a timeline and from a pulled author
+        if (page.posts.empty() || page.posts.back() != p) {
+            page.posts.push_back(p);
+        }
+
+        sources[i].advance();
+        if (sources[i].current()) {
+            heap.push(i);
+        } else if (sources[i].mayHaveDropped()) {
+            truncated = true;
+            break;
+        }
+    }
+
+    if (!page.posts.empty()) {
+        const Post* last = page.posts.back();
+        page.next.createdAt = last->getCreationTime();
+        page.next.postId = last->getPostId();
+        page.next.fromNewest = false;
+    }
+    page.hasMore = truncated || !heap.empty();
+    return page;
+}
+
+} // namespace
+
+// ─────────────── FeedService ───────────────
+
+FeedService::FeedService(AuthenticationService& auth,
+                         std::size_t timelineCap, std::size_t fanoutLim)
+    : authService(auth),
+      timelineCapacity(timelineCap), fanoutLimit(fanoutLim) {}
+
+TimelineBuffer& FeedService::timelineOf(int userId) {
+    auto it = timelines.find(userId);
+    if (it == timelines.end()) {
+        it = timelines.emplace(userId, TimelineBuffer(timelineCapacity)).first;
+    }
+    return it->second;
+}
+
+void FeedService::pushTo(int userId, const FeedEntry& entry) {
+    timelineOf(userId).push(entry);
+}
+
+void FeedService::publishPost(Post* post) {
+    if (!post || !post->getAuthor()) return;
+
+    postsById[post->getPostId()] = post;
+
+    User* author = post->getAuthor();
+    FeedEntry entry{post->getPostId(), post->getCreationTime()};
+
+    // Authors always see their own posts
+    pushTo(author->getUserId(), entry);
+
+    const std::vector<int>& friendIds = author->getFriendIds();
+    if (friendIds.size() > fanoutLimit) {
+        // Too many timelines to write; readers pull from this author
+        pullAuthors.insert(author->getUserId());
+        return;
+    }
+
+    for (int fid : friendIds) {
+        pushTo(fid, entry);
+    }
+}
+
+void FeedService::addSource(const FeedSource* source) {
+    if (source && sources.insert(source).second) ++sourceGeneration;
+}
+
+void FeedService::removeSource(const FeedSource* source) {
+    sources.erase(source);
+}
+
+void FeedService::indexPost(Post* post) {
+    if (post) postsById[post->getPostId()] = post;
+}
+
+void FeedService::fanOut(Post* post, const int* userIds, std::size_t count) {
+    if (!post) return;
+
+    postsById[post->getPostId()] = post;
+    FeedEntry entry{post->getPostId(), post->getCreationTime()};
+    for (std::size_t i = 0; i < count; ++i) {
+        pushTo(userIds[i], entry);
+    }
+}
+
+void FeedService::backfillFollower(int userId, const FeedSource* source) {
+    if (!source || source->isPulled()) return;      // pulled at read time anyway
+
+    std::vector<FeedEntry> entries;
+    for (Post* p : source->postsBefore(FeedCursor(), timelineCapacity)) {
+        if (p && !p->isDeletedPost()) {
+            postsById[p->getPostId()] = p;
+            entries.push_back({p->getPostId(), p->getCreationTime()});
+        }
+    }
+    timelineOf(userId).mergeIn(entries);
+}
+
+void FeedService::catchUpSources(int userId) {
+    std::size_t& seen = readerGeneration[userId];
+    if (seen == sourceGeneration) return;
+    seen = sourceGeneration;
+
+    for (const FeedSource* source : sources) {
+        if (source->isFollowedBy(userId)) backfillFollower(userId, source);
+    }
+}
+
+void FeedService::removeFollower(int userId, const FeedSource* source) {
+    auto tl = timelines.find(userId);
+    if (!source || tl == timelines.end()) return;
+
+    tl->second.removeIf([source](const FeedEntry& e) { return source->hasPost(e); });
+}
+
+void FeedService::backfillFriendship(int userId1, int userId2) {
+    auto recentPostsOf = [this](int userId) {
+        std::vector<FeedEntry> entries;
+        const User* u = authService.findUserById(userId);
+        if (!u || pullAuthors.count(userId)) return entries;   // pulled anyway
+
+        const std::vector<Post*>& posts = u->getPosts();
+        for (auto it = posts.rbegin(); it != posts.rend() && entries.size() < timelineCapacity; ++it) {
+            if (*it && !(*it)->isDeletedPost()) {
+                postsById[(*it)->getPostId()] = *it;
+                entries.push_back({(*it)->getPostId(), (*it)->getCreationTime()});
+            }
+        }
+        return entries;
+    };
+
+    timelineOf(userId1).mergeIn(recentPostsOf(userId2));
+    timelineOf(userId2).mergeIn(recentPostsOf(userId1));
+}
+
+Post* FeedService::findPost(int postId) const {
+    auto it = postsById.find(postId);
+    return it == postsById.end() ? nullptr : it->second;
+}
+
+FeedPage FeedService::getFeedPage(int userId, std::size_t pageSize,
+                                  const FeedCursor& cursor) {
+    const User* reader = authService.findUserById(userId);
+    if (!reader || pageSize == 0) return FeedPage();
+
+    catchUpSources(userId);
+
+    auto tl = timelines.find(userId);
+    if (tl != timelines.end()) {
+        const TimelineBuffer& buffer = tl->second;
+        if (buffer.hasDropped()) {
+            if (buffer.size() == 0) {
+                return pullFeedPage(userId, pageSize, cursor);
+            }
+            const FeedEntry& oldest = buffer.newest(buffer.size() - 1);
+            if (!cursor.fromNewest &&
+                !keyBefore(oldest.createdAt, oldest.postId, cursor.createdAt, cursor.postId)) {
+                // Paged past what the timeline retains
+                return pullFeedPage(userId, pageSize, cursor);
+            }
+        }
+    }
+
+    // Pulled sources hand back just enough posts for this page; keep them
+    // alive for the merge
+    std::vector<std::vector<Post*>> pulled;
+    pulled.reserve(sources.size());
+    for (const FeedSource* source : sources) {
+        if (source->isPulled() && source->isFollowedBy(userId)) {
+            pulled.push_back(source->postsBefore(cursor, pageSize + 1));
+        }
+    }
+
+    std::vector<MergeSource> merge;
+    if (tl != timelines.end()) {
+        merge.emplace_back(tl->second, *this, cursor);
+    }
+    // Pulled friends: walk whichever side of the intersection is smaller,
+    // so a read costs neither every pulled author nor every friend
+    auto pullFrom = [&](int authorId) {
+        const User* author = authService.findUserById(authorId);
+        if (author) merge.emplace_back(author->getPosts(), cursor);
+    };
+    const std::vector<int>& friendIds = reader->getFriendIds();
+    if (friendIds.size() <= pullAuthors.size()) {
+        for (int fid : friendIds) {
+            if (fid != userId && pullAuthors.count(fid)) pullFrom(fid);
+        }
+    } else {
+        for (int authorId : pullAuthors) {
+            if (authorId != userId && reader->hasFriend(authorId)) pullFrom(authorId);
+        }
+    }
+    for (const std::vector<Post*>& posts : pulled) {
+        merge.emplace_back(posts, cursor);
+    }
+
+    return mergeSources(merge, pageSize, cursor);
+}
+
+FeedPage FeedService::pullFeedPage(int userId, std::size_t pageSize,
+                                   const FeedCursor& cursor) const {
+    const User* reader = authService.findUserById(userId);
+    if (!reader || pageSize == 0) return FeedPage();
+
+    std::vector<std::vector<Post*>> followed;
+    followed.reserve(sources.size());
+    for (const FeedSource* source : sources) {
+        if (source->isFollowedBy(userId)) {
+            followed.push_back(source->postsBefore(cursor, pageSize + 1));
+        }
+    }
+
+    std::vector<MergeSource> merge;
+    merge.reserve(reader->getFriendIds().size() + 1 + followed.size());
+    merge.emplace_back(reader->getPosts(), cursor);
+    for (int fid : reader->getFriendIds()) {
+        const User* f = authService.findUserById(fid);
+        if (f) merge.emplace_back(f->getPosts(), cursor);
+    }
+    for (const std::vector<Post*>& posts : followed) {
+        merge.emplace_back(posts, cursor);
+    }
+
+    return mergeSources(merge, pageSize, cursor);
+}
+
+void FeedService::showFeedPage(const FeedPage& page) const {
+    if (page.posts.empty()) {
+        std::cout << "Nothing to show yet. Post something or add some friends!\n";
+        return;
+    }
+
+    RenderBuffer out;
+    for (const Post* p : page.posts) {
+        out << "@" << p->getAuthor()->getUsernameView() << ":\n";
+        p->viewPost(out);
+        out.repeat('-', 50) << '\n';
+    }
+}
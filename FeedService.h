@@ -0,0 +1,162 @@
+#ifndef FEED_SERVICE_H
+#define FEED_SERVICE_H
+
+#include "AuthenticationService.h"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <ctime>
+#include <cstddef>
+
+class Post;
+
+// Compact reference to a post in someone's timeline
+struct FeedEntry {
+    int postId;
+    time_t createdAt;
+};
+
+// Position in a feed: the page after it holds posts strictly older than
+// (createdAt, postId). A default-constructed cursor starts at the newest.
+struct FeedCursor {
+    time_t createdAt = 0;
+    int postId = 0;
+    bool fromNewest = true;
+};
+
+struct FeedPage {
+    std::vector<Post*> posts;     // newest first
+    FeedCursor next;
+    bool hasMore = false;
+};
+
+// A followed source of posts other than friends, such as a Page. Small
+// sources push their posts into follower timelines with
+// FeedService::fanOut; a source with too many followers to push to
+// reports isPulled() and is merged into its followers' feeds at read time.
+class FeedSource {
+public:
+    virtual ~FeedSource() = default;
+
+    virtual bool isFollowedBy(int userId) const = 0;
+    virtual bool isPulled() const = 0;
+
+    // Up to `limit` of the newest posts strictly older than cursor, oldest first
+    virtual std::vector<Post*> postsBefore(const FeedCursor& cursor, std::size_t limit) const = 0;
+
+    // Whether a timeline entry is one of this source's posts
+    virtual bool hasPost(const FeedEntry& entry) const = 0;
+};
+
+// Fixed-capacity ring of feed entries, oldest entries are overwritten
+class TimelineBuffer {
+private:
+    std::vector<FeedEntry> ring;
+    std::size_t head = 0;    // index of the oldest entry
+    std::size_t count = 0;
+    bool dropped = false;    // older entries were overwritten, cut off or removed
+
+public:
+    explicit TimelineBuffer(std::size_t capacity = 0);
+
+    void push(const FeedEntry& entry);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+    // Whether the feed may go on past the oldest entry held
+    bool hasDropped() const;
+
+    // 0 = newest
+    const FeedEntry& newest(std::size_t i) const;
+
+    // Merges older entries into their place by time, keeping the newest
+    // `capacity` entries; used for backfill, not on the publish path
+    void mergeIn(const std::vector<FeedEntry>& entries);
+
+    // Removes the entries pred matches, keeping the rest in order
+    template <typename Pred>
+    void removeIf(Pred pred) {
+        if (hasDropped()) dropped = true;     // still true once there is room
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const FeedEntry& e = ring[(head + i) % ring.size()];
+            if (!pred(e)) ring[(head + kept++) % ring.size()] = e;
+        }
+        count = kept;
+    }
+};
+
+// Precomputed news feeds (fan-out-on-write). Publishing a post pushes a
+// FeedEntry into the timeline of the author and of each friend, so reading
+// a feed only touches one page of entries. Authors with more friends than
+// fanoutLimit are not pushed; their posts are pulled at read time instead.
+class FeedService {
+private:
+    AuthenticationService& authService;
+
+    std::size_t timelineCapacity;
+    std::size_t fanoutLimit;
+
+    std::unordered_map<int, TimelineBuffer> timelines;   // userId -> timeline
+    std::unordered_map<int, Post*> postsById;
+    std::unordered_set<int> pullAuthors;                  // over fanoutLimit
+    std::unordered_set<const FeedSource*> sources;        // pages and the like (not owned)
+
+    // Sources are copied into their followers' timelines on each
+    // follower's next feed read, not when they are added, so starting up
+    // does not backfill every follower of every page. sourceGeneration
+    // counts additions; readerGeneration is how far each reader has caught up.
+    std::size_t sourceGeneration = 0;
+    std::unordered_map<int, std::size_t> readerGeneration;
+
+    void pushTo(int userId, const FeedEntry& entry);
+    TimelineBuffer& timelineOf(int userId);
+    void catchUpSources(int userId);
+
+public:
+    explicit FeedService(AuthenticationService& auth,
+                         std::size_t timelineCap = 500, std::size_t fanoutLim = 1000);
+
+    // Call once a post has been added to its author
+    void publishPost(Post* post);
+
+    // Registers a non-friend source so its posts reach its followers'
+    // feeds, from their next read on; the source must outlive the registration
+    void addSource(const FeedSource* source);
+    void removeSource(const FeedSource* source);
+
+    // Makes a post findable by ID without pushing it anywhere
+    void indexPost(Post* post);
+
+    // Pushes a source's post into `count` follower timelines; sources call
+    // this once per batch of followers
+    void fanOut(Post* post, const int* userIds, std::size_t count);
+
+    // Copies a source's recent posts into a new follower's timeline
+    void backfillFollower(int userId, const FeedSource* source);
+
+    // Takes a source's posts back out of an ex-follower's timeline
+    void removeFollower(int userId, const FeedSource* source);
+
+    // Copies each user's recent posts into the other's timeline so a new
+    // friendship shows up in the feed without waiting for new posts
+    void backfillFriendship(int userId1, int userId2);
+
+    Post* findPost(int postId) const;
+
+    // Feed page from the precomputed timeline plus pulled authors. Pages
+    // past what the timeline still retains are served by pullFeedPage.
+    FeedPage getFeedPage(int userId, std::size_t pageSize,
+                         const FeedCursor& cursor = FeedCursor());
+
+    // Pull model: heap-based k-way merge of the user's, each friend's and
+    // each followed source's posts by creation time. Only about
+    // pageSize + k posts are examined.
+    FeedPage pullFeedPage(int userId, std::size_t pageSize,
+                          const FeedCursor& cursor = FeedCursor()) const;
+
+    void showFeedPage(const FeedPage& page) const;
+};
+
+#endif // FEED_SERVICE_H
@@ -0,0 +1,289 @@
+#ifndef FLAT_STRING_INDEX_H
+#define FLAT_STRING_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FLAT_STRING_INDEX_SSE2 1
+#endif
+
+// Open-addressing map from string to a 32-bit value, for indexes whose
+// keys already live elsewhere (usernames in the UserDirectory records).
+// The table does not store keys: a slot is 8 bytes, the upper half of the
+// key's hash and the value, and KeyAt(value) gives the key back when a
+// candidate needs comparing. Each slot also has a control byte holding 7
+// more hash bits, and lookups compare 16 control bytes at once (one SSE2
+// compare), so a probe rarely touches a slot that is not the match.
+//
+// Growing is incremental, so no single insert pays for rehashing the
+// whole index or for allocating or freeing a big block. Tables are made
+// of chunks of CHUNK_SLOTS slots. When the table passes 3/4 full, a table
+// twice the size is started and each following insert adds one cleared
+// chunk to it, still inserting into the old table. Once the new table is
+// complete it takes over, and each insert moves MIGRATE_SLOTS slots of the
+// old one across (lookups check both tables meanwhile). The old table's
+// chunks are then freed one per insert.
+//
+// Insert-only: accounts are never removed, so there is no erase.
+template <typename KeyAt, typename Hash = std::hash<std::string_view>>
+class FlatStringIndex {
+public:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+    static constexpr std::size_t GROUP = 16;
+    static constexpr std::size_t MIN_CAPACITY = 2 * GROUP;
+    static constexpr std::size_t CHUNK_SLOTS = 16384;
+    static constexpr std::size_t MIGRATE_SLOTS = 2 * GROUP;
+
+private:
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint8_t FULL = 0x80;    // full control byte: FULL | 7 hash bits
+
+    struct Slot {
+        std::uint32_t hash;      // upper 32 bits of the key's hash
+        std::uint32_t value;
+    };
+
+    struct FreeDeleter {
+        void operator()(void* p) const { std::free(p); }
+    };
+
+    // A chunk's control bytes, then its slots
+    using Chunk = std::unique_ptr<std::uint8_t[], FreeDeleter>;
+
+    struct Table {
+        std::vector<Chunk> chunks;
+        std::size_t capacity = 0;       // power of two, multiple of GROUP
+        std::size_t chunkSlots = 0;
+        unsigned chunkShift = 0;
+        std::size_t used = 0;
+
+        Table() = default;
+
+        // Chunks are added by addChunk()
+        explicit Table(std::size_t cap)
+            : capacity(cap), chunkSlots(cap < CHUNK_SLOTS ? cap : CHUNK_SLOTS) {
+            while ((std::size_t(1) << chunkShift) < chunkSlots) ++chunkShift;
+            chunks.reserve(capacity / chunkSlots);
+        }
+
+        bool complete() const { return capacity && chunks.size() == capacity / chunkSlots; }
+
+        void addChunk() {
+            Chunk chunk(static_cast<std::uint8_t*>(std::malloc(chunkSlots * (1 + sizeof(Slot)))));
+            if (!chunk) throw std::bad_alloc();
+            std::memset(chunk.get(), EMPTY, chunkSlots);
+            chunks.push_back(std::move(chunk));
+        }
+
+        // A group never straddles two chunks
+        std::uint8_t* ctrl(std::size_t i) const {
+            return chunks[i >> chunkShift].get() + (i & (chunkSlots - 1));
+        }
+        Slot* slot(std::size_t i) const {
+            return reinterpret_cast<Slot*>(chunks[i >> chunkShift].get() + chunkSlots) + (i & (chunkSlots - 1));
+        }
+
+        std::size_t groupMask() const { return capacity / GROUP - 1; }
+        bool wantsToGrow() const { return (used + 1) * 4 > capacity * 3; }
+        bool full() const { return (used + 1) * 8 > capacity * 7; }
+    };
+
+    Table current;
+    Table next;                 // being built; empty otherwise
+    Table old;                  // being moved into current; empty otherwise
+    std::size_t migrated = 0;   // slots of old already moved
+    std::vector<Chunk> retired; // old chunks still to free
+    std::size_t retiredSlots = 0;   // slots per retired chunk
+    std::size_t count = 0;
+
+    KeyAt keyAt;
+    Hash hasher;
+
+    // Bit i set where ctrl[i] == byte, for the GROUP bytes at ctrl
+    static unsigned matchByte(const std::uint8_t* ctrl, std::uint8_t byte) {
+#ifdef FLAT_STRING_INDEX_SSE2
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(byte)));
+        return static_cast<unsigned>(_mm_movemask_epi8(match));
+#else
+        unsigned mask = 0;
+        for (std::size_t i = 0; i < GROUP; ++i) {
+            mask |= static_cast<unsigned>(ctrl[i] == byte) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static unsigned lowestBit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+        unsigned i = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    static std::uint8_t tagOf(std::size_t hash) { return static_cast<std::uint8_t>(FULL | (hash & 0x7F)); }
+    static std::uint32_t upperOf(std::size_t hash) {
+        return static_cast<std::uint32_t>(static_cast<std::uint64_t>(hash) >> 32);
+    }
+
+    std::uint32_t findIn(const Table& t, std::string_view key, std::uint8_t tag, std::uint32_t upper) const {
+        const std::size_t mask = t.groupMask();
+        std::size_t group = upper & mask;
+        for (std::size_t step = 1;; group = (group + step++) & mask) {
+            const std::uint8_t* ctrl = t.ctrl(group * GROUP);
+            const Slot* slots = t.slot(group * GROUP);
+            for (unsigned m = matchByte(ctrl, tag); m; m &= m - 1) {
+                const Slot& slot = slots[lowestBit(m)];
+                if (slot.hash == upper && keyAt(slot.value) == key) return slot.value;
+            }
+            if (matchByte(ctrl, EMPTY)) return NONE;
+        }
+    }
+
+    // Triangular probing over a power-of-two group count visits every
+    // group, and the table is never full, so this always finds a slot
+    static void place(Table& t, std::uint8_t tag, std::uint32_t upper, std::uint32_t value) {
+        const std::size_t mask = t.groupMask();
+        std::size_t group = upper & mask;
+        for (std::size_t step = 1;; group = (group + step++) & mask) {
+            std::uint8_t* ctrl = t.ctrl(group * GROUP);
+            unsigned empty = matchByte(ctrl, EMPTY);
+            if (empty) {
+                unsigned i = lowestBit(empty);
+                ctrl[i] = tag;
+                t.slot(group * GROUP)[i] = Slot{upper, value};
+                ++t.used;
+                return;
+            }
+        }
+    }
+
+    void build(std::size_t chunks) {
+        for (; chunks && !next.complete(); --chunks) next.addChunk();
+        if (next.complete()) {
+            old = std::move(current);
+            current = std::move(next);
+            next = Table();
+            migrated = 0;
+        }
+    }
+
+    void migrate(std::size_t slots) {
+        std::size_t end = migrated + slots < old.capacity ? migrated + slots : old.capacity;
+        for (; migrated < end; ++migrated) {
+            std::uint8_t tag = *old.ctrl(migrated);
+            if (tag != EMPTY) {
+                const Slot& slot = *old.slot(migrated);
+                place(current, tag, slot.hash, slot.value);
+            }
+        }
+        if (migrated == old.capacity) {
+            for (Chunk& chunk : old.chunks) retired.push_back(std::move(chunk));
+            retiredSlots = old.chunkSlots;
+            old = Table();
+            migrated = 0;
+        }
+    }
+
+    // One insert's share of the growing work
+    void growStep() {
+        if (!retired.empty()) retired.pop_back();
+
+        if (old.capacity) {
+            migrate(MIGRATE_SLOTS);
+        } else if (next.capacity) {
+            build(1);
+        } else if (current.wantsToGrow()) {
+            next = Table(current.capacity * 2);
+            build(1);
+        }
+
+        // Only reached if inserts outran the growing; finish in one go
+        if (current.full()) {
+            if (next.capacity) build(next.capacity);
+            if (old.capacity) migrate(old.capacity);
+        }
+    }
+
+    static std::size_t capacityFor(std::size_t entries) {
+        std::size_t cap = MIN_CAPACITY;
+        while (entries * 4 > cap * 3) cap *= 2;
+        return cap;
+    }
+
+    static Table completeTable(std::size_t cap) {
+        Table t(cap);
+        while (!t.complete()) t.addChunk();
+        return t;
+    }
+
+public:
+    explicit FlatStringIndex(KeyAt keys, Hash hash = Hash())
+        : current(completeTable(MIN_CAPACITY)), keyAt(std::move(keys)), hasher(std::move(hash)) {}
+
+    FlatStringIndex(const FlatStringIndex&) = delete;
+    FlatStringIndex& operator=(const FlatStringIndex&) = delete;
+
+    // Value for key, or NONE
+    std::uint32_t find(std::string_view key) const {
+        std::size_t hash = hasher(key);
+        std::uint8_t tag = tagOf(hash);
+        std::uint32_t upper = upperOf(hash);
+        std::uint32_t value = findIn(current, key, tag, upper);
+        if (value == NONE && old.capacity) value = findIn(old, key, tag, upper);
+        return value;
+    }
+
+    bool contains(std::string_view key) const { return find(key) != NONE; }
+
+    // keyAt(value) must return key from now on. False if key is present.
+    bool insert(std::string_view key, std::uint32_t value) {
+        std::size_t hash = hasher(key);
+        std::uint8_t tag = tagOf(hash);
+        std::uint32_t upper = upperOf(hash);
+        if (findIn(current, key, tag, upper) != NONE) return false;
+        if (old.capacity && findIn(old, key, tag, upper) != NONE) return false;
+
+        growStep();
+        place(current, tag, upper, value);
+        ++count;
+        return true;
+    }
+
+    // Sizes the table for `entries` in one step; for bulk loads into an
+    // empty index
+    void reserve(std::size_t entries) {
+        if (count == 0 && capacityFor(entries) > current.capacity) {
+            current = completeTable(capacityFor(entries));
+            next = Table();
+        }
+    }
+
+    std::size_t size() const { return count; }
+
+    // Slots allocated, including a table being built or moved from
+    std::size_t capacity() const {
+        return current.capacity + next.chunks.size() * next.chunkSlots + old.capacity +
+               retired.size() * retiredSlots;
+    }
+
+    bool isGrowing() const { return next.capacity || old.capacity || !retired.empty(); }
+};
+
+#endif // FLAT_STRING_INDEX_H
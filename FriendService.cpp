@@ -1,4 +1,6 @@
 #include "FriendService.h"
+#include "RenderBuffer.h"
+#include "LatencyTrace.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -51,6 +53,7 @@ void FriendService::saveFriendRequests() const {
 }
 
 void FriendService::saveFriends() const {
+    TRACE_SCOPE("FriendService::saveFriends");
     std::ofstream file(FRIENDS_FILE);
     if (!file.is_open()) return;
 
@@ -102,6 +105,7 @@ bool FriendService::sendFriendRequest(int senderId, const std::string& targetUse
     auto it = std::find(incoming.begin(), incoming.end(), senderId);
     if (it != incoming.end()) {
         incoming.erase(it);
+        ++graphVersion;
         sender->addFriend(targetId);
         target->addFriend(senderId);
         saveFriends();
@@ -111,12 +115,14 @@ bool FriendService::sendFriendRequest(int senderId, const std::string& targetUse
     }
 
     sent.push_back(targetId);
+    ++graphVersion;
     saveFriendRequests();
     std::cout << "Friend request sent to " << targetUsername << ".\n";
     return true;
 }
 
 bool FriendService::acceptFriendRequest(int receiverId, int senderId) {
+    TRACE_SCOPE("FriendService::acceptFriendRequest");
     auto& sentBySender = pendingRequests[senderId];
     auto it = std::find(sentBySender.begin(), sentBySender.end(), receiverId);
     if (it == sentBySender.end()) {
@@ -125,6 +131,7 @@ bool FriendService::acceptFriendRequest(int receiverId, int senderId) {
     }
 
     sentBySender.erase(it);
+    ++graphVersion;
 
     User* receiver = authService.findUserById(receiverId);
     User* sender   = authService.findUserById(senderId);
@@ -150,28 +157,30 @@ bool FriendService::rejectFriendRequest(int receiverId, int senderId) {
     }
 
     sentBySender.erase(it);
+    ++graphVersion;
     saveFriendRequests();
     std::cout << "Friend request rejected.\n";
     return true;
 }
 
 void FriendService::showPendingRequestsForUser(int userId) const {
-    std::cout << "\nPending friend requests for you:\n";
+    RenderBuffer out;
+    out << "\nPending friend requests for you:\n";
     bool hasAny = false;
 
     for (const auto& [senderId, receivers] : pendingRequests) {
         if (std::find(receivers.begin(), receivers.end(), userId) != receivers.end()) {
             User* sender = authService.findUserById(senderId);
             if (sender) {
-                std::cout << "  - From: " << sender->getUsername()
-                          << " (ID: " << senderId << ")\n";
+                out << "  - From: " << sender->getUsernameView()
+                    << " (ID: " << senderId << ")\n";
                 hasAny = true;
             }
         }
     }
 
     if (!hasAny) {
-        std::cout << "  No pending requests.\n";
+        out << "  No pending requests.\n";
     }
 }
 
@@ -185,4 +194,17 @@ std::vector<int> FriendService::getFriendIdsOf(int userId) const {
     User* u = authService.findUserById(userId);
     if (!u) return {};
     return u->getFriendIds();
+}
+
+bool FriendService::hasPendingRequestBetween(int userId1, int userId2) const {
+    auto sentBy = [this](int from, int to) {
+        auto it = pendingRequests.find(from);
+        if (it == pendingRequests.end()) return false;
+        return std::find(it->second.begin(), it->second.end(), to) != it->second.end();
+    };
+    return sentBy(userId1, userId2) || sentBy(userId2, userId1);
+}
+
+unsigned long FriendService::getGraphVersion() const {
+    return graphVersion;
 }
\ No newline at end of file
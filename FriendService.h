@@ -14,6 +14,10 @@ private:
     // Pending requests: senderId → list of receiverIds who have pending request from him
     std::map<int, std::vector<int>> pendingRequests;
 
+    // Bumped on every change to friendships or pending requests so that
+    // derived data (e.g. friend suggestions) can detect staleness
+    unsigned long graphVersion = 0;
+
     static const std::string REQUESTS_FILE;
     static const std::string FRIENDS_FILE;
 
@@ -36,6 +40,11 @@ public:
     bool areFriends(int userId1, int userId2) const;
 
     std::vector<int> getFriendIdsOf(int userId) const;   // changed to return IDs (safer)
+
+    // True if either user has a pending request to the other
+    bool hasPendingRequestBetween(int userId1, int userId2) const;
+
+    unsigned long getGraphVersion() const;
 };
 
 #endif // FRIEND_SERVICE_H
\ No newline at end of file
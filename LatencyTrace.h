@@ -0,0 +1,278 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped latency timers for the hot paths.
+//
+//   void FriendService::saveFriends() const {
+//       TRACE_SCOPE("FriendService::saveFriends");
+//       ...
+//
+// Each TRACE_SCOPE times its enclosing block into a histogram for that
+// name. Histograms are per thread and written only by their own thread,
+// with plain relaxed loads and stores, so recording takes no lock and no
+// read-modify-write; report() merges the threads' histograms when asked.
+//
+// Buckets are HDR-style: exact below 32 ns, then 32 sub-buckets per power
+// of two, so any recorded value is within about 3% of its true value.
+//
+// Timers are compiled in only when SOCIAL_TRACING is defined (the CMake
+// option of the same name); otherwise TRACE_SCOPE expands to nothing and
+// the report says tracing is off.
+class LatencyTrace {
+public:
+    static constexpr std::size_t MAX_SITES = 64;
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BITS;
+    static constexpr std::size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    // Percentiles of one operation, in nanoseconds
+    struct Summary {
+        std::string name;
+        std::uint64_t count = 0;
+        double mean = 0;
+        std::uint64_t p50 = 0;
+        std::uint64_t p90 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t max = 0;
+    };
+
+private:
+    struct Histogram {
+        std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> max{0};
+
+        // Single writer: the owning thread
+        static void bump(std::atomic<std::uint64_t>& a, std::uint64_t by) {
+            a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        }
+
+        void record(std::uint64_t ns) {
+            bump(counts[bucketOf(ns)], 1);
+            bump(count, 1);
+            bump(sum, ns);
+            if (ns > max.load(std::memory_order_relaxed)) max.store(ns, std::memory_order_relaxed);
+        }
+    };
+
+    // One thread's histograms, allocated per site on first use
+    struct ThreadHistograms {
+        std::array<std::atomic<Histogram*>, MAX_SITES> sites{};
+
+        ~ThreadHistograms() {
+            for (auto& site : sites) delete site.load(std::memory_order_relaxed);
+        }
+
+        Histogram& at(int site) {
+            Histogram* h = sites[static_cast<std::size_t>(site)].load(std::memory_order_relaxed);
+            if (!h) {
+                h = new Histogram();
+                sites[static_cast<std::size_t>(site)].store(h, std::memory_order_release);
+            }
+            return *h;
+        }
+    };
+
+    // Owns every thread's histograms (they outlive their threads, so a
+    // report still covers finished workers) and the site names
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadHistograms>> threads;
+        std::vector<std::string> names;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    static ThreadHistograms& local() {
+        thread_local ThreadHistograms* mine = nullptr;
+        if (!mine) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.threads.push_back(std::make_unique<ThreadHistograms>());
+            mine = r.threads.back().get();
+        }
+        return *mine;
+    }
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<std::size_t>(ns);
+        unsigned exponent = 63;
+        while (!(ns >> exponent)) --exponent;      // highest set bit, >= SUB_BITS
+        unsigned shift = exponent - SUB_BITS;
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + ((ns >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    // Largest value that lands in bucket
+    static std::uint64_t bucketLimit(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS) - 1;
+        std::uint64_t sub = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    }
+
+public:
+    // Times one block; use through TRACE_SCOPE
+    class Scope {
+    private:
+        int site;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Scope(int siteId) : site(siteId), start(std::chrono::steady_clock::now()) {}
+
+        ~Scope() {
+            if (site < 0) return;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            local().at(site).record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static constexpr bool enabled() {
+#ifdef SOCIAL_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // ID for an operation name; called once per TRACE_SCOPE. Returns -1
+    // (recording nothing) once MAX_SITES names are taken.
+    static int site(const std::string& name) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t i = 0; i < r.names.size(); ++i) {
+            if (r.names[i] == name) return static_cast<int>(i);
+        }
+        if (r.names.size() == MAX_SITES) return -1;
+        r.names.push_back(name);
+        return static_cast<int>(r.names.size() - 1);
+    }
+
+    // All threads merged, one entry per operation that has been timed
+    static std::vector<Summary> summaries() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        std::vector<Summary> result;
+        std::vector<std::uint64_t> merged(BUCKETS);
+        for (std::size_t s = 0; s < r.names.size(); ++s) {
+            std::fill(merged.begin(), merged.end(), 0);
+            Summary summary;
+            summary.name = r.names[s];
+            std::uint64_t sum = 0;
+
+            for (const auto& thread : r.threads) {
+                const Histogram* h = thread->sites[s].load(std::memory_order_acquire);
+                if (!h) continue;
+                for (std::size_t b = 0; b < BUCKETS; ++b) {
+                    merged[b] += h->counts[b].load(std::memory_order_relaxed);
+                }
+                summary.count += h->count.load(std::memory_order_relaxed);
+                sum += h->sum.load(std::memory_order_relaxed);
+                std::uint64_t max = h->max.load(std::memory_order_relaxed);
+                if (max > summary.max) summary.max = max;
+            }
+            if (summary.count == 0) continue;
+
+            // Bucket counts and the total are read at slightly different
+            // moments, so percentiles rank against the bucket total
+            std::uint64_t total = 0;
+            for (std::uint64_t c : merged) total += c;
+            if (total == 0) continue;
+            auto percentile = [&](double p) {
+                std::uint64_t rank = static_cast<std::uint64_t>(p * static_cast<double>(total - 1)) + 1;
+                std::uint64_t seen = 0;
+                for (std::size_t b = 0; b < BUCKETS; ++b) {
+                    seen += merged[b];
+                    if (seen >= rank) return std::min(bucketLimit(b), summary.max);
+                }
+                return summary.max;
+            };
+            summary.mean = static_cast<double>(sum) / static_cast<double>(summary.count);
+            summary.p50 = percentile(0.50);
+            summary.p90 = percentile(0.90);
+            summary.p99 = percentile(0.99);
+            result.push_back(summary);
+        }
+        return result;
+    }
+
+    // Table of count and mean/p50/p90/p99/max in microseconds
+    static void report(std::ostream& out) {
+        if (!enabled()) {
+            out << "Latency tracing is off in this build (configure with -DSOCIAL_TRACING=ON).\n";
+            return;
+        }
+
+        std::vector<Summary> rows = summaries();
+        if (rows.empty()) {
+            out << "No traced operations yet.\n";
+            return;
+        }
+
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        out << std::left << std::setw(40) << "operation" << std::right
+            << std::setw(9) << "calls" << std::setw(11) << "mean us" << std::setw(11) << "p50 us"
+            << std::setw(11) << "p90 us" << std::setw(11) << "p99 us" << std::setw(11) << "max us" << "\n";
+        out << std::fixed << std::setprecision(1);
+        for (const Summary& s : rows) {
+            out << std::left << std::setw(40) << s.name << std::right
+                << std::setw(9) << s.count
+                << std::setw(11) << s.mean / 1e3
+                << std::setw(11) << static_cast<double>(s.p50) / 1e3
+                << std::setw(11) << static_cast<double>(s.p90) / 1e3
+                << std::setw(11) << static_cast<double>(s.p99) / 1e3
+                << std::setw(11) << static_cast<double>(s.max) / 1e3 << "\n";
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    // Writes report() to path; false if the file cannot be opened
+    static bool dump(const std::string& path) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cout << "Error: Could not open " << path << " for writing!\n";
+            return false;
+        }
+        report(file);
+        return true;
+    }
+};
+
+#ifdef SOCIAL_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name)                                                              \
+    static const int TRACE_CONCAT(traceSite_, __LINE__) = LatencyTrace::site(name);    \
+    LatencyTrace::Scope TRACE_CONCAT(traceScope_, __LINE__)(TRACE_CONCAT(traceSite_, __LINE__))
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // LATENCY_TRACE_H
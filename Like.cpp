@@ -1,32 +1,31 @@
 #include "Like.h"
 #include "User.h"
 #include "Post.h"
+#include "RenderBuffer.h"
 
 #include <iostream>
 using namespace std;
 
 // Initialize static member
-int Like::nextId = 1;
+atomic<int> Like::nextId{1};
 
 // Constructor
-Like::Like(User* userPtr, Post* postPtr)
-    : likeId(nextId++), user(userPtr), post(postPtr), createdAt(time(nullptr)) {}
+Like::Like(User* userPtr, Post* postPtr, time_t at)
+    : likeId(nextId++), user(userPtr), post(postPtr), createdAt(at ? at : time(nullptr)) {}
 
 // Factory-style creation with double-like prevention
 Like* Like::createLike(User* userPtr, Post* postPtr) {
-    // Check if this user already liked the post
-    for (Like* l : postPtr->getLikes()) {
-        if (l->getUser() == userPtr) {
-            cout << userPtr->getUsername() << " has already liked post "
+    // The check and the insert happen together under the post's lock, so
+    // two threads liking for the same user cannot both succeed
+    Like* newLike = postPtr->addLike(userPtr);
+    if (!newLike) {
+        if (postPtr->hasLiked(userPtr->getUserId())) {
+            cout << userPtr->getUsernameView() << " has already liked post "
                  << postPtr->getPostId() << endl;
-            return nullptr;  // Do not create a new like
         }
+        return nullptr;  // Do not create a new like
     }
-
-    // If not liked yet, create and attach
-    Like* newLike = new Like(userPtr, postPtr);
-    postPtr->addLike(newLike);
-    cout << userPtr->getUsername() << " liked post " << postPtr->getPostId()
+    cout << userPtr->getUsernameView() << " liked post " << postPtr->getPostId()
          << " (Like ID: " << newLike->getLikeId() << ")" << endl;
     return newLike;
 }
@@ -39,12 +38,13 @@ time_t Like::getTime() const { return createdAt; }
 
 // Display
 void Like::viewLike() const {
-    tm* timeinfo = localtime(&createdAt);
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
+    RenderBuffer out;
+    viewLike(out);
+}
 
-    cout << user->getUsername() << " liked this post at " << buffer
-         << " (Like ID: " << likeId << ")" << endl;
+void Like::viewLike(RenderBuffer& out) const {
+    out << user->getUsernameView() << " liked this post at ";
+    out.timestamp(createdAt) << " (Like ID: " << likeId << ")\n";
 }
 
 
@@ -3,23 +3,25 @@
 
 #include <ctime>
 #include <iostream>
+#include <atomic>
 
 using namespace std;
 
 class User; // forward declaration
 class Post; // forward declaration
+class RenderBuffer;
 
 class Like {
 private:
-    static int nextId;   // auto-increment ID
+    static atomic<int> nextId;   // auto-increment ID (shared by worker threads)
     int likeId;          // unique like ID
     User* user;          // who liked
     Post* post;          // post that was liked
     time_t createdAt;    // timestamp
 
 public:
-    // Constructor
-    Like(User* userPtr, Post* postPtr);
+    // Constructor (at == 0 means now)
+    Like(User* userPtr, Post* postPtr, time_t at = 0);
 
     // Factory-style creation
     static Like* createLike(User* userPtr, Post* postPtr);
@@ -32,6 +34,7 @@ public:
 
     // Display
     void viewLike() const;
+    void viewLike(RenderBuffer& out) const;
 };
 
 #endif
@@ -0,0 +1,156 @@
+#include "PageAnalytics.h"
+#include <algorithm>
+
+void EngagementCounts::add(const EngagementCounts& other) {
+    follows   += other.follows;
+    unfollows += other.unfollows;
+    likes     += other.likes;
+    comments  += other.comments;
+    shares    += other.shares;
+}
+
+// ─────────────── Series ───────────────
+
+EngagementCounts& PageAnalytics::Series::bucketFor(time_t at, long long netDelta) {
+    long long b = static_cast<long long>(at) / width;
+
+    if (buckets.empty()) {
+        firstBucket = b;
+        buckets.emplace_back();
+        netFollowers.push_back(0);
+    }
+    while (b < firstBucket) {
+        // Late event from before the first bucket; nothing happened earlier
+        buckets.emplace_front();
+        netFollowers.push_front(0);
+        --firstBucket;
+    }
+    while (b >= firstBucket + static_cast<long long>(buckets.size())) {
+        long long carried = netFollowers.back();
+        buckets.emplace_back();
+        netFollowers.push_back(carried);
+    }
+
+    std::size_t index = static_cast<std::size_t>(b - firstBucket);
+    if (netDelta != 0) {
+        // Only the newest bucket for in-order events
+        for (std::size_t i = index; i < netFollowers.size(); ++i) {
+            netFollowers[i] += netDelta;
+        }
+    }
+    return buckets[index];
+}
+
+namespace {
+
+long long floorDiv(long long a, long long b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+long long ceilDiv(long long a, long long b) {
+    return -floorDiv(-a, b);
+}
+
+} // namespace
+
+// ─────────────── PageAnalytics ───────────────
+
+PageAnalytics::PageAnalytics() : hourly(HOUR_SECONDS), daily(DAY_SECONDS) {}
+
+void PageAnalytics::bump(EngagementCounts& c, Event e) {
+    switch (e) {
+        case FOLLOW:   ++c.follows;   break;
+        case UNFOLLOW: ++c.unfollows; break;
+        case LIKE:     ++c.likes;     break;
+        case COMMENT:  ++c.comments;  break;
+        case SHARE:    ++c.shares;    break;
+        case UNLIKE:   --c.likes;     break;
+    }
+}
+
+void PageAnalytics::record(Event event, time_t at, int postId) {
+    time_t now = time(nullptr);
+    if (at == 0) at = now;
+
+    long long netDelta = event == FOLLOW ? 1 : event == UNFOLLOW ? -1 : 0;
+    followers += netDelta;
+
+    long long age = static_cast<long long>(now) - static_cast<long long>(at);
+    if (age > HORIZON_SECONDS || age < -HORIZON_SECONDS) return;
+
+    bump(hourly.bucketFor(at, netDelta), event);
+    bump(daily.bucketFor(at, netDelta), event);
+    if (event != FOLLOW && event != UNFOLLOW) {
+        bump(perPost[postId], event);
+    }
+}
+
+const PageAnalytics::Series& PageAnalytics::seriesFor(Granularity g) const {
+    return g == HOURLY ? hourly : daily;
+}
+
+std::vector<AnalyticsBucket> PageAnalytics::query(time_t from, time_t to, Granularity g) const {
+    std::vector<AnalyticsBucket> result;
+    const Series& s = seriesFor(g);
+    if (to <= from || s.buckets.empty()) return result;
+
+    long long b0 = std::max(floorDiv(from, s.width), s.firstBucket);
+    long long b1 = ceilDiv(to, s.width);
+    long long end = s.firstBucket + static_cast<long long>(s.buckets.size());
+    if (b0 >= b1) return result;
+
+    result.reserve(static_cast<std::size_t>(b1 - b0));
+    for (long long b = b0; b < b1; ++b) {
+        AnalyticsBucket bucket;
+        bucket.start = static_cast<time_t>(b * s.width);
+        if (b < end) {
+            std::size_t i = static_cast<std::size_t>(b - s.firstBucket);
+            bucket.counts = s.buckets[i];
+            // The count now, less what changed in the buckets after this one
+            bucket.followersAtEnd = followers - (s.netFollowers.back() - s.netFollowers[i]);
+        } else {
+            bucket.followersAtEnd = followers;
+        }
+        result.push_back(bucket);
+    }
+    return result;
+}
+
+EngagementCounts PageAnalytics::totals(time_t from, time_t to) const {
+    EngagementCounts sum;
+    if (to <= from) return sum;
+
+    auto addRange = [&sum](const Series& s, long long b0, long long b1) {
+        if (s.buckets.empty()) return;
+        long long end = s.firstBucket + static_cast<long long>(s.buckets.size());
+        b0 = std::max(b0, s.firstBucket);
+        b1 = std::min(b1, end);
+        for (long long b = b0; b < b1; ++b) {
+            sum.add(s.buckets[static_cast<std::size_t>(b - s.firstBucket)]);
+        }
+    };
+
+    const long long hoursPerDay = DAY_SECONDS / HOUR_SECONDS;
+    long long h0 = floorDiv(from, HOUR_SECONDS);
+    long long h1 = ceilDiv(to, HOUR_SECONDS);
+    long long d0 = ceilDiv(h0, hoursPerDay);
+    long long d1 = floorDiv(h1, hoursPerDay);
+
+    if (d0 < d1) {
+        addRange(hourly, h0, d0 * hoursPerDay);
+        addRange(daily, d0, d1);
+        addRange(hourly, d1 * hoursPerDay, h1);
+    } else {
+        addRange(hourly, h0, h1);
+    }
+    return sum;
+}
+
+EngagementCounts PageAnalytics::getPostTotals(int postId) const {
+    auto it = perPost.find(postId);
+    return it == perPost.end() ? EngagementCounts() : it->second;
+}
+
+long long PageAnalytics::getFollowerCount() const {
+    return followers;
+}
@@ -0,0 +1,86 @@
+#ifndef PAGE_ANALYTICS_H
+#define PAGE_ANALYTICS_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <ctime>
+#include <cstddef>
+
+// Counts for one time bucket, one post or one range
+struct EngagementCounts {
+    long long follows = 0;
+    long long unfollows = 0;
+    long long likes = 0;
+    long long comments = 0;
+    long long shares = 0;
+
+    void add(const EngagementCounts& other);
+};
+
+struct AnalyticsBucket {
+    time_t start;                  // first second of the bucket (UTC-aligned)
+    EngagementCounts counts;
+    long long followersAtEnd;      // follower count once the bucket closed; follows
+                                   // past the horizon count as already made
+};
+
+// Incremental rollups of a page's follows and post engagement. Every event
+// bumps one hourly and one daily bucket, so queries never scan posts:
+// a range query walks only the buckets it covers. Like counts are net: an
+// unlike takes its like back out of the bucket the like was counted in.
+class PageAnalytics {
+public:
+    enum Event { FOLLOW, UNFOLLOW, LIKE, COMMENT, SHARE, UNLIKE };
+    enum Granularity { HOURLY, DAILY };
+
+    static constexpr long long HOUR_SECONDS = 3600;
+    static constexpr long long DAY_SECONDS = 86400;
+
+    // Events further than this from now are left out of the buckets and
+    // per-post totals, which bounds how far a bogus timestamp can stretch
+    // the series
+    static constexpr long long HORIZON_SECONDS = 2 * 366 * DAY_SECONDS;
+
+private:
+    // Contiguous buckets from firstBucket on; each also carries the net
+    // follower change up to its end, so a bucket's follower count is the
+    // current count less the change after it, with no prefix scan
+    struct Series {
+        long long width;
+        long long firstBucket = 0;
+        std::deque<EngagementCounts> buckets;
+        std::deque<long long> netFollowers;    // cumulative follows - unfollows
+
+        explicit Series(long long w) : width(w) {}
+
+        EngagementCounts& bucketFor(time_t at, long long netDelta);
+    };
+
+    Series hourly;
+    Series daily;
+    std::unordered_map<int, EngagementCounts> perPost;   // post ID -> totals
+    long long followers = 0;
+
+    const Series& seriesFor(Granularity g) const;
+    static void bump(EngagementCounts& c, Event e);
+
+public:
+    PageAnalytics();
+
+    // at == 0 means now; postId is ignored for follows. The follower
+    // count is kept even for events outside the horizon.
+    void record(Event event, time_t at = 0, int postId = 0);
+
+    // Buckets overlapping [from, to), oldest first, in O(buckets)
+    std::vector<AnalyticsBucket> query(time_t from, time_t to, Granularity g) const;
+
+    // Totals over [from, to): whole days from the daily series and the
+    // ragged ends from the hourly one
+    EngagementCounts totals(time_t from, time_t to) const;
+
+    EngagementCounts getPostTotals(int postId) const;
+    long long getFollowerCount() const;
+};
+
+#endif // PAGE_ANALYTICS_H
@@ -2,9 +2,11 @@
 #include "User.h"
 #include "Like.h"
 #include "Comment.h"
+#include "PostObserver.h"
+#include "RenderBuffer.h"
+#include "EpochReclaimer.h"
 
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
 #include <limits>
 #include <ctime>
@@ -12,15 +14,25 @@
 
 using namespace std;
 
+vector<PostObserver*> Post::observers;
+
+namespace {
+
+// Shown for a deleted post's text; the text itself is left alone so
+// lock-free readers never see it change
+const char DELETED_TEXT[] = "[This post has been deleted]";
+
+} // namespace
+
 // Constructor
-Post::Post(int id, User* user, const string& content, size_t capacity, const string& cat)
+Post::Post(int id, User* user, const string& content, size_t capacity, const string& cat, time_t created)
     : postId(id),
       author(user),
       text(),
       maxCapacity(capacity),
       isDeleted(false),
-      shareCount(0),
-      createdAt(time(nullptr)),
+      createdAt(created ? created : time(nullptr)),
+      engagement(new Engagement()),
       category(cat)
 {
     if (content.length() <= maxCapacity) {
@@ -31,6 +43,11 @@ Post::Post(int id, User* user, const string& content, size_t capacity, const str
     }
 }
 
+// The pools release every Like and Comment along with the post
+Post::~Post() {
+    delete engagement.load(memory_order_relaxed);
+}
+
 //Interactive creation
 Post* Post::createPost(int id, User* user, size_t capacity, const string& defaultCat) {
     string content;
@@ -88,6 +105,7 @@ void Post::editPost(const string& newText) {
 
     if (newText.length() <= maxCapacity) {
         text = newText;
+        for (PostObserver* o : observers) o->onPostEdited(*this);
         cout << "Post updated successfully.\n";
     } else {
         cout << "Error: New text exceeds maximum capacity ("
@@ -97,67 +115,136 @@ void Post::editPost(const string& newText) {
 
 // Delete post
 void Post::deletePost() {
-    if (isDeleted) {
-        cout << "Post is already deleted.\n";
-        return;
-    }
+    {
+        lock_guard<mutex> lock(engagementMutex);
+        if (isDeleted.exchange(true)) {
+            cout << "Post is already deleted.\n";
+            return;
+        }
+
+        for (PostObserver* o : observers) o->onPostDeleted(*this);
 
-    isDeleted = true;
-    text = "[This post has been deleted]";
-    likes.clear();
-    comments.clear();
-    shareCount = 0;
+        // Reclaim every like and comment in bulk. Readers may still be
+        // walking the comment lists without the lock, so the storage is
+        // retired rather than freed and goes once they have moved on.
+        EpochReclaimer::instance().retire(engagement.exchange(nullptr, memory_order_acq_rel));
+        likeCount.reset();
+        shareCount.reset();
+    }
 
     cout << "Post #" << postId << " has been deleted.\n";
 }
 
 // View post
 void Post::viewPost() const {
+    RenderBuffer out;
+    viewPost(out);
+}
+
+void Post::viewPost(RenderBuffer& out) const {
     if (isDeleted) {
-        cout << "This post has been deleted.\n";
+        out << "This post has been deleted.\n";
         return;
     }
 
-    cout << left << setw(14) << "Author:"
-         << (author ? author->getUsername() : "Unknown") << "\n"
-         << left << setw(14) << "Category:"   << category << "\n"
-         << left << setw(14) << "Content:"    << text << "\n"
-         << left << setw(14) << "Likes:"      << getLikeCount()
-         << setw(14) << "Comments:" << comments.size()
-         << setw(14) << "Shares:"   << shareCount << "\n";
-
-    tm* timeinfo = localtime(&createdAt);
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-
-    cout << left << setw(14) << "Created:" << buffer << "\n";
+    out.left("Author:", 14) << (author ? author->getUsernameView() : "Unknown") << '\n';
+    out.left("Category:", 14) << category << '\n';
+    out.left("Content:", 14) << text << '\n';
+    out.left("Likes:", 14) << getLikeCount();
+    out.left("Comments:", 14) << getCommentCount();
+    out.left("Shares:", 14) << getShareCount() << '\n';
+    out.left("Created:", 14).timestamp(createdAt) << '\n';
 }
 
 
 // Like management
-void Post::addLike(Like* like) {
-    if (!isDeleted && like != nullptr) {
-        likes.push_back(like);
+Like* Post::addLike(User* user, time_t at) {
+    if (user == nullptr) {
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(engagementMutex);
+    Engagement* e = engagement.load(memory_order_relaxed);
+    if (isDeleted || !e) {
+        return nullptr;
+    }
+
+    auto inserted = e->likeIndex.emplace(user->getUserId(), e->likes.size());
+    if (!inserted.second) {
+        return nullptr;
     }
+
+    Like* like = e->likePool.create(user, this, at);
+    e->likes.push_back(like);
+    likeCount.increment();
+    for (PostObserver* o : observers) o->onLikeAdded(*this, *like);
+    return like;
 }
 
 void Post::removeLike(Like* like) {
-    if (isDeleted || like == nullptr) {
+    if (like == nullptr) {
+        return;
+    }
+
+    // The like belongs to the engagement until it is removed; check that
+    // the post is live before touching it
+    lock_guard<mutex> lock(engagementMutex);
+    Engagement* e = engagement.load(memory_order_relaxed);
+    if (isDeleted || !e || like->getUser() == nullptr) {
         return;
     }
 
-    auto it = find(likes.begin(), likes.end(), like);
-    if (it != likes.end()) {
-        likes.erase(it);
+    auto it = e->likeIndex.find(like->getUser()->getUserId());
+    if (it == e->likeIndex.end() || e->likes[it->second] != like) {
+        return;
     }
+
+    e->likes[it->second] = nullptr;
+    e->likeIndex.erase(it);
+    likeCount.decrement();
+    ++e->removedLikeSlots;
+
+    // Compact once holes make up half the list; keeps removal amortized O(1)
+    if (e->removedLikeSlots > 16 && e->removedLikeSlots * 2 > e->likes.size()) {
+        e->likes.erase(remove(e->likes.begin(), e->likes.end(), nullptr), e->likes.end());
+        for (size_t i = 0; i < e->likes.size(); ++i) {
+            e->likeIndex[e->likes[i]->getUser()->getUserId()] = i;
+        }
+        e->removedLikeSlots = 0;
+    }
+
+    for (PostObserver* o : observers) o->onLikeRemoved(*this, *like);
+    e->likePool.destroy(like);
 }
 
 int Post::getLikeCount() const {
-    return isDeleted ? 0 : static_cast<int>(likes.size());
+    return isDeleted ? 0 : static_cast<int>(likeCount.get());
+}
+
+bool Post::hasLiked(int userId) const {
+    lock_guard<mutex> lock(engagementMutex);
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    return e && e->likeIndex.count(userId) != 0;
+}
+
+Like* Post::findLikeBy(int userId) const {
+    lock_guard<mutex> lock(engagementMutex);
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    if (!e) return nullptr;
+    auto it = e->likeIndex.find(userId);
+    return it == e->likeIndex.end() ? nullptr : e->likes[it->second];
 }
 
-const vector<Like*>& Post::getLikes() const {
-    return likes;
+vector<Like*> Post::getLikes() const {
+    lock_guard<mutex> lock(engagementMutex);
+    vector<Like*> snapshot;
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    if (!e) return snapshot;
+    snapshot.reserve(e->likeIndex.size());
+    for (Like* l : e->likes) {
+        if (l) snapshot.push_back(l);
+    }
+    return snapshot;
 }
 
 void Post::viewLikes() const {
@@ -166,68 +253,220 @@ void Post::viewLikes() const {
         return;
     }
 
-    if (likes.empty()) {
+    EpochGuard guard;    // the likes outlive a concurrent deletePost
+    vector<Like*> current = getLikes();
+    if (current.empty()) {
         cout << "No likes yet.\n";
         return;
     }
 
-    cout << "Likes (" << likes.size() << "):\n";
-    for (const Like* l : likes) {
-        if (l && l->getUser()) {
-            cout << "  - " << l->getUser()->getUsername() << "\n";
+    RenderBuffer out;
+    out << "Likes (" << current.size() << "):\n";
+    for (const Like* l : current) {
+        if (l->getUser()) {
+            out << "  - " << l->getUser()->getUsernameView() << '\n';
         }
     }
 }
 
 // Comment management
-void Post::addComment(Comment* comment) {
-    if (!isDeleted && comment != nullptr) {
-        comments.push_back(comment);
+Comment* Post::addComment(User* user, const string& content, size_t capacity,
+                          time_t at, int parentId) {
+    if (user == nullptr) {
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(engagementMutex);
+    Engagement* e = engagement.load(memory_order_relaxed);
+    if (isDeleted || !e) {
+        return nullptr;
+    }
+    if (parentId != 0 && e->commentIndex.count(parentId) == 0) {
+        return nullptr;   // not a comment on this post
+    }
+
+    Comment* comment = e->commentPool.create(user, this, content, capacity, at, parentId);
+    e->commentIndex[comment->getCommentId()] = e->comments.size();
+    e->comments.push_back(comment);
+    if (parentId == 0) {
+        e->topLevelComments.push_back(comment);
+    } else {
+        e->repliesByParent[parentId].push_back(comment);
+    }
+
+    for (PostObserver* o : observers) o->onCommentAdded(*this, *comment);
+    return comment;
+}
+
+int Post::getCommentIndex(int commentId) const {
+    lock_guard<mutex> lock(engagementMutex);
+    return getCommentIndexLocked(commentId);
+}
+
+int Post::getCommentIndexLocked(int commentId) const {
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    if (!e) return -1;
+    auto it = e->commentIndex.find(commentId);
+    return it == e->commentIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+CommentPage Post::getCommentPage(size_t cursor, size_t pageSize, size_t repliesPerComment) const {
+    CommentPage page;
+    page.nextCursor = cursor;
+    page.hasMore = false;
+
+    lock_guard<mutex> lock(engagementMutex);
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    if (isDeleted || !e) {
+        return page;
+    }
+
+    size_t total = e->topLevelComments.size();
+    size_t end = min(total, cursor + pageSize);
+
+    for (size_t i = cursor; i < end; ++i) {
+        CommentThread thread;
+        thread.comment = e->topLevelComments[i];
+        thread.totalReplies = 0;
+
+        auto it = e->repliesByParent.find(thread.comment->getCommentId());
+        if (it != e->repliesByParent.end()) {
+            const vector<Comment*>& replies = it->second;
+            thread.totalReplies = replies.size();
+            size_t shown = min(replies.size(), repliesPerComment);
+            thread.replies.assign(replies.begin(), replies.begin() + shown);
+        }
+        page.threads.push_back(move(thread));
+    }
+
+    page.nextCursor = max(cursor, end);
+    page.hasMore = end < total;
+    return page;
+}
+
+ReplyPage Post::getReplyPage(int parentCommentId, size_t cursor, size_t pageSize) const {
+    ReplyPage page;
+    page.nextCursor = cursor;
+    page.hasMore = false;
+
+    lock_guard<mutex> lock(engagementMutex);
+    const Engagement* e = engagement.load(memory_order_relaxed);
+    if (isDeleted || !e) {
+        return page;
+    }
+    auto it = e->repliesByParent.find(parentCommentId);
+    if (it == e->repliesByParent.end()) {
+        return page;
+    }
+
+    const vector<Comment*>& replies = it->second;
+    size_t end = min(replies.size(), cursor + pageSize);
+    if (cursor < end) {
+        page.replies.assign(replies.begin() + cursor, replies.begin() + end);
     }
+    page.nextCursor = max(cursor, end);
+    page.hasMore = end < replies.size();
+    return page;
 }
 
 void Post::viewComments() const {
+    viewCommentPage();
+}
+
+size_t Post::viewCommentPage(size_t cursor, size_t pageSize, size_t repliesPerComment) const {
     if (isDeleted) {
         cout << "Cannot view comments  post is deleted.\n";
-        return;
+        return cursor;
     }
 
-    if (comments.empty()) {
+    EpochGuard guard;    // the page's comments outlive a concurrent deletePost
+    int count = getCommentCount();
+    if (count == 0) {
         cout << "No comments yet.\n";
-        return;
+        return cursor;
     }
 
-    cout << "Comments (" << comments.size() << "):\n";
-    for (const Comment* c : comments) {
-        if (c && c->getAuthor()) {
-            cout << "  " << left << setw(15)
-                 << c->getAuthor()->getUsername() << ": "
-                 << c->getText() << "\n";
+    CommentPage page = getCommentPage(cursor, pageSize, repliesPerComment);
+
+    RenderBuffer out;
+    out << "Comments (" << count << "):\n";
+    for (const CommentThread& thread : page.threads) {
+        const Comment* c = thread.comment;
+        if (c->getAuthor()) {
+            out << "  ";
+            out.left(c->getAuthor()->getUsernameView(), 15) << ": " << c->getTextView() << '\n';
+        }
+        for (const Comment* r : thread.replies) {
+            if (r->getAuthor()) {
+                out << "      > ";
+                out.left(r->getAuthor()->getUsernameView(), 15) << ": " << r->getTextView() << '\n';
+            }
         }
+        if (thread.totalReplies > thread.replies.size()) {
+            out << "      ... " << (thread.totalReplies - thread.replies.size())
+                << " more replies\n";
+        }
+    }
+    if (page.hasMore) {
+        out << "  (more comments)\n";
     }
+    return page.nextCursor;
 }
 
-const vector<Comment*>& Post::getComments() const {
-    return comments;
+const AppendOnlyList<Comment*>& Post::getComments() const {
+    static const AppendOnlyList<Comment*> none;
+    const Engagement* e = engagement.load(memory_order_acquire);
+    return e ? e->comments : none;
 }
 
-// Share
+int Post::getCommentCount() const {
+    EpochGuard guard;
+    const Engagement* e = engagement.load(memory_order_acquire);
+    return isDeleted || !e ? 0 : static_cast<int>(e->comments.size());
+}
+
+// Share: lock-free unless someone is watching
 void Post::sharePost() {
-    if (!isDeleted) {
-        ++shareCount;
+    if (isDeleted) {
+        return;
+    }
+
+    shareCount.increment();
+    if (!observers.empty()) {
+        lock_guard<mutex> lock(engagementMutex);
+        for (PostObserver* o : observers) o->onPostShared(*this);
     }
 }
 
 // Getters & setters
 int    Post::getPostId()       const { return postId; }
 User*  Post::getAuthor()       const { return author; }
-string Post::getText()         const { return text; }
-int    Post::getShareCount()   const { return shareCount; }
+string Post::getText()         const { return isDeleted ? string(DELETED_TEXT) : text; }
+int    Post::getShareCount()   const { return isDeleted ? 0 : static_cast<int>(shareCount.get()); }
 size_t Post::getMaxCapacity()  const { return maxCapacity; }
 bool   Post::isDeletedPost()   const { return isDeleted; }
 time_t Post::getCreationTime() const { return createdAt; }
 string Post::getCategory()     const { return category; }
-void   Post::setCategory(const string& cat) { category = cat; }
+
+string_view Post::getTextView()     const { return isDeleted ? string_view(DELETED_TEXT) : string_view(text); }
+string_view Post::getCategoryView() const { return category; }
+
+void Post::setCategory(const string& cat) {
+    if (cat == category) return;
+    string oldCategory = category;
+    category = cat;
+    for (PostObserver* o : observers) o->onCategoryChanged(*this, oldCategory);
+}
+
+void Post::addObserver(PostObserver* observer) {
+    if (observer && find(observers.begin(), observers.end(), observer) == observers.end()) {
+        observers.push_back(observer);
+    }
+}
+
+void Post::removeObserver(PostObserver* observer) {
+    observers.erase(remove(observers.begin(), observers.end(), observer), observers.end());
+}
 
 
 
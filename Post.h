@@ -2,9 +2,17 @@
 #define POST_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 #include <ctime>
 #include <iosfwd>
+#include <atomic>
+#include <mutex>
+
+#include "SlabPool.h"
+#include "AppendOnlyList.h"
+#include "EngagementCounter.h"
 
 using namespace std;
 
@@ -12,6 +20,29 @@ using namespace std;
 class User;
 class Like;
 class Comment;
+class PostObserver;
+class RenderBuffer;
+
+// One top-level comment with the first few of its replies
+struct CommentThread {
+    Comment* comment;
+    vector<Comment*> replies;
+    size_t totalReplies;
+};
+
+// Cursors are positions in append-only lists, so they stay valid while
+// new comments arrive; 0 starts at the oldest comment
+struct CommentPage {
+    vector<CommentThread> threads;
+    size_t nextCursor;
+    bool hasMore;
+};
+
+struct ReplyPage {
+    vector<Comment*> replies;
+    size_t nextCursor;
+    bool hasMore;
+};
 
 class Post {
 private:
@@ -19,17 +50,56 @@ private:
     User* author;
     string text;
     const size_t maxCapacity;
-    bool isDeleted;
+    atomic<bool> isDeleted;
 
     time_t createdAt;
-    vector<Like*> likes;
-    vector<Comment*> comments;
-    int shareCount;
+
+    // Everything this post's likes and comments occupy, so deletePost can
+    // reclaim it in one piece
+    struct Engagement {
+        // Likes in the order they were made. Removed likes leave a nullptr
+        // slot until enough accumulate to compact; likeIndex maps the liking
+        // user's ID to the slot so duplicate checks and removal are O(1).
+        vector<Like*> likes;
+        unordered_map<int, size_t> likeIndex;
+        size_t removedLikeSlots = 0;
+
+        // Readers can walk comments without taking engagementMutex. Every
+        // comment is in `comments` in creation order; top-level ones are also
+        // in topLevelComments and replies are indexed under their parent.
+        AppendOnlyList<Comment*> comments;
+        AppendOnlyList<Comment*> topLevelComments;
+        unordered_map<int, vector<Comment*>> repliesByParent;
+        unordered_map<int, size_t> commentIndex;  // comment ID -> position in comments
+
+        // Storage for the likes and comments above
+        SlabPool<Like> likePool;
+        SlabPool<Comment> commentPool;
+    };
+
+    // Null once the post is deleted: deletePost retires it to the
+    // EpochReclaimer, which frees it after lock-free readers move on
+    atomic<Engagement*> engagement;
+
+    // Read without locking; sharded once a post goes viral
+    EngagementCounter likeCount;
+    EngagementCounter shareCount;
+
+    // Guards the engagement's likes, indexes, pools and comment appends so
+    // several worker threads can engage with the same post
+    mutable mutex engagementMutex;
 
     string category;
+
+    static vector<PostObserver*> observers;
 public:
-    // Constructor
-    Post(int id, User* user, const string& content, size_t capacity = 500, const string& cat = "General");
+    // Constructor (created == 0 means now)
+    Post(int id, User* user, const string& content, size_t capacity = 500,
+         const string& cat = "General", time_t created = 0);
+    ~Post();
+
+    Post(const Post&) = delete;
+    Post& operator=(const Post&) = delete;
 
     // Factory-style creation
     static Post* createPost(int id, User* user, size_t capacity = 500, const string& cat = "General");
@@ -38,21 +108,42 @@ public:
     void editPost(const string& newText);
     void deletePost();
 
-    // View
+    // View. The RenderBuffer overloads append to the caller's buffer so
+    // feeds and timelines can render many posts in one write.
     void viewPost() const;
+    void viewPost(RenderBuffer& out) const;
     void viewLikes() const;
-    void viewComments() const;
+    void viewComments() const;                // first page, threaded
+
+    // Prints one page of threads and returns the cursor for the next one
+    size_t viewCommentPage(size_t cursor = 0, size_t pageSize = 20,
+                           size_t repliesPerComment = 3) const;
 
-    // Like management
-    void addLike(Like* like);
+    // Like management. Likes and comments are owned by the post: pointers
+    // stay valid until they are removed or the post is deleted, and a
+    // thread that may race a deletion must hold an EpochGuard while it uses
+    // them.
+    Like* addLike(User* user, time_t at = 0); // nullptr if that user already liked
     void removeLike(Like* like);
     int getLikeCount() const;
-    const vector<Like*>& getLikes() const;//to prevent double liking
+    bool hasLiked(int userId) const;
+    Like* findLikeBy(int userId) const;
+    vector<Like*> getLikes() const;           // snapshot, in like order
 
 
-    // Comment management
-    void addComment(Comment* comment);
-    const vector<Comment*>& getComments() const;
+    // Comment management. parentId != 0 replies to that comment, which
+    // must belong to this post (nullptr otherwise).
+    Comment* addComment(User* user, const string& content, size_t capacity = 200,
+                        time_t at = 0, int parentId = 0);
+    const AppendOnlyList<Comment*>& getComments() const;   // empty once deleted; use under an EpochGuard
+    int getCommentCount() const;
+    int getCommentIndex(int commentId) const; // position in getComments(), -1 if none
+    int getCommentIndexLocked(int commentId) const; // same, for observer hooks (lock already held)
+
+    // Threaded paging: only the requested top-level comments and at most
+    // repliesPerComment replies each are touched
+    CommentPage getCommentPage(size_t cursor, size_t pageSize, size_t repliesPerComment) const;
+    ReplyPage getReplyPage(int parentCommentId, size_t cursor, size_t pageSize) const;
 
     // Share
     void sharePost();
@@ -66,9 +157,20 @@ public:
     bool isDeletedPost() const;
     time_t getCreationTime() const;
 
+    // Non-owning views of text and category; invalidated by editPost/setCategory.
+    // A deleted post's text reads as a fixed placeholder.
+    string_view getTextView() const;
+    string_view getCategoryView() const;
+
     // Category management
     string getCategory() const;          // getter
     void setCategory(const string& cat); // setter
+
+    // Observers of post edits, deletion and engagement (not owned). Register
+    // before worker threads start; engagement hooks may be called from any
+    // thread, with this post's engagement lock held.
+    static void addObserver(PostObserver* observer);
+    static void removeObserver(PostObserver* observer);
 };
 
 #endif
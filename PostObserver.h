@@ -0,0 +1,25 @@
+#ifndef POST_OBSERVER_H
+#define POST_OBSERVER_H
+
+#include <string>
+
+class Post;
+class Like;
+class Comment;
+
+// Receives post lifecycle and engagement events. Register with
+// Post::addObserver; every hook defaults to doing nothing.
+class PostObserver {
+public:
+    virtual ~PostObserver() = default;
+
+    virtual void onLikeAdded(const Post& /*post*/, const Like& /*like*/) {}
+    virtual void onLikeRemoved(const Post& /*post*/, const Like& /*like*/) {}
+    virtual void onCommentAdded(const Post& /*post*/, const Comment& /*comment*/) {}
+    virtual void onPostShared(const Post& /*post*/) {}
+    virtual void onPostEdited(const Post& /*post*/) {}
+    virtual void onPostDeleted(const Post& /*post*/) {}
+    virtual void onCategoryChanged(const Post& /*post*/, const std::string& /*oldCategory*/) {}
+};
+
+#endif // POST_OBSERVER_H
@@ -0,0 +1,329 @@
+#include "PostStore.h"
+#include "Post.h"
+#include "User.h"
+#include "Like.h"
+#include "Comment.h"
+#include "RecordIO.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <filesystem>
+
+const std::string PostStore::POSTS_FILE = "posts.dat";
+const char PostStore::MAGIC[8] = {'S', 'N', 'P', 'O', 'S', 'T', 'S', '1'};
+
+using namespace recordio;
+
+namespace {
+
+// Post/Like/Comment report to the console as they change; replaying the
+// log goes through the same methods, so mute that output while loading
+class ConsoleMute {
+private:
+    std::streambuf* saved;
+
+public:
+    ConsoleMute() : saved(std::cout.rdbuf(nullptr)) {}
+    ~ConsoleMute() { std::cout.rdbuf(saved); }
+};
+
+} // namespace
+
+// ─────────────── Construction & loading ───────────────
+
+PostStore::PostStore(AuthenticationService& auth, const std::string& file)
+    : path(file), authService(auth) {
+    load();
+
+    log.open(path, std::ios::binary | std::ios::app);
+    if (!log.is_open()) {
+        std::cout << "Error: Could not open " << path << " for writing!\n";
+    } else if (std::filesystem::file_size(path) == 0) {
+        log.write(MAGIC, sizeof(MAGIC));
+        log.flush();
+    }
+
+    Post::addObserver(this);
+}
+
+PostStore::~PostStore() {
+    Post::removeObserver(this);
+}
+
+void PostStore::load() {
+    std::error_code ec;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec || fileSize == 0) return;
+
+    if (fileSize < sizeof(MAGIC)) {
+        std::filesystem::resize_file(path, 0, ec);
+        return;
+    }
+
+    std::size_t validBytes = recordio::visitFile(path, fileSize,
+        [this](const char* data, std::size_t size) { return replay(data, size); });
+    if (validBytes == 0) {
+        std::cout << "Error: Could not read " << path << "\n";
+        return;
+    }
+
+    if (validBytes < fileSize) {
+        // Drop a torn tail so new records are appended after the last good one
+        std::filesystem::resize_file(path, validBytes, ec);
+    }
+}
+
+std::size_t PostStore::replay(const char* data, std::size_t size) {
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cout << "Error: " << path << " is not a post store file; ignoring it.\n";
+        return size;
+    }
+
+    std::unordered_map<int, User*> usersById;
+    for (User& u : authService.getUsers()) {
+        usersById[u.getUserId()] = &u;
+    }
+
+    ConsoleMute mute;
+    replaying = true;
+
+    std::size_t offset = sizeof(MAGIC);
+    while (size - offset >= RECORD_HEADER_SIZE) {
+        std::uint8_t type = static_cast<std::uint8_t>(data[offset]);
+        std::uint32_t length;
+        std::memcpy(&length, data + offset + 1, sizeof(length));
+
+        if (size - offset - RECORD_HEADER_SIZE < length) break;   // torn record
+
+        applyRecord(type, data + offset + RECORD_HEADER_SIZE, length, usersById);
+        offset += RECORD_HEADER_SIZE + length;
+    }
+
+    replaying = false;
+    return offset;
+}
+
+void PostStore::applyRecord(std::uint8_t type, const char* payload, std::size_t length,
+                            const std::unordered_map<int, User*>& usersById) {
+    RecordReader in(payload, length);
+
+    auto userFor = [&usersById](int id) -> User* {
+        auto it = usersById.find(id);
+        return it == usersById.end() ? nullptr : it->second;
+    };
+
+    if (type == REC_POST) {
+        int postId       = in.i32();
+        int authorId     = in.i32();
+        time_t createdAt = static_cast<time_t>(in.i64());
+        int capacity     = in.i32();
+        std::string cat  = in.str();
+        std::string text = in.str();
+        if (!in.good()) return;
+
+        nextPostId = std::max(nextPostId, postId + 1);
+
+        User* author = userFor(authorId);
+        if (!author || postsById.count(postId)) return;
+
+        Post* post = new Post(postId, author, text, static_cast<size_t>(capacity), cat, createdAt);
+        author->addPost(post);
+        posts.push_back(post);
+        postsById[postId] = post;
+        return;
+    }
+
+    int postId = in.i32();
+    Post* post = findPost(postId);
+    if (!post) return;
+
+    switch (type) {
+    case REC_LIKE: {
+        User* user = userFor(in.i32());
+        time_t at = static_cast<time_t>(in.i64());
+        if (in.good() && user) post->addLike(user, at);
+        break;
+    }
+    case REC_UNLIKE: {
+        User* user = userFor(in.i32());
+        if (in.good() && user) post->removeLike(post->findLikeBy(user->getUserId()));
+        break;
+    }
+    case REC_COMMENT:
+    case REC_REPLY: {
+        User* user = userFor(in.i32());
+        time_t at = static_cast<time_t>(in.i64());
+        int capacity = in.i32();
+        int parentId = 0;
+        if (type == REC_REPLY) {
+            std::int32_t parentPos = in.i32();
+            const AppendOnlyList<Comment*>& existing = post->getComments();
+            if (parentPos < 0 || static_cast<std::size_t>(parentPos) >= existing.size()) break;
+            parentId = existing[static_cast<std::size_t>(parentPos)]->getCommentId();
+        }
+        std::string text = in.str();
+        if (!in.good() || !user) break;
+
+        post->addComment(user, text, static_cast<size_t>(capacity), at, parentId);
+        break;
+    }
+    case REC_SHARE:
+        post->sharePost();
+        break;
+    case REC_EDIT: {
+        std::string text = in.str();
+        if (in.good()) post->editPost(text);
+        break;
+    }
+    case REC_DELETE:
+        post->deletePost();
+        break;
+    case REC_CATEGORY: {
+        std::string cat = in.str();
+        if (in.good()) post->setCategory(cat);
+        break;
+    }
+    default:
+        break;   // unknown record from a newer version; skip it
+    }
+}
+
+// ─────────────── Appending ───────────────
+
+// Caller holds storeMutex
+void PostStore::appendRecord(RecordType type, const std::string& payload) {
+    if (!log.is_open()) return;
+
+    recordio::writeRecord(log, type, payload);
+    log.flush();
+}
+
+// Caller holds storeMutex
+bool PostStore::isStored(const Post& post) const {
+    return !replaying && postsById.count(post.getPostId()) != 0;
+}
+
+int PostStore::allocatePostId() {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return nextPostId++;
+}
+
+void PostStore::reservePostIds(int lastUsedId) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    nextPostId = std::max(nextPostId, lastUsedId + 1);
+}
+
+void PostStore::appendPost(Post* post) {
+    if (!post || !post->getAuthor()) return;
+
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (postsById.count(post->getPostId())) return;
+
+    nextPostId = std::max(nextPostId, post->getPostId() + 1);
+    posts.push_back(post);
+    postsById[post->getPostId()] = post;
+
+    std::string payload;
+    putI32(payload, post->getPostId());
+    putI32(payload, post->getAuthor()->getUserId());
+    putI64(payload, static_cast<std::int64_t>(post->getCreationTime()));
+    putI32(payload, static_cast<std::int32_t>(post->getMaxCapacity()));
+    putString(payload, post->getCategoryView());
+    putString(payload, post->getTextView());
+    appendRecord(REC_POST, payload);
+}
+
+Post* PostStore::findPost(int postId) const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    auto it = postsById.find(postId);
+    return it == postsById.end() ? nullptr : it->second;
+}
+
+const std::vector<Post*>& PostStore::getPosts() const {
+    return posts;
+}
+
+// ─────────────── PostObserver ───────────────
+
+void PostStore::onLikeAdded(const Post& post, const Like& like) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post) || !like.getUser()) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, like.getUser()->getUserId());
+    putI64(payload, static_cast<std::int64_t>(like.getTime()));
+    appendRecord(REC_LIKE, payload);
+}
+
+void PostStore::onLikeRemoved(const Post& post, const Like& like) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post) || !like.getUser()) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, like.getUser()->getUserId());
+    appendRecord(REC_UNLIKE, payload);
+}
+
+void PostStore::onCommentAdded(const Post& post, const Comment& comment) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post) || !comment.getAuthor()) return;
+
+    std::string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, comment.getAuthor()->getUserId());
+    putI64(payload, static_cast<std::int64_t>(comment.getCreationTime()));
+    putI32(payload, static_cast<std::int32_t>(comment.getMaxCapacity()));
+
+    if (comment.isReply()) {
+        // Comment IDs are not stable across restarts, so a reply refers to
+        // its parent by position in Post::getComments()
+        int parentPos = post.getCommentIndexLocked(comment.getParentId());
+        if (parentPos < 0) {
+            std::cout << "Error: Parent of comment #" << comment.getCommentId() << " not found on post #"
+                      << post.getPostId() << "; reply not saved.\n";
+            return;
+        }
+        putI32(payload, static_cast<std::int32_t>(parentPos));
+        putString(payload, comment.getTextView());
+        appendRecord(REC_REPLY, payload);
+    } else {
+        putString(payload, comment.getTextView());
+        appendRecord(REC_COMMENT, payload);
+    }
+}
+
+void PostStore::onPostShared(const Post& post) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post)) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    appendRecord(REC_SHARE, payload);
+}
+
+void PostStore::onPostEdited(const Post& post) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post)) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    putString(payload, post.getTextView());
+    appendRecord(REC_EDIT, payload);
+}
+
+void PostStore::onPostDeleted(const Post& post) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post)) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    appendRecord(REC_DELETE, payload);
+}
+
+void PostStore::onCategoryChanged(const Post& post, const std::string& /*oldCategory*/) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!isStored(post)) return;
+    std::string payload;
+    putI32(payload, post.getPostId());
+    putString(payload, post.getCategoryView());
+    appendRecord(REC_CATEGORY, payload);
+}
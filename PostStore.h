@@ -0,0 +1,95 @@
+#ifndef POST_STORE_H
+#define POST_STORE_H
+
+#include "AuthenticationService.h"
+#include "PostObserver.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+class Post;
+
+// Append-only binary log of posts and their likes, comments, shares,
+// edits and deletions. On construction the log is memory-mapped and
+// replayed to rebuild each author's posts and each post's engagement;
+// afterwards every change to a stored post is appended as one record.
+//
+// Record layout: u8 type | u32 payload length | payload. Integers are
+// written in host byte order, strings as u32 length + bytes. A torn
+// record at the end of the file (crash mid-append) is cut off on load.
+class PostStore : public PostObserver {
+public:
+    enum RecordType : std::uint8_t {
+        REC_POST      = 1,
+        REC_LIKE      = 2,
+        REC_UNLIKE    = 3,
+        REC_COMMENT   = 4,
+        REC_SHARE     = 5,
+        REC_EDIT      = 6,
+        REC_DELETE    = 7,
+        REC_CATEGORY  = 8,
+        REC_REPLY     = 9     // comment + parent's position in the post's comments
+    };
+
+private:
+    std::string path;
+    std::ofstream log;
+
+    AuthenticationService& authService;
+
+    int nextPostId = FIRST_POST_ID;
+    bool replaying = false;
+
+    std::vector<Post*> posts;                     // in creation order
+    std::unordered_map<int, Post*> postsById;
+
+    // Engagement hooks arrive from any thread that touches a post
+    mutable std::mutex storeMutex;
+
+    static const std::string POSTS_FILE;
+    static const char MAGIC[8];
+    static const int FIRST_POST_ID = 1000;
+
+    void load();
+    std::size_t replay(const char* data, std::size_t size);
+    void applyRecord(std::uint8_t type, const char* payload, std::size_t length,
+                     const std::unordered_map<int, User*>& usersById);
+
+    void appendRecord(RecordType type, const std::string& payload);
+    bool isStored(const Post& post) const;
+
+public:
+    explicit PostStore(AuthenticationService& auth, const std::string& file = POSTS_FILE);
+    ~PostStore() override;
+
+    PostStore(const PostStore&) = delete;
+    PostStore& operator=(const PostStore&) = delete;
+
+    // Post IDs keep increasing across restarts
+    int allocatePostId();
+
+    // Keeps IDs already used by posts stored elsewhere (page logs) from
+    // being handed out again
+    void reservePostIds(int lastUsedId);
+
+    // Persists a newly created post; later changes to it are logged automatically
+    void appendPost(Post* post);
+
+    Post* findPost(int postId) const;
+    const std::vector<Post*>& getPosts() const;
+
+    // PostObserver
+    void onLikeAdded(const Post& post, const Like& like) override;
+    void onLikeRemoved(const Post& post, const Like& like) override;
+    void onCommentAdded(const Post& post, const Comment& comment) override;
+    void onPostShared(const Post& post) override;
+    void onPostEdited(const Post& post) override;
+    void onPostDeleted(const Post& post) override;
+    void onCategoryChanged(const Post& post, const std::string& oldCategory) override;
+};
+
+#endif // POST_STORE_H
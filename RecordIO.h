@@ -0,0 +1,115 @@
+#ifndef RECORD_IO_H
+#define RECORD_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Helpers shared by the append-only binary logs (PostStore, Page).
+// Records are u8 type | u32 payload length | payload; integers are in
+// host byte order and strings are u32 length + bytes.
+namespace recordio {
+
+constexpr std::size_t RECORD_HEADER_SIZE = 1 + sizeof(std::uint32_t);
+
+inline void putI32(std::string& out, std::int32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+inline void putI64(std::string& out, std::int64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+inline void putString(std::string& out, std::string_view s) {
+    putI32(out, static_cast<std::int32_t>(s.size()));
+    out.append(s);
+}
+
+// Writes one framed record; the caller decides when to flush
+inline void writeRecord(std::ofstream& log, std::uint8_t type, const std::string& payload) {
+    std::uint32_t length = static_cast<std::uint32_t>(payload.size());
+    char header[RECORD_HEADER_SIZE];
+    header[0] = static_cast<char>(type);
+    std::memcpy(header + 1, &length, sizeof(length));
+
+    log.write(header, sizeof(header));
+    log.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+}
+
+// Bounds-checked reader over one record payload
+class RecordReader {
+private:
+    const char* cur;
+    const char* end;
+    bool ok = true;
+
+    bool take(void* dst, std::size_t n) {
+        if (!ok || static_cast<std::size_t>(end - cur) < n) {
+            ok = false;
+            return false;
+        }
+        std::memcpy(dst, cur, n);
+        cur += n;
+        return true;
+    }
+
+public:
+    RecordReader(const char* data, std::size_t length) : cur(data), end(data + length) {}
+
+    std::int32_t i32() { std::int32_t v = 0; take(&v, sizeof(v)); return v; }
+    std::int64_t i64() { std::int64_t v = 0; take(&v, sizeof(v)); return v; }
+
+    std::string str() {
+        std::int32_t n = i32();
+        if (!ok || n < 0 || static_cast<std::size_t>(end - cur) < static_cast<std::size_t>(n)) {
+            ok = false;
+            return std::string();
+        }
+        std::string s(cur, static_cast<std::size_t>(n));
+        cur += n;
+        return s;
+    }
+
+    bool good() const { return ok; }
+};
+
+// Calls visit(data, size) over the whole file, memory-mapped where the
+// platform allows it, and returns what visit returns (the number of bytes
+// that held complete records). Returns 0 if the file cannot be read.
+template <typename Visit>
+std::size_t visitFile(const std::string& path, std::uintmax_t fileSize, Visit visit) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> buffer(static_cast<std::size_t>(fileSize));
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!in) return 0;
+    return visit(static_cast<const char*>(buffer.data()), buffer.size());
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return 0;
+
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(fileSize), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return 0;
+    ::madvise(mapped, static_cast<std::size_t>(fileSize), MADV_SEQUENTIAL);
+
+    std::size_t valid = visit(static_cast<const char*>(mapped), static_cast<std::size_t>(fileSize));
+    ::munmap(mapped, static_cast<std::size_t>(fileSize));
+    return valid;
+#endif
+}
+
+} // namespace recordio
+
+#endif // RECORD_IO_H
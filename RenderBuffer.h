@@ -0,0 +1,154 @@
+#ifndef RENDER_BUFFER_H
+#define RENDER_BUFFER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Output buffer for the display routines. Views append formatted text
+// here instead of writing to the stream line by line; the text reaches
+// the stream in chunks of up to `capacity` bytes and the stream is flushed
+// once, by flush() or the destructor. A view that is part of a larger one
+// (a post inside a feed) takes the caller's buffer, so a whole feed page
+// or chat is a handful of writes.
+//
+// Not thread-safe; use one buffer per rendering thread.
+class RenderBuffer {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+private:
+    std::ostream& out;
+    std::string buffer;
+    std::size_t capacity;
+
+    // Local-time formatting is cached per hour: "YYYY-MM-DD HH:" is kept
+    // and only minutes and seconds are worked out for each timestamp
+    time_t hourStart = 0;
+    bool hasHour = false;
+    char hourPrefix[32];
+    std::size_t hourPrefixLength = 0;
+
+    void spill() {
+        if (buffer.size() >= capacity) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    void twoDigits(long long v) {
+        buffer.push_back(static_cast<char>('0' + v / 10));
+        buffer.push_back(static_cast<char>('0' + v % 10));
+    }
+
+public:
+    explicit RenderBuffer(std::ostream& stream = std::cout, std::size_t cap = DEFAULT_CAPACITY)
+        : out(stream), capacity(cap ? cap : 1) {
+        buffer.reserve(capacity < 4096 ? capacity : 4096);
+    }
+
+    ~RenderBuffer() { flush(); }
+
+    RenderBuffer(const RenderBuffer&) = delete;
+    RenderBuffer& operator=(const RenderBuffer&) = delete;
+
+    RenderBuffer& operator<<(std::string_view s) {
+        buffer.append(s.data(), s.size());
+        spill();
+        return *this;
+    }
+
+    RenderBuffer& operator<<(const char* s) {
+        return *this << std::string_view(s);
+    }
+
+    RenderBuffer& operator<<(const std::string& s) {
+        return *this << std::string_view(s);
+    }
+
+    RenderBuffer& operator<<(char c) {
+        buffer.push_back(c);
+        spill();
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                                      !std::is_same_v<T, bool>>>
+    RenderBuffer& operator<<(T v) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), v);
+        return *this << std::string_view(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+
+    // Fixed-point with `precision` decimals
+    RenderBuffer& fixed(double v, int precision) {
+        char digits[64];
+        int n = std::snprintf(digits, sizeof(digits), "%.*f", precision, v);
+        if (n <= 0) return *this;
+        std::size_t length = static_cast<std::size_t>(n);
+        return *this << std::string_view(digits, length < sizeof(digits) ? length : sizeof(digits) - 1);
+    }
+
+    // s padded with spaces to `width`, like `std::left << std::setw(width)`
+    RenderBuffer& left(std::string_view s, std::size_t width) {
+        *this << s;
+        if (s.size() < width) buffer.append(width - s.size(), ' ');
+        spill();
+        return *this;
+    }
+
+    // s padded on the left to `width`, like `std::right << std::setw(width)`
+    RenderBuffer& right(std::string_view s, std::size_t width) {
+        if (s.size() < width) buffer.append(width - s.size(), ' ');
+        return *this << s;
+    }
+
+    RenderBuffer& right(long long v, std::size_t width) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), v);
+        return right(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+    }
+
+    RenderBuffer& repeat(char c, std::size_t count) {
+        buffer.append(count, c);
+        spill();
+        return *this;
+    }
+
+    // Local time as "YYYY-MM-DD HH:MM:SS"
+    RenderBuffer& timestamp(time_t t) {
+        if (!hasHour || t < hourStart || t >= hourStart + 3600) {
+            tm* local = std::localtime(&t);
+            if (!local) return *this << "?";
+            hourStart = t - local->tm_min * 60 - local->tm_sec;
+            hourPrefixLength = std::strftime(hourPrefix, sizeof(hourPrefix), "%Y-%m-%d %H:", local);
+            hasHour = true;
+        }
+
+        long long inHour = static_cast<long long>(t - hourStart);
+        buffer.append(hourPrefix, hourPrefixLength);
+        twoDigits(inHour / 60);
+        buffer.push_back(':');
+        twoDigits(inHour % 60);
+        spill();
+        return *this;
+    }
+
+    // Hands everything buffered so far to the stream and flushes it
+    void flush() {
+        if (!buffer.empty()) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        out.flush();
+    }
+
+    std::size_t pending() const { return buffer.size(); }
+};
+
+#endif // RENDER_BUFFER_H
@@ -0,0 +1,242 @@
+#include "SessionTable.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+
+SessionTable::SessionTable(std::chrono::seconds idle, std::chrono::seconds absolute)
+    : idleTimeout(idle), absoluteTimeout(absolute) {
+    std::uint64_t start = tickOf(Clock::now());
+    for (auto& shard : shards) shard = std::make_unique<Shard>(start);
+}
+
+std::uint64_t SessionTable::tickOf(Clock::time_point t) {
+    auto since = t.time_since_epoch();
+    return since.count() < 0 ? 0 : static_cast<std::uint64_t>(since / TICK);
+}
+
+// First tick at or after t
+std::uint64_t SessionTable::tickAfter(Clock::time_point t) {
+    std::uint64_t tick = tickOf(t);
+    Clock::time_point start(std::chrono::duration_cast<Clock::duration>(TICK * static_cast<Clock::rep>(tick)));
+    return start < t ? tick + 1 : tick;
+}
+
+namespace {
+
+// Hex digit values; 0xff marks every other byte. A table rather than
+// comparisons, because token digits are random and would defeat branch
+// prediction on every character.
+struct HexTable {
+    unsigned char value[256];
+
+    HexTable() {
+        for (unsigned char& v : value) v = 0xff;
+        for (int d = 0; d < 10; ++d) value['0' + d] = static_cast<unsigned char>(d);
+        for (int d = 0; d < 6; ++d) value['a' + d] = static_cast<unsigned char>(10 + d);
+    }
+};
+
+const HexTable HEX;
+
+// Sixteen hex digits; sets bad if any is not one
+std::uint64_t parseHalf(const char* digits, unsigned& bad) {
+    std::uint64_t half = 0;
+    for (int i = 0; i < 16; ++i) {
+        unsigned v = HEX.value[static_cast<unsigned char>(digits[i])];
+        bad |= v;
+        half = half << 4 | (v & 0xf);
+    }
+    return half;
+}
+
+} // namespace
+
+bool SessionTable::parse(const std::string& token, Key& key) {
+    if (token.size() != 32) return false;
+    unsigned bad = 0;
+    key.high = parseHalf(token.data(), bad);
+    key.low = parseHalf(token.data() + 16, bad);
+    return (bad & 0xf0) == 0;
+}
+
+std::string SessionTable::format(const Key& key) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string token(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        token[15 - i] = DIGITS[(key.high >> (4 * i)) & 0xf];
+        token[31 - i] = DIGITS[(key.low >> (4 * i)) & 0xf];
+    }
+    return token;
+}
+
+void SessionTable::drawKey(Shard& shard, Key& key) {
+    if (shard.entropyUsed + sizeof(Key) > ENTROPY_BYTES) {
+        std::size_t filled = 0;
+#ifdef __linux__
+        while (filled < ENTROPY_BYTES) {
+            ssize_t n = getrandom(shard.entropy + filled, ENTROPY_BYTES - filled, 0);
+            if (n <= 0) break;    // interrupted or unavailable; random_device below
+            filled += static_cast<std::size_t>(n);
+        }
+#endif
+        if (filled < ENTROPY_BYTES) {
+            std::random_device device;
+            for (std::size_t i = filled; i < ENTROPY_BYTES; ++i) {
+                shard.entropy[i] = static_cast<unsigned char>(device());
+            }
+        }
+        shard.entropyUsed = 0;
+    }
+    std::memcpy(&key.high, shard.entropy + shard.entropyUsed, sizeof(key.high));
+    std::memcpy(&key.low, shard.entropy + shard.entropyUsed + sizeof(key.high), sizeof(key.low));
+    std::memset(shard.entropy + shard.entropyUsed, 0, sizeof(Key));    // a token's bits are used once
+    shard.entropyUsed += sizeof(Key);
+    if (key.high == 0 && key.low == 0) drawKey(shard, key);            // the empty-slot key
+}
+
+// ─────────────── SessionMap ───────────────
+
+SessionTable::Session* SessionTable::SessionMap::find(const Key& key) {
+    if (slots.empty()) return nullptr;
+    std::size_t mask = slots.size() - 1;
+    for (std::size_t i = home(key);; i = (i + 1) & mask) {
+        Session& slot = slots[i];
+        if (slot.key == key) return &slot;
+        if (isEmpty(slot)) return nullptr;
+    }
+}
+
+void SessionTable::SessionMap::grow() {
+    std::vector<Session> old(slots.empty() ? 64 : slots.size() * 2);
+    old.swap(slots);
+    used = 0;
+    for (const Session& session : old) {
+        if (!isEmpty(session)) insert(session);
+    }
+}
+
+void SessionTable::SessionMap::insert(const Session& session) {
+    // At most 3/4 full, so probe runs stay short
+    if ((used + 1) * 4 > slots.size() * 3) grow();
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = home(session.key);
+    while (!isEmpty(slots[i])) i = (i + 1) & mask;
+    slots[i] = session;
+    ++used;
+}
+
+bool SessionTable::SessionMap::erase(const Key& key) {
+    Session* slot = find(key);
+    if (!slot) return false;
+    erase(slot);
+    return true;
+}
+
+void SessionTable::SessionMap::erase(Session* slot) {
+    std::size_t mask = slots.size() - 1;
+    std::size_t hole = static_cast<std::size_t>(slot - slots.data());
+    // Moves back each later entry of the run that may not sit past the hole
+    for (std::size_t j = (hole + 1) & mask; !isEmpty(slots[j]); j = (j + 1) & mask) {
+        std::size_t h = home(slots[j].key);
+        bool staysPut = hole <= j ? (hole < h && h <= j) : (hole < h || h <= j);
+        if (!staysPut) {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole] = Session{};
+    --used;
+}
+
+// ─────────────── SessionTable ───────────────
+
+SessionTable::Clock::time_point SessionTable::deadlineOf(const Session& session) const {
+    return std::min(session.lastUsed + idleTimeout, session.created + absoluteTimeout);
+}
+
+std::size_t SessionTable::expireShard(Shard& shard, Clock::time_point now) {
+    std::uint64_t tick = tickOf(now);
+    if (tick <= shard.wheel.currentTick()) return 0;
+
+    std::size_t dropped = 0;
+    shard.wheel.advance(tick, [&](Key key) {
+        Session* session = shard.sessions.find(key);
+        if (!session) return;                           // ended or refused since
+
+        Clock::time_point deadline = deadlineOf(*session);
+        if (deadline <= now) {
+            shard.sessions.erase(session);
+            ++dropped;
+        } else {
+            shard.wheel.schedule(key, tickAfter(deadline));
+        }
+    });
+    return dropped;
+}
+
+std::string SessionTable::create(int userId, Clock::time_point now) {
+    // Any shard will do for generating; the token's own bits choose where
+    // it is kept
+    Key key;
+    {
+        Shard& any = *shards[static_cast<std::size_t>(userId) % SHARDS];
+        std::lock_guard<std::mutex> lock(any.mutex);
+        drawKey(any, key);
+    }
+
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    expireShard(shard, now);
+    shard.sessions.insert(Session{key, userId, now, now});
+    shard.wheel.schedule(key, tickAfter(now + std::min(idleTimeout, absoluteTimeout)));
+    return format(key);
+}
+
+int SessionTable::validate(const std::string& token, Clock::time_point now) {
+    Key key;
+    if (!parse(token, key)) return -1;
+
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    expireShard(shard, now);
+
+    Session* session = shard.sessions.find(key);
+    if (!session) return -1;
+    if (deadlineOf(*session) <= now) {
+        shard.sessions.erase(session);
+        return -1;
+    }
+    if (now > session->lastUsed) session->lastUsed = now;
+    return session->userId;
+}
+
+bool SessionTable::end(const std::string& token) {
+    Key key;
+    if (!parse(token, key)) return false;
+
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.sessions.erase(key);
+}
+
+std::size_t SessionTable::expire(Clock::time_point now) {
+    std::size_t dropped = 0;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        dropped += expireShard(*shard, now);
+    }
+    return dropped;
+}
+
+std::size_t SessionTable::size() const {
+    std::size_t total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->sessions.size();
+    }
+    return total;
+}
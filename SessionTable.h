@@ -0,0 +1,134 @@
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include "TimingWheel.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Login sessions behind opaque tokens, for validating requests from many
+// concurrent clients. A token is 128 bits from the system's secure random
+// source (getrandom on Linux), written as 32 hex digits.
+// It maps to a user ID until it is ended, or has not been used for the
+// idle timeout, or is older than the absolute timeout.
+//
+// The table is split into SHARDS shards by token bits. Each has its own
+// lock, hash map and TimingWheel, so clients on different sessions rarely
+// contend. Validating is one hash lookup that records the time of use. The
+// wheel holds one entry per session, at the earliest time it could expire;
+// when that fires, the session is dropped or filed again at its current
+// deadline. A shard advances its wheel whenever it is used, so expiry is
+// amortized O(1) per session without a sweeper thread. expire() catches up
+// shards nobody has touched.
+class SessionTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t SHARDS = 16;
+    static constexpr std::chrono::seconds DEFAULT_IDLE_TIMEOUT{30 * 60};
+    static constexpr std::chrono::seconds DEFAULT_ABSOLUTE_TIMEOUT{24 * 60 * 60};
+
+    // Wheel resolution. Expired sessions are refused at once, but their
+    // memory is reclaimed at the first tick after the deadline.
+    static constexpr std::chrono::seconds TICK{1};
+
+private:
+    struct Key {
+        std::uint64_t high;
+        std::uint64_t low;
+
+        bool operator==(const Key& other) const { return high == other.high && low == other.low; }
+    };
+
+    struct Session {
+        Key key;                         // all zero: empty slot
+        int userId;
+        Clock::time_point created;
+        Clock::time_point lastUsed;
+    };
+
+    // Open-addressing table of sessions with linear probing. Tokens are
+    // random, so the low key bits are the slot index as they are. A lookup
+    // reads one or two neighbouring slots where a node-based map would
+    // chase a bucket pointer and a node. Erasing shifts the following
+    // run back, so there are no tombstones. Growing rehashes the shard's
+    // table at once; sharding keeps that to 1/SHARDS of the sessions.
+    class SessionMap {
+    private:
+        std::vector<Session> slots;      // power-of-two size
+        std::size_t used = 0;
+
+        static bool isEmpty(const Session& slot) { return slot.key.high == 0 && slot.key.low == 0; }
+        std::size_t home(const Key& key) const { return static_cast<std::size_t>(key.low) & (slots.size() - 1); }
+        void grow();
+
+    public:
+        Session* find(const Key& key);
+        void insert(const Session& session);
+        bool erase(const Key& key);
+        void erase(Session* slot);
+        std::size_t size() const { return used; }
+    };
+
+    // Random bytes for new tokens, drawn from the system in one call per
+    // ENTROPY_BYTES instead of one per token
+    static constexpr std::size_t ENTROPY_BYTES = 4096;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        SessionMap sessions;
+        TimingWheel<Key> wheel;
+        unsigned char entropy[ENTROPY_BYTES];
+        std::size_t entropyUsed = ENTROPY_BYTES;
+
+        explicit Shard(std::uint64_t startTick) : wheel(startTick) {}
+    };
+
+    std::chrono::seconds idleTimeout;
+    std::chrono::seconds absoluteTimeout;
+    std::unique_ptr<Shard> shards[SHARDS];
+
+    static std::uint64_t tickOf(Clock::time_point t);
+    static std::uint64_t tickAfter(Clock::time_point t);
+    static bool parse(const std::string& token, Key& key);
+    static std::string format(const Key& key);
+    static void drawKey(Shard& shard, Key& key);
+
+    Shard& shardOf(const Key& key) { return *shards[key.high % SHARDS]; }
+    Clock::time_point deadlineOf(const Session& session) const;
+
+    // Runs the shard's wheel up to now; the caller holds the shard's lock
+    std::size_t expireShard(Shard& shard, Clock::time_point now);
+
+public:
+    explicit SessionTable(std::chrono::seconds idle = DEFAULT_IDLE_TIMEOUT,
+                          std::chrono::seconds absolute = DEFAULT_ABSOLUTE_TIMEOUT);
+
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    // Starts a session and returns its token
+    std::string create(int userId, Clock::time_point now = Clock::now());
+
+    // The session's user ID, restarting its idle timeout; -1 if the token
+    // is malformed, unknown or expired
+    int validate(const std::string& token, Clock::time_point now = Clock::now());
+
+    // Returns false if there was no such session
+    bool end(const std::string& token);
+
+    // Advances every shard; returns the sessions dropped
+    std::size_t expire(Clock::time_point now = Clock::now());
+
+    // Sessions not yet dropped, including expired ones awaiting their tick
+    std::size_t size() const;
+
+    std::chrono::seconds getIdleTimeout() const { return idleTimeout; }
+    std::chrono::seconds getAbsoluteTimeout() const { return absoluteTimeout; }
+};
+
+#endif // SESSION_TABLE_H
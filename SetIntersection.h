@@ -0,0 +1,101 @@
+#ifndef SET_INTERSECTION_H
+#define SET_INTERSECTION_H
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SET_INTERSECTION_SSE2 1
+#endif
+
+// Counting kernels for sorted, duplicate-free int adjacency lists
+// (User::getFriendIds). Only the size of the intersection is needed for
+// mutual-friend ranking, so nothing is materialized.
+
+// Plain merge; used for the tails and when SSE2 is not available.
+inline std::size_t intersectCountScalar(const int* a, std::size_t na,
+                                        const int* b, std::size_t nb) {
+    std::size_t i = 0, j = 0, count = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            ++count;
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+// Block merge: each 4-wide block of a is compared against all four
+// rotations of the current block of b, then whichever block has the
+// smaller maximum is advanced.
+inline std::size_t intersectCount(const int* a, std::size_t na,
+                                  const int* b, std::size_t nb) {
+#ifdef SET_INTERSECTION_SSE2
+    std::size_t i = 0, j = 0, count = 0;
+    const std::size_t na4 = na & ~static_cast<std::size_t>(3);
+    const std::size_t nb4 = nb & ~static_cast<std::size_t>(3);
+
+    while (i < na4 && j < nb4) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+        __m128i m = _mm_cmpeq_epi32(va, vb);
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(m));
+        static const unsigned char bitsIn4[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+        count += bitsIn4[mask & 0xF];
+
+        const int amax = a[i + 3];
+        const int bmax = b[j + 3];
+        if (amax <= bmax) i += 4;
+        if (bmax <= amax) j += 4;
+    }
+    return count + intersectCountScalar(a + i, na - i, b + j, nb - j);
+#else
+    return intersectCountScalar(a, na, b, nb);
+#endif
+}
+
+inline std::size_t intersectCount(const std::vector<int>& a, const std::vector<int>& b) {
+    return intersectCount(a.data(), a.size(), b.data(), b.size());
+}
+
+// Dense membership bitmap over user IDs. For high-degree users it is
+// cheaper to build this once and probe it for every candidate than to
+// re-merge the same long list each time.
+class IdBitset {
+private:
+    std::vector<unsigned long long> words;
+
+public:
+    explicit IdBitset(const std::vector<int>& ids) {
+        int maxId = ids.empty() ? 0 : ids.back();
+        words.assign(static_cast<std::size_t>(maxId) / 64 + 1, 0ULL);
+        for (int id : ids) {
+            if (id >= 0) words[static_cast<std::size_t>(id) >> 6] |= 1ULL << (id & 63);
+        }
+    }
+
+    bool test(int id) const {
+        if (id < 0) return false;
+        std::size_t w = static_cast<std::size_t>(id) >> 6;
+        return w < words.size() && ((words[w] >> (id & 63)) & 1ULL);
+    }
+
+    std::size_t countIn(const std::vector<int>& ids) const {
+        std::size_t count = 0;
+        for (int id : ids) count += test(id) ? 1 : 0;
+        return count;
+    }
+};
+
+#endif // SET_INTERSECTION_H
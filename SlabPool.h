@@ -0,0 +1,120 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Owns objects of one type in geometrically growing slabs. Allocation is a
+// pointer bump into the newest slab (or reuse of a released slot), and
+// clear() destroys every live object and frees all slabs at once.
+template <typename T>
+class SlabPool {
+private:
+    struct alignas(T) Cell {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    struct Slab {
+        std::unique_ptr<Cell[]> cells;
+        std::vector<bool> live;
+        std::size_t used = 0;
+    };
+
+    std::vector<Slab> slabs;
+    std::vector<std::pair<const Cell*, std::size_t>> slabsByAddress;    // sorted by first cell
+    std::vector<std::pair<std::size_t, std::size_t>> freeSlots;         // slab, index
+    std::size_t liveCount = 0;
+
+    static constexpr std::size_t FIRST_SLAB = 4;
+    static constexpr std::size_t MAX_SLAB   = 1024;
+
+    void addSlab() {
+        std::size_t size = slabs.empty() ? FIRST_SLAB
+                                         : std::min(slabs.back().live.size() * 2, MAX_SLAB);
+        Slab slab;
+        slab.cells.reset(new Cell[size]);
+        slab.live.assign(size, false);
+        std::pair<const Cell*, std::size_t> entry(slab.cells.get(), slabs.size());
+        slabsByAddress.insert(std::upper_bound(slabsByAddress.begin(), slabsByAddress.end(), entry), entry);
+        slabs.push_back(std::move(slab));
+    }
+
+    // Finds the slab and index holding obj, or false if not from this pool.
+    // O(log slabs): a hot post can own over a thousand slabs.
+    bool locate(const T* obj, std::size_t& slab, std::size_t& index) const {
+        const Cell* cell = reinterpret_cast<const Cell*>(obj);
+        auto it = std::upper_bound(slabsByAddress.begin(), slabsByAddress.end(), cell,
+                                   [](const Cell* c, const std::pair<const Cell*, std::size_t>& e) {
+                                       return c < e.first;
+                                   });
+        if (it == slabsByAddress.begin()) return false;
+        --it;
+        if (cell >= it->first + slabs[it->second].live.size()) return false;
+        slab = it->second;
+        index = static_cast<std::size_t>(cell - it->first);
+        return true;
+    }
+
+public:
+    SlabPool() = default;
+    ~SlabPool() { clear(); }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        bool reused = !freeSlots.empty();
+        std::size_t s, i;
+        if (reused) {
+            s = freeSlots.back().first;
+            i = freeSlots.back().second;
+        } else {
+            if (slabs.empty() || slabs.back().used == slabs.back().live.size()) addSlab();
+            s = slabs.size() - 1;
+            i = slabs.back().used;
+        }
+
+        // The slot is claimed only once T is built, so a constructor that
+        // throws leaves the pool as it was
+        T* obj = new (&slabs[s].cells[i]) T(std::forward<Args>(args)...);
+        slabs[s].live[i] = true;
+        if (reused) {
+            freeSlots.pop_back();
+        } else {
+            ++slabs[s].used;
+        }
+        ++liveCount;
+        return obj;
+    }
+
+    // Destroys one object and keeps its slot for the next create()
+    void destroy(T* obj) {
+        std::size_t s, i;
+        if (!obj || !locate(obj, s, i) || !slabs[s].live[i]) return;
+        obj->~T();
+        slabs[s].live[i] = false;
+        freeSlots.emplace_back(s, i);
+        --liveCount;
+    }
+
+    void clear() {
+        for (Slab& slab : slabs) {
+            for (std::size_t i = 0; i < slab.used; ++i) {
+                if (slab.live[i]) reinterpret_cast<T*>(&slab.cells[i])->~T();
+            }
+        }
+        slabs.clear();
+        slabsByAddress.clear();
+        freeSlots.clear();
+        liveCount = 0;
+    }
+
+    std::size_t size() const { return liveCount; }
+};
+
+#endif // SLAB_POOL_H
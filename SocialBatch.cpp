@@ -0,0 +1,135 @@
+#include "SocialBatch.h"
+#include "Post.h"
+#include "User.h"
+#include "Like.h"
+#include <algorithm>
+#include <cstdlib>
+
+SocialBatch::SocialBatch(AuthenticationService& auth, FriendService& friends, SuggestionService& suggest,
+                         FeedService& feedService, PostStore& store, CategoryRegistry& registry,
+                         TrendingEngine& trendingEngine)
+    : authService(auth), friendService(friends), suggestions(suggest), feed(feedService),
+      postStore(store), categories(registry), trending(trendingEngine) {}
+
+User* SocialBatch::currentUser() const {
+    return currentUserId == -1 ? nullptr : authService.findUserById(currentUserId);
+}
+
+Post* SocialBatch::postFor(const std::string& arg) const {
+    int postId = arg == "last" ? lastPostId : std::atoi(arg.c_str());
+    Post* post = postId > 0 ? feed.findPost(postId) : nullptr;
+    return post && !post->isDeletedPost() ? post : nullptr;
+}
+
+void SocialBatch::install(BatchRunner& runner) {
+    runner.add("register", 2, "<username> <password>", [this](const BatchCommand& c) {
+        return authService.registerUser(c[1], c[2]);
+    });
+
+    runner.add("login", 2, "<username> <password>", [this](const BatchCommand& c) {
+        currentUserId = authService.login(c[1], c[2]);
+        return currentUserId != -1;
+    });
+
+    runner.add("logout", 0, "", [this](const BatchCommand&) {
+        bool wasLoggedIn = currentUserId != -1;
+        currentUserId = -1;
+        return wasLoggedIn;
+    });
+
+    runner.add("friend-request", 1, "<username>", [this](const BatchCommand& c) {
+        if (!currentUser() || !friendService.sendFriendRequest(currentUserId, c[1])) return false;
+
+        User* target = authService.findUserByUsername(c[1]);
+        if (target && friendService.areFriends(currentUserId, target->getUserId())) {
+            feed.backfillFriendship(currentUserId, target->getUserId());
+        }
+        return true;
+    });
+
+    runner.add("accept", 1, "<username>", [this](const BatchCommand& c) {
+        User* sender = authService.findUserByUsername(c[1]);
+        if (!currentUser() || !sender) return false;
+        if (!friendService.acceptFriendRequest(currentUserId, sender->getUserId())) return false;
+
+        feed.backfillFriendship(currentUserId, sender->getUserId());
+        return true;
+    });
+
+    runner.add("reject", 1, "<username>", [this](const BatchCommand& c) {
+        User* sender = authService.findUserByUsername(c[1]);
+        return currentUser() && sender && friendService.rejectFriendRequest(currentUserId, sender->getUserId());
+    });
+
+    runner.add("post", 2, "<category> <text...>", [this](const BatchCommand& c) {
+        User* user = currentUser();
+        if (!user) return false;
+
+        Post* post = new Post(postStore.allocatePostId(), user, c.text(2), 500, c[1]);
+        user->addPost(post);
+        postStore.appendPost(post);
+        feed.publishPost(post);
+        categories.addPost(post);
+        lastPostId = post->getPostId();
+        return true;
+    });
+
+    runner.add("like", 1, "<post-id|last>", [this](const BatchCommand& c) {
+        User* user = currentUser();
+        Post* post = postFor(c[1]);
+        return user && post && Like::createLike(user, post) != nullptr;
+    });
+
+    runner.add("comment", 2, "<post-id|last> <text...>", [this](const BatchCommand& c) {
+        User* user = currentUser();
+        Post* post = postFor(c[1]);
+        return user && post && post->addComment(user, c.text(2)) != nullptr;
+    });
+
+    runner.add("share", 1, "<post-id|last>", [this](const BatchCommand& c) {
+        Post* post = postFor(c[1]);
+        if (!currentUser() || !post) return false;
+        post->sharePost();
+        return true;
+    });
+
+    // Reads and renders [pages] pages of the news feed
+    runner.add("feed", 0, "[pages]", [this](const BatchCommand& c) {
+        const std::size_t FEED_PAGE_SIZE = 10;
+        if (!currentUser()) return false;
+
+        int pages = c.size() > 1 ? std::max(1, std::atoi(c[1].c_str())) : 1;
+        FeedCursor cursor;
+        for (int i = 0; i < pages; ++i) {
+            FeedPage page = feed.getFeedPage(currentUserId, FEED_PAGE_SIZE, cursor);
+            feed.showFeedPage(page);
+            if (!page.hasMore) break;
+            cursor = page.next;
+        }
+        return true;
+    });
+
+    runner.add("my-posts", 0, "", [this](const BatchCommand&) {
+        User* user = currentUser();
+        if (!user) return false;
+        user->showMyPosts();
+        return true;
+    });
+
+    runner.add("suggestions", 0, "", [this](const BatchCommand&) {
+        if (!currentUser()) return false;
+        suggestions.showSuggestionsFor(currentUserId);
+        return true;
+    });
+
+    runner.add("trending", 0, "[count]", [this](const BatchCommand& c) {
+        std::size_t count = c.size() > 1 ? static_cast<std::size_t>(std::max(1, std::atoi(c[1].c_str()))) : 10;
+        trending.showTrending(count);
+        return true;
+    });
+
+    runner.add("users", 0, "", [this](const BatchCommand&) {
+        authService.listAllUsers();
+        return true;
+    });
+}
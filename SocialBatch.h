@@ -0,0 +1,46 @@
+#ifndef SOCIAL_BATCH_H
+#define SOCIAL_BATCH_H
+
+#include "AuthenticationService.h"
+#include "FriendService.h"
+#include "SuggestionService.h"
+#include "FeedService.h"
+#include "PostStore.h"
+#include "CategoryRegistry.h"
+#include "TrendingEngine.h"
+#include "BatchRunner.h"
+#include <string>
+
+class Post;
+class User;
+
+// Script commands for `social_app --batch`. Each one does what the
+// matching menu option does, as the user logged in by the script, so a
+// script can replay a session or generate load against the real services
+// and data files. Post arguments are IDs or "last" (the newest post the
+// script created).
+class SocialBatch {
+private:
+    AuthenticationService& authService;
+    FriendService& friendService;
+    SuggestionService& suggestions;
+    FeedService& feed;
+    PostStore& postStore;
+    CategoryRegistry& categories;
+    TrendingEngine& trending;
+
+    int currentUserId = -1;
+    int lastPostId = 0;
+
+    User* currentUser() const;
+    Post* postFor(const std::string& arg) const;
+
+public:
+    SocialBatch(AuthenticationService& auth, FriendService& friends, SuggestionService& suggest,
+                FeedService& feedService, PostStore& store, CategoryRegistry& registry,
+                TrendingEngine& trendingEngine);
+
+    void install(BatchRunner& runner);
+};
+
+#endif // SOCIAL_BATCH_H
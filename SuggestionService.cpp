@@ -0,0 +1,116 @@
+#include "SuggestionService.h"
+#include "SetIntersection.h"
+#include "RenderBuffer.h"
+#include <iostream>
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+// Orders "better" suggestions first: more mutual friends, then lower ID
+bool betterSuggestion(const FriendSuggestion& a, const FriendSuggestion& b) {
+    if (a.mutualFriends != b.mutualFriends) return a.mutualFriends > b.mutualFriends;
+    return a.userId < b.userId;
+}
+
+struct WorseOnTop {
+    bool operator()(const FriendSuggestion& a, const FriendSuggestion& b) const {
+        return betterSuggestion(a, b);
+    }
+};
+
+} // namespace
+
+SuggestionService::SuggestionService(AuthenticationService& auth, FriendService& friends,
+                                     std::size_t maxPerUser)
+    : authService(auth), friendService(friends), maxSuggestions(maxPerUser) {}
+
+std::vector<FriendSuggestion> SuggestionService::computeSuggestions(int userId) const {
+    const User* user = authService.findUserById(userId);
+    if (!user || maxSuggestions == 0) return {};
+
+    const std::vector<int>& myFriends = user->getFriendIds();
+
+    // Candidates are friends of friends that are not already connected or
+    // waiting on a request in either direction
+    std::vector<int> candidates;
+    for (int fid : myFriends) {
+        const User* f = authService.findUserById(fid);
+        if (!f) continue;
+        for (int cid : f->getFriendIds()) {
+            if (cid != userId && !user->hasFriend(cid)) {
+                candidates.push_back(cid);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    const bool useBitset = myFriends.size() >= BITSET_DEGREE_THRESHOLD;
+    IdBitset myFriendBits(useBitset ? myFriends : std::vector<int>());
+
+    // Bounded min-heap: the weakest of the current top K sits on top
+    std::priority_queue<FriendSuggestion, std::vector<FriendSuggestion>, WorseOnTop> best;
+
+    for (int cid : candidates) {
+        if (friendService.hasPendingRequestBetween(userId, cid)) continue;
+
+        const User* candidate = authService.findUserById(cid);
+        if (!candidate) continue;
+
+        const std::vector<int>& theirFriends = candidate->getFriendIds();
+        std::size_t mutual = useBitset ? myFriendBits.countIn(theirFriends)
+                                       : intersectCount(myFriends, theirFriends);
+
+        FriendSuggestion s{cid, static_cast<int>(mutual)};
+        if (best.size() < maxSuggestions) {
+            best.push(s);
+        } else if (betterSuggestion(s, best.top())) {
+            best.pop();
+            best.push(s);
+        }
+    }
+
+    std::vector<FriendSuggestion> result;
+    result.reserve(best.size());
+    while (!best.empty()) {
+        result.push_back(best.top());
+        best.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+const std::vector<FriendSuggestion>& SuggestionService::getSuggestionsFor(int userId) {
+    unsigned long version = friendService.getGraphVersion();
+
+    auto it = cache.find(userId);
+    if (it != cache.end() && it->second.graphVersion == version) {
+        return it->second.top;
+    }
+
+    CachedSuggestions& entry = cache[userId];
+    entry.graphVersion = version;
+    entry.top = computeSuggestions(userId);
+    return entry.top;
+}
+
+void SuggestionService::showSuggestionsFor(int userId) {
+    const std::vector<FriendSuggestion>& suggestions = getSuggestionsFor(userId);
+
+    std::cout << "\nPeople you may know:\n";
+    if (suggestions.empty()) {
+        std::cout << "  No suggestions right now.\n";
+        return;
+    }
+
+    RenderBuffer out;
+    for (const FriendSuggestion& s : suggestions) {
+        const User* u = authService.findUserById(s.userId);
+        if (!u) continue;
+        out << "  - " << u->getUsernameView()
+            << " (ID: " << s.userId << ") - "
+            << s.mutualFriends << " mutual friend"
+            << (s.mutualFriends == 1 ? "" : "s") << '\n';
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef SUGGESTION_SERVICE_H
+#define SUGGESTION_SERVICE_H
+
+#include "AuthenticationService.h"
+#include "FriendService.h"
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+struct FriendSuggestion {
+    int userId;
+    int mutualFriends;
+};
+
+// "People you may know": friends-of-friends ranked by mutual-friend count.
+// Results are cached per user and recomputed only when FriendService
+// reports that the friendship graph has changed.
+class SuggestionService {
+private:
+    AuthenticationService& authService;
+    FriendService& friendService;
+
+    std::size_t maxSuggestions;
+
+    struct CachedSuggestions {
+        unsigned long graphVersion;
+        std::vector<FriendSuggestion> top;
+    };
+    std::unordered_map<int, CachedSuggestions> cache;
+
+    // Above this many friends a bitmap of the user's friends is built once
+    // instead of merging the user's list against every candidate.
+    static const std::size_t BITSET_DEGREE_THRESHOLD = 512;
+
+    std::vector<FriendSuggestion> computeSuggestions(int userId) const;
+
+public:
+    SuggestionService(AuthenticationService& auth, FriendService& friends,
+                      std::size_t maxPerUser = 10);
+
+    // Best first; at most maxPerUser entries
+    const std::vector<FriendSuggestion>& getSuggestionsFor(int userId);
+
+    void showSuggestionsFor(int userId);
+};
+
+#endif // SUGGESTION_SERVICE_H
@@ -0,0 +1,426 @@
+#ifndef TEXT_CODEC_H
+#define TEXT_CODEC_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Compression for message text.
+//
+// SymbolTable is for text kept in memory: each string is encoded on its
+// own, so any one message can be decoded without its neighbours. The table
+// holds up to 255 symbols of 1 to 8 bytes, trained on a sample of real
+// messages (FSST: Boncz, Neumann, Leis, "FSST: Fast Random Access String
+// Compression", VLDB 2020). Encoded text is a sequence of one-byte codes;
+// code 255 escapes a byte that no symbol covers. Decoding is a table
+// lookup and an 8-byte copy per code.
+//
+// BlockCodec is for blocks written to disk and read back whole: an LZ77
+// coder in the LZ4 style (literal runs and back references within the
+// last 64 KiB of the block), with no entropy stage, so both directions run
+// at memory-copy speeds.
+
+class SymbolTable {
+public:
+    static constexpr std::size_t MAX_SYMBOLS = 255;
+    static constexpr std::size_t MAX_SYMBOL_LENGTH = 8;
+    static constexpr std::uint8_t ESCAPE = 255;
+    static constexpr std::size_t SAMPLE_BYTES = 16 * 1024;
+
+private:
+    static constexpr std::size_t HASH_SLOTS = 1024;
+    static constexpr std::uint16_t NO_CODE = 0xFFFF;
+    static constexpr int GENERATIONS = 5;
+
+    struct Symbol {
+        std::uint64_t bytes = 0;     // little-endian, unused bytes zero
+        std::uint8_t length = 0;
+    };
+
+    std::vector<Symbol> symbols;
+
+    // Encoder lookups, entries code | length << 8 or NO_CODE.
+    // shortCodes[first two bytes] is the best code of length 1 or 2 there;
+    // byteCodes[byte] the one-byte symbol for the last byte of a text;
+    // longCodes[hash of first three bytes] is one symbol of 3+ bytes.
+    std::vector<std::uint16_t> shortCodes;
+    std::vector<std::uint16_t> byteCodes;
+    std::vector<std::uint16_t> longCodes;
+
+    static std::uint64_t load(const char* p, std::size_t n) {
+        std::uint64_t v = 0;
+        if (n >= 8) {
+            std::memcpy(&v, p, 8);
+        } else {
+            std::memcpy(&v, p, n);
+        }
+        return v;
+    }
+
+    static std::uint64_t mask(std::size_t length) {
+        return length >= 8 ? ~std::uint64_t(0) : (std::uint64_t(1) << (8 * length)) - 1;
+    }
+
+    static std::size_t hashOf(std::uint64_t firstThree) {
+        return static_cast<std::size_t>((firstThree * 0x9E3779B1u) >> 16) & (HASH_SLOTS - 1);
+    }
+
+    void buildLookups() {
+        shortCodes.assign(65536, NO_CODE);
+        longCodes.assign(HASH_SLOTS, NO_CODE);
+
+        byteCodes.assign(256, NO_CODE);
+        for (std::size_t c = 0; c < symbols.size(); ++c) {
+            if (symbols[c].length == 1) byteCodes[symbols[c].bytes & 0xFF] = static_cast<std::uint16_t>(c | 1 << 8);
+        }
+        for (std::size_t pair = 0; pair < 65536; ++pair) shortCodes[pair] = byteCodes[pair & 0xFF];
+        for (std::size_t c = 0; c < symbols.size(); ++c) {
+            if (symbols[c].length == 2) {
+                shortCodes[symbols[c].bytes & 0xFFFF] = static_cast<std::uint16_t>(c | 2 << 8);
+            } else if (symbols[c].length >= 3) {
+                std::size_t slot = hashOf(symbols[c].bytes & 0xFFFFFF);
+                // Keep the longer symbol when two share a slot
+                if (longCodes[slot] == NO_CODE || symbols[longCodes[slot]].length < symbols[c].length) {
+                    longCodes[slot] = static_cast<std::uint16_t>(c);
+                }
+            }
+        }
+    }
+
+    // Code and length of the symbol to use at p; code ESCAPE if none
+    std::pair<std::uint8_t, std::size_t> match(const char* p, std::size_t left) const {
+        std::uint64_t word = load(p, left);
+        if (left >= 3) {
+            std::uint16_t c = longCodes[hashOf(word & 0xFFFFFF)];
+            if (c != NO_CODE) {
+                const Symbol& s = symbols[c];
+                if (s.length <= left && (word & mask(s.length)) == s.bytes) {
+                    return {static_cast<std::uint8_t>(c), s.length};
+                }
+            }
+        }
+        std::uint16_t entry = left >= 2 ? shortCodes[word & 0xFFFF] : byteCodes[word & 0xFF];
+        if (entry != NO_CODE) return {static_cast<std::uint8_t>(entry & 0xFF), static_cast<std::size_t>(entry >> 8)};
+        return {ESCAPE, 1};
+    }
+
+public:
+    SymbolTable() { buildLookups(); }
+
+    // Learns symbols from sample texts (only the first SAMPLE_BYTES are
+    // used). Each generation encodes the sample with the current table,
+    // then keeps the 255 candidates with the highest gain (occurrences x
+    // length) among the symbols used, the bytes escaped and the
+    // concatenations of adjacent codes.
+    static SymbolTable train(const std::vector<std::string>& sample) {
+        std::vector<std::string_view> texts;
+        std::size_t budget = SAMPLE_BYTES;
+        for (const std::string& s : sample) {
+            if (budget == 0) break;
+            std::string_view text(s.data(), std::min(s.size(), budget));
+            texts.push_back(text);
+            budget -= text.size();
+        }
+
+        // Candidate ids: codes 0..254 are symbols, 256 + b is byte b escaped
+        const std::size_t IDS = 512;
+        SymbolTable table;
+        std::vector<std::uint32_t> single(IDS);
+        std::vector<std::uint32_t> pairs(IDS * IDS);
+
+        for (int generation = 0; generation < GENERATIONS; ++generation) {
+            std::fill(single.begin(), single.end(), 0);
+            std::fill(pairs.begin(), pairs.end(), 0);
+            auto symbolOf = [&](std::size_t id) {
+                if (id >= 256) return Symbol{id - 256, 1};
+                return table.symbols[id];
+            };
+
+            for (std::string_view text : texts) {
+                std::size_t previous = IDS;
+                for (std::size_t i = 0; i < text.size();) {
+                    auto [code, length] = table.match(text.data() + i, text.size() - i);
+                    std::size_t id = code == ESCAPE ? 256 + static_cast<std::uint8_t>(text[i]) : code;
+                    ++single[id];
+                    if (previous != IDS) ++pairs[previous * IDS + id];
+                    previous = id;
+                    i += length;
+                }
+            }
+
+            struct Candidate {
+                std::uint64_t gain;
+                Symbol symbol;
+            };
+            std::vector<Candidate> candidates;
+            for (std::size_t a = 0; a < IDS; ++a) {
+                if (!single[a]) continue;
+                Symbol sa = symbolOf(a);
+                candidates.push_back({std::uint64_t(single[a]) * sa.length, sa});
+                for (std::size_t b = 0; b < IDS; ++b) {
+                    std::uint32_t count = pairs[a * IDS + b];
+                    if (!count) continue;
+                    Symbol sb = symbolOf(b);
+                    if (sa.length + sb.length > MAX_SYMBOL_LENGTH) continue;
+                    Symbol joined{sa.bytes | (sb.bytes << (8 * sa.length)),
+                                  static_cast<std::uint8_t>(sa.length + sb.length)};
+                    candidates.push_back({std::uint64_t(count) * joined.length, joined});
+                }
+            }
+
+            // The same symbol can come from several pairs; add up its gain
+            std::sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+                return x.symbol.length != y.symbol.length ? x.symbol.length < y.symbol.length
+                                                          : x.symbol.bytes < y.symbol.bytes;
+            });
+            std::vector<Candidate> merged;
+            for (const Candidate& c : candidates) {
+                if (!merged.empty() && merged.back().symbol.length == c.symbol.length &&
+                    merged.back().symbol.bytes == c.symbol.bytes) {
+                    merged.back().gain += c.gain;
+                } else {
+                    merged.push_back(c);
+                }
+            }
+            std::size_t keep = std::min(merged.size(), MAX_SYMBOLS);
+            std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(keep), merged.end(),
+                              [](const Candidate& x, const Candidate& y) { return x.gain > y.gain; });
+
+            table.symbols.clear();
+            for (std::size_t i = 0; i < keep; ++i) table.symbols.push_back(merged[i].symbol);
+            table.buildLookups();
+        }
+        return table;
+    }
+
+    std::size_t size() const { return symbols.size(); }
+
+    // At most two bytes per input byte (all escapes)
+    void encode(std::string_view text, std::string& out) const {
+        out.resize(2 * text.size());
+        char* dst = out.empty() ? nullptr : &out[0];
+        char* begin = dst;
+        for (std::size_t i = 0; i < text.size();) {
+            auto [code, length] = match(text.data() + i, text.size() - i);
+            *dst++ = static_cast<char>(code);
+            if (code == ESCAPE) *dst++ = text[i];
+            i += length;
+        }
+        out.resize(static_cast<std::size_t>(dst - begin));
+    }
+
+    // Appends the decoded text of encoded to out
+    void decodeAppend(std::string_view encoded, std::string& out) const {
+        std::size_t start = out.size();
+        out.resize(start + encoded.size() * MAX_SYMBOL_LENGTH + MAX_SYMBOL_LENGTH);
+        char* dst = &out[start];
+        for (std::size_t i = 0; i < encoded.size(); ++i) {
+            std::uint8_t code = static_cast<std::uint8_t>(encoded[i]);
+            if (code == ESCAPE) {
+                if (++i == encoded.size()) break;
+                *dst++ = encoded[i];
+            } else if (code < symbols.size()) {
+                std::memcpy(dst, &symbols[code].bytes, MAX_SYMBOL_LENGTH);
+                dst += symbols[code].length;
+            }
+        }
+        out.resize(static_cast<std::size_t>(dst - out.data()));
+    }
+
+    std::string decode(std::string_view encoded) const {
+        std::string out;
+        decodeAppend(encoded, out);
+        return out;
+    }
+
+    // Streams the decoded text to out (anything with << string_view) in
+    // small pieces, without a heap buffer
+    template <typename Out>
+    void decodeTo(std::string_view encoded, Out& out) const {
+        char buffer[256 + MAX_SYMBOL_LENGTH];
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < encoded.size(); ++i) {
+            std::uint8_t code = static_cast<std::uint8_t>(encoded[i]);
+            if (code == ESCAPE) {
+                if (++i == encoded.size()) break;
+                buffer[used++] = encoded[i];
+            } else if (code < symbols.size()) {
+                std::memcpy(buffer + used, &symbols[code].bytes, MAX_SYMBOL_LENGTH);
+                used += symbols[code].length;
+            }
+            if (used >= 256) {
+                out << std::string_view(buffer, used);
+                used = 0;
+            }
+        }
+        if (used) out << std::string_view(buffer, used);
+    }
+
+    // File: "symtab 1 <count>\n", then per symbol a length byte and its bytes
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << "symtab 1 " << symbols.size() << "\n";
+        for (const Symbol& s : symbols) {
+            out.put(static_cast<char>(s.length));
+            out.write(reinterpret_cast<const char*>(&s.bytes), s.length);
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::string magic;
+        int version = 0;
+        std::size_t count = 0;
+        if (!(in >> magic >> version >> count) || magic != "symtab" || version != 1 || count > MAX_SYMBOLS) {
+            return false;
+        }
+        in.get();
+
+        std::vector<Symbol> loaded(count);
+        for (Symbol& s : loaded) {
+            int length = in.get();
+            if (length < 1 || length > static_cast<int>(MAX_SYMBOL_LENGTH)) return false;
+            s.length = static_cast<std::uint8_t>(length);
+            if (!in.read(reinterpret_cast<char*>(&s.bytes), length)) return false;
+        }
+        symbols = std::move(loaded);
+        buildLookups();
+        return true;
+    }
+};
+
+class BlockCodec {
+private:
+    static constexpr std::size_t MIN_MATCH = 4;
+    static constexpr std::size_t MAX_OFFSET = 65535;
+    static constexpr unsigned HASH_BITS = 14;
+
+    static std::uint32_t read32(const char* p) {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static void putLength(std::string& out, std::size_t extra) {
+        for (; extra >= 255; extra -= 255) out.push_back(static_cast<char>(255));
+        out.push_back(static_cast<char>(extra));
+    }
+
+    static bool getLength(const char*& p, const char* end, std::size_t& length) {
+        while (true) {
+            if (p == end) return false;
+            std::uint8_t b = static_cast<std::uint8_t>(*p++);
+            length += b;
+            if (b != 255) return true;
+        }
+    }
+
+public:
+    // Block: varint decoded size, then sequences of
+    //   token (literal count << 4 | match length - 4), extra literal count,
+    //   literals, 2-byte offset, extra match length
+    // where a nibble of 15 means more length bytes follow. The last
+    // sequence has literals only.
+    static std::string compress(std::string_view input) {
+        std::string out;
+        out.reserve(input.size() / 2 + 16);
+        for (std::uint64_t n = input.size(); ; n >>= 7) {
+            out.push_back(static_cast<char>((n & 0x7F) | (n >= 0x80 ? 0x80 : 0)));
+            if (n < 0x80) break;
+        }
+
+        std::vector<std::uint32_t> table(std::size_t(1) << HASH_BITS, UINT32_MAX);
+        const char* base = input.data();
+        std::size_t size = input.size();
+        std::size_t anchor = 0;
+        std::size_t i = 0;
+
+        auto emit = [&](std::size_t literals, std::size_t offset, std::size_t matchLength) {
+            std::size_t litNibble = literals < 15 ? literals : 15;
+            std::size_t matchNibble = matchLength == 0 ? 0 : (matchLength - MIN_MATCH < 15 ? matchLength - MIN_MATCH : 15);
+            out.push_back(static_cast<char>(litNibble << 4 | matchNibble));
+            if (litNibble == 15) putLength(out, literals - 15);
+            out.append(base + anchor, literals);
+            if (matchLength == 0) return;
+            out.push_back(static_cast<char>(offset & 0xFF));
+            out.push_back(static_cast<char>(offset >> 8));
+            if (matchNibble == 15) putLength(out, matchLength - MIN_MATCH - 15);
+        };
+
+        while (size >= MIN_MATCH && i + MIN_MATCH <= size) {
+            std::uint32_t word = read32(base + i);
+            std::size_t slot = (word * 2654435761u) >> (32 - HASH_BITS);
+            std::uint32_t candidate = table[slot];
+            table[slot] = static_cast<std::uint32_t>(i);
+
+            if (candidate == UINT32_MAX || i - candidate > MAX_OFFSET || read32(base + candidate) != word) {
+                ++i;
+                continue;
+            }
+            std::size_t length = MIN_MATCH;
+            while (i + length < size && base[candidate + length] == base[i + length]) ++length;
+
+            emit(i - anchor, i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+        emit(size - anchor, 0, 0);
+        return out;
+    }
+
+    // False if block is malformed
+    static bool decompress(std::string_view block, std::string& out) {
+        const char* p = block.data();
+        const char* end = p + block.size();
+        std::uint64_t size = 0;
+        for (unsigned shift = 0; ; shift += 7) {
+            if (p == end || shift > 63) return false;
+            std::uint8_t b = static_cast<std::uint8_t>(*p++);
+            size |= std::uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+
+        if (size > block.size() * 255 + 16) return false;    // more than any block can expand to
+        out.resize(static_cast<std::size_t>(size));
+        char* begin = out.empty() ? nullptr : &out[0];
+        std::size_t used = 0;
+        while (p < end) {
+            std::uint8_t token = static_cast<std::uint8_t>(*p++);
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !getLength(p, end, literals)) return false;
+            if (static_cast<std::size_t>(end - p) < literals || used + literals > size) return false;
+            std::memcpy(begin + used, p, literals);
+            used += literals;
+            p += literals;
+            if (p == end) break;
+
+            if (end - p < 2) return false;
+            std::size_t offset = static_cast<std::uint8_t>(p[0]) | static_cast<std::size_t>(static_cast<std::uint8_t>(p[1])) << 8;
+            p += 2;
+            std::size_t length = (token & 0x0F) + MIN_MATCH;
+            if ((token & 0x0F) == 15 && !getLength(p, end, length)) return false;
+            if (offset == 0 || offset > used || used + length > size) return false;
+
+            char* dst = begin + used;
+            const char* src = dst - offset;
+            if (offset >= length) {
+                std::memcpy(dst, src, length);
+            } else {
+                // Overlapping: the match repeats the last offset bytes
+                for (std::size_t k = 0; k < length; ++k) dst[k] = src[k];
+            }
+            used += length;
+        }
+        return used == size;
+    }
+};
+
+#endif // TEXT_CODEC_H
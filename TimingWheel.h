@@ -0,0 +1,130 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel: LEVELS wheels of SLOTS slots, each level's
+// slot spanning a whole turn of the level below (1, 64, 4096 and 262144
+// ticks). An entry is filed by how far away its deadline is, and moves
+// down one level each time the wheel reaches its slot, so scheduling is
+// O(1) and each entry is touched at most LEVELS times before it fires.
+//
+// Entries cannot be cancelled. Owners keep the real deadline themselves
+// and check it when an entry fires, rescheduling it if it was pushed back
+// meanwhile. That also covers deadlines past the horizon (2^24 ticks),
+// which fire at the horizon.
+template <typename Id>
+class TimingWheel {
+public:
+    static constexpr int BITS = 6;
+    static constexpr int LEVELS = 4;
+    static constexpr std::size_t SLOTS = std::size_t(1) << BITS;
+    static constexpr std::uint64_t HORIZON = std::uint64_t(1) << (BITS * LEVELS);
+
+private:
+    static constexpr std::uint64_t MASK = SLOTS - 1;
+
+    struct Entry {
+        Id id;
+        std::uint64_t deadline;
+    };
+
+    std::vector<Entry> slots[LEVELS][SLOTS];
+    std::uint64_t occupied[LEVELS] = {};     // bit s set: slot s is non-empty
+    std::uint64_t current = 0;               // last tick processed
+    std::size_t count = 0;
+    std::vector<Entry> due;                  // slot being fired or cascaded
+
+    // deadline >= current; a cascade files entries due this very tick on
+    // the level-0 slot that is about to fire
+    void place(Id&& id, std::uint64_t deadline) {
+        if (deadline - current >= HORIZON) deadline = current + HORIZON - 1;
+
+        std::uint64_t delta = deadline - current;
+        int level = 0;
+        while (level + 1 < LEVELS && delta >= (std::uint64_t(1) << (BITS * (level + 1)))) ++level;
+
+        std::size_t slot = static_cast<std::size_t>((deadline >> (BITS * level)) & MASK);
+        slots[level][slot].push_back(Entry{std::move(id), deadline});
+        occupied[level] |= std::uint64_t(1) << slot;
+    }
+
+    // Takes a slot's entries into `due`
+    void take(int level, std::size_t slot) {
+        due.clear();
+        due.swap(slots[level][slot]);
+        occupied[level] &= ~(std::uint64_t(1) << slot);
+    }
+
+    // At a tick where every level below `level` has wrapped to slot 0:
+    // moves the level's current slot down, higher levels first
+    void cascade(int level) {
+        std::size_t slot = static_cast<std::size_t>((current >> (BITS * level)) & MASK);
+        if (level + 1 < LEVELS && slot == 0) cascade(level + 1);
+        if (!(occupied[level] & (std::uint64_t(1) << slot))) return;
+
+        take(level, slot);
+        std::vector<Entry> moving;
+        moving.swap(due);
+        for (Entry& e : moving) place(std::move(e.id), e.deadline);
+        moving.clear();
+        due.swap(moving);                    // keep the capacity
+    }
+
+public:
+    explicit TimingWheel(std::uint64_t startTick = 0) : current(startTick) {}
+
+    // A deadline already passed fires at the next tick
+    void schedule(Id id, std::uint64_t deadlineTick) {
+        place(std::move(id), deadlineTick > current ? deadlineTick : current + 1);
+        ++count;
+    }
+
+    // Processes every tick up to nowTick and calls fire(id) for each entry
+    // that came due; fire may schedule again. Returns the entries fired.
+    template <typename Fire>
+    std::size_t advance(std::uint64_t nowTick, Fire&& fire) {
+        std::size_t fired = 0;
+        while (current < nowTick) {
+            if (count == 0) {
+                current = nowTick;
+                break;
+            }
+            // Empty low levels: skip to the tick before the next cascade
+            // that can bring anything down to level 0
+            int empty = 0;
+            while (empty + 1 < LEVELS && occupied[empty] == 0) ++empty;
+            if (empty > 0) {
+                std::uint64_t beforeCascade = current | ((std::uint64_t(1) << (BITS * empty)) - 1);
+                if (beforeCascade >= nowTick) {
+                    current = nowTick;
+                    break;
+                }
+                current = beforeCascade;
+            }
+
+            ++current;
+            if ((current & MASK) == 0) cascade(1);
+
+            std::size_t slot = static_cast<std::size_t>(current & MASK);
+            if (!(occupied[0] & (std::uint64_t(1) << slot))) continue;
+            take(0, slot);
+            std::vector<Entry> firing;
+            firing.swap(due);
+            count -= firing.size();
+            fired += firing.size();
+            for (Entry& e : firing) fire(std::move(e.id));
+            firing.clear();
+            due.swap(firing);
+        }
+        return fired;
+    }
+
+    std::size_t size() const { return count; }
+    std::uint64_t currentTick() const { return current; }
+};
+
+#endif // TIMING_WHEEL_H
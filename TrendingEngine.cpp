@@ -0,0 +1,166 @@
+#include "TrendingEngine.h"
+#include "Post.h"
+#include "User.h"
+#include "Like.h"
+#include "Comment.h"
+#include "RenderBuffer.h"
+#include "EpochReclaimer.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+TrendingEngine::TrendingEngine(double halfLifeHours, time_t start)
+    : halfLifeSeconds(halfLifeHours > 0 ? halfLifeHours * 3600.0 : 3600.0),
+      landmark(start ? start : time(nullptr)) {
+    Post::addObserver(this);
+}
+
+TrendingEngine::~TrendingEngine() {
+    Post::removeObserver(this);
+}
+
+double TrendingEngine::weightOf(Engagement kind) {
+    switch (kind) {
+        case LIKE:    return LIKE_WEIGHT;
+        case COMMENT: return COMMENT_WEIGHT;
+        case SHARE:   return SHARE_WEIGHT;
+    }
+    return 0.0;
+}
+
+double TrendingEngine::growth(time_t at) const {
+    return std::exp2(static_cast<double>(at - landmark) / halfLifeSeconds);
+}
+
+void TrendingEngine::rebaseLocked(time_t newLandmark) {
+    double factor = std::exp2(-static_cast<double>(newLandmark - landmark) / halfLifeSeconds);
+    landmark = newLandmark;
+
+    ranking.clear();
+    for (auto& entry : scores) {
+        entry.second.score *= factor;
+        ranking.emplace(entry.second.score, entry.first);
+    }
+}
+
+void TrendingEngine::addLocked(const Post& post, double delta) {
+    int postId = post.getPostId();
+    auto it = scores.find(postId);
+    if (it == scores.end()) {
+        if (delta <= 0) return;
+        scores.emplace(postId, Scored{&post, delta});
+        ranking.emplace(delta, postId);
+        return;
+    }
+
+    ranking.erase({it->second.score, postId});
+    it->second.score += delta;
+    if (it->second.score <= 0) {
+        scores.erase(it);             // every engagement was undone
+        return;
+    }
+    ranking.emplace(it->second.score, postId);
+}
+
+void TrendingEngine::record(const Post& post, Engagement kind, time_t at) {
+    if (post.isDeletedPost()) return;
+    if (at == 0) at = time(nullptr);
+
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (static_cast<double>(at - landmark) / halfLifeSeconds > MAX_EXPONENT) {
+        rebaseLocked(at);
+    }
+    addLocked(post, weightOf(kind) * growth(at));
+}
+
+void TrendingEngine::seedPost(const Post& post) {
+    if (post.isDeletedPost()) return;
+
+    EpochGuard guard;    // the post may be deleted while it is seeded
+    for (const Like* like : post.getLikes()) {
+        record(post, LIKE, like->getTime());
+    }
+
+    const auto& comments = post.getComments();
+    for (std::size_t i = 0; i < comments.size(); ++i) {
+        if (!comments[i]->isDeletedComment()) {
+            record(post, COMMENT, comments[i]->getCreationTime());
+        }
+    }
+
+    for (int s = post.getShareCount(); s > 0; --s) {
+        record(post, SHARE, post.getCreationTime());
+    }
+}
+
+void TrendingEngine::removePost(int postId) {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    auto it = scores.find(postId);
+    if (it == scores.end()) return;
+
+    ranking.erase({it->second.score, postId});
+    scores.erase(it);
+}
+
+std::vector<TrendingEntry> TrendingEngine::getTopPosts(std::size_t k, time_t now) const {
+    if (now == 0) now = time(nullptr);
+
+    std::lock_guard<std::mutex> lock(engineMutex);
+    double decay = 1.0 / growth(now);
+
+    std::vector<TrendingEntry> top;
+    top.reserve(std::min(k, ranking.size()));
+    for (auto it = ranking.begin(); it != ranking.end() && top.size() < k; ++it) {
+        top.push_back({scores.at(it->second).post, it->first * decay});
+    }
+    return top;
+}
+
+std::size_t TrendingEngine::size() const {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    return scores.size();
+}
+
+void TrendingEngine::showTrending(std::size_t k) const {
+    std::vector<TrendingEntry> top = getTopPosts(k);
+    if (top.empty()) {
+        std::cout << "Nothing is trending yet. Like, comment on or share a post!\n";
+        return;
+    }
+
+    RenderBuffer out;
+    int rank = 1;
+    for (const TrendingEntry& e : top) {
+        out << "#" << rank++ << "  @" << e.post->getAuthor()->getUsernameView() << "  (score ";
+        out.fixed(e.score, 2) << ")\n";
+        e.post->viewPost(out);
+        out.repeat('-', 50) << '\n';
+    }
+}
+
+// ─────────────── PostObserver ───────────────
+
+void TrendingEngine::onLikeAdded(const Post& post, const Like& like) {
+    record(post, LIKE, like.getTime());
+}
+
+void TrendingEngine::onLikeRemoved(const Post& post, const Like& like) {
+    if (post.isDeletedPost()) return;
+
+    time_t at = like.getTime() ? like.getTime() : time(nullptr);
+    std::lock_guard<std::mutex> lock(engineMutex);
+    addLocked(post, -LIKE_WEIGHT * growth(at));
+}
+
+void TrendingEngine::onCommentAdded(const Post& post, const Comment& comment) {
+    record(post, COMMENT, comment.getCreationTime());
+}
+
+void TrendingEngine::onPostShared(const Post& post) {
+    record(post, SHARE);
+}
+
+void TrendingEngine::onPostDeleted(const Post& post) {
+    removePost(post.getPostId());
+}
@@ -0,0 +1,92 @@
+#ifndef TRENDING_ENGINE_H
+#define TRENDING_ENGINE_H
+
+#include "PostObserver.h"
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <utility>
+#include <ctime>
+#include <cstddef>
+
+class Post;
+
+struct TrendingEntry {
+    const Post* post;
+    double score;        // decayed to the time of the query
+};
+
+// Ranks posts by exponentially time-decayed engagement. Each like,
+// comment or share adds weight * 2^((t - landmark) / halfLife) to the
+// post's stored score. Every stored score shrinks by the same factor as
+// time passes, so their order never changes and nothing is rescored;
+// a query only scales the top K back to "now". When the exponent grows
+// too large the landmark moves forward and all scores are rebased once.
+//
+// Scores live in an ordered set, so an update is O(log n) and reading
+// the top K is O(K).
+class TrendingEngine : public PostObserver {
+public:
+    enum Engagement { LIKE, COMMENT, SHARE };
+
+    static constexpr double LIKE_WEIGHT = 1.0;
+    static constexpr double COMMENT_WEIGHT = 2.0;
+    static constexpr double SHARE_WEIGHT = 3.0;
+
+private:
+    double halfLifeSeconds;
+    time_t landmark;
+
+    struct Scored {
+        const Post* post;
+        double score;
+    };
+
+    std::unordered_map<int, Scored> scores;                     // post ID -> stored score
+    std::set<std::pair<double, int>, std::greater<>> ranking;   // (stored score, post ID)
+
+    mutable std::mutex engineMutex;
+
+    // Keeps 2^exponent comfortably inside double range
+    static constexpr double MAX_EXPONENT = 512.0;
+
+    static double weightOf(Engagement kind);
+    double growth(time_t at) const;
+
+    // Callers hold engineMutex
+    void addLocked(const Post& post, double delta);
+    void rebaseLocked(time_t newLandmark);
+
+public:
+    explicit TrendingEngine(double halfLifeHours = 6.0, time_t start = 0);
+    ~TrendingEngine() override;
+
+    TrendingEngine(const TrendingEngine&) = delete;
+    TrendingEngine& operator=(const TrendingEngine&) = delete;
+
+    // at == 0 means now
+    void record(const Post& post, Engagement kind, time_t at = 0);
+
+    // Scores existing likes and comments at their own timestamps; shares
+    // carry no timestamp and are counted at the post's creation time
+    void seedPost(const Post& post);
+
+    void removePost(int postId);
+
+    // Highest-scoring posts first; now == 0 means the current time
+    std::vector<TrendingEntry> getTopPosts(std::size_t k, time_t now = 0) const;
+
+    std::size_t size() const;
+
+    void showTrending(std::size_t k) const;
+
+    // PostObserver
+    void onLikeAdded(const Post& post, const Like& like) override;
+    void onLikeRemoved(const Post& post, const Like& like) override;
+    void onCommentAdded(const Post& post, const Comment& comment) override;
+    void onPostShared(const Post& post) override;
+    void onPostDeleted(const Post& post) override;
+};
+
+#endif // TRENDING_ENGINE_H
@@ -1,5 +1,6 @@
 #include "User.h"
 #include "Post.h"           // ← very important! needed for Post*
+#include "RenderBuffer.h"
 
 #include <iostream>
 #include <algorithm>
@@ -22,24 +23,47 @@ std::string User::getPassword() const {
     return password;
 }
 
+std::string_view User::getUsernameView() const {
+    return username;
+}
+
+std::string_view User::getPasswordView() const {
+    return password;
+}
+
+std::string_view User::getDisplayNameView() const {
+    return displayName.empty() ? std::string_view(username) : std::string_view(displayName);
+}
+
+void User::setDisplayName(const std::string& name) {
+    displayName = name == username ? std::string() : name;
+}
+
 const std::vector<int>& User::getFriendIds() const {
     return friendIds;
 }
 
+// friendIds is kept sorted so adjacency lists can be intersected directly
 void User::addFriend(int friendUserId) {
-    if (!hasFriend(friendUserId)) {
-        friendIds.push_back(friendUserId);
+    auto it = std::lower_bound(friendIds.begin(), friendIds.end(), friendUserId);
+    if (it == friendIds.end() || *it != friendUserId) {
+        friendIds.insert(it, friendUserId);
     }
 }
 
 bool User::hasFriend(int otherId) const {
-    return std::find(friendIds.begin(), friendIds.end(), otherId) != friendIds.end();
+    return std::binary_search(friendIds.begin(), friendIds.end(), otherId);
 }
 
 void User::printBasicInfo() const {
-    std::cout << "ID: " << userId
-              << " | Username: " << username
-              << " | Friends count: " << friendIds.size() << "\n";
+    RenderBuffer out;
+    printBasicInfo(out);
+}
+
+void User::printBasicInfo(RenderBuffer& out) const {
+    out << "ID: " << userId
+        << " | Username: " << username
+        << " | Friends count: " << friendIds.size() << '\n';
 }
 
 
@@ -59,13 +83,14 @@ void User::showMyPosts() const {
         return;
     }
 
-    std::cout << "\nPosts by @" << username << " (" << myPosts.size() << " total):\n";
-    std::cout << "----------------------------------------\n";
+    RenderBuffer out;
+    out << "\nPosts by @" << username << " (" << myPosts.size() << " total):\n";
+    out << "----------------------------------------\n";
 
     for (const Post* p : myPosts) {
         if (p) {
-            p->viewPost();
-            std::cout << "----------------------------------------\n";
+            p->viewPost(out);
+            out << "----------------------------------------\n";
         }
     }
 }
@@ -3,16 +3,19 @@
 #define USER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Post;  
+class RenderBuffer;
 
 class User {
 private:
     int userId;
     std::string username;
     std::string password;
-    std::vector<int> friendIds;
+    std::string displayName;             // empty when it is the username
+    std::vector<int> friendIds;          // sorted ascending
     std::vector<Post*> myPosts;          
 
 public:
@@ -23,12 +26,21 @@ public:
     std::string         getUsername()   const;
     std::string         getPassword()   const;
 
+    // Non-owning views; valid while the user is alive and unmodified
+    std::string_view    getUsernameView() const;
+    std::string_view    getPasswordView() const;
+
+    // Name shown by the messenger; the username unless one was set
+    std::string_view    getDisplayNameView() const;
+    void                setDisplayName(const std::string& name);
+
     const std::vector<int>& getFriendIds() const;
 
     void addFriend(int friendUserId);
     bool hasFriend(int otherId) const;
 
     void printBasicInfo() const;
+    void printBasicInfo(RenderBuffer& out) const;
 
   
     void                addPost(Post* post);
@@ -0,0 +1,195 @@
+#include "UserDirectory.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+const std::string UserDirectory::USERS_FILE = "users.txt";
+const std::string UserDirectory::MESSENGER_USERS_FILE = "users.csv";
+
+namespace {
+
+bool isValidUsername(std::string_view name) {
+    return !name.empty() && name.find_first_of(" \t\r\n,") == std::string_view::npos;
+}
+
+} // namespace
+
+UserDirectory::UserDirectory(const std::string& file, const std::string& legacyMessengerFile)
+    : positionByName(UsernameAt{&users}), path(file) {
+    load();
+    if (!legacyMessengerFile.empty()) {
+        importMessengerUsers(legacyMessengerFile);
+    }
+}
+
+// Lines are "id<TAB>username<TAB>password<TAB>display name"; lines without
+// a tab are the older "id username password" format
+void UserDirectory::load() {
+    std::ifstream in(path);
+    if (!in.is_open()) return;
+
+    struct Record {
+        int id;
+        std::string username, password, displayName;
+    };
+    std::vector<Record> records;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        int id = 0;
+        std::string username, password, displayName;
+        if (line.find('\t') != std::string::npos) {
+            std::istringstream fields(line);
+            std::string idField;
+            std::getline(fields, idField, '\t');
+            std::getline(fields, username, '\t');
+            std::getline(fields, password, '\t');
+            std::getline(fields, displayName);
+            id = std::atoi(idField.c_str());
+        } else {
+            std::istringstream fields(line);
+            if (!(fields >> id >> username >> password)) continue;
+        }
+        if (id <= 0 || username.empty()) continue;
+        records.push_back(Record{id, std::move(username), std::move(password), std::move(displayName)});
+    }
+
+    // Files written by this class are already in ID order. Records are
+    // sorted before any User is made, since the index refers to them by position.
+    auto byId = [](const Record& a, const Record& b) { return a.id < b.id; };
+    if (!std::is_sorted(records.begin(), records.end(), byId)) {
+        std::stable_sort(records.begin(), records.end(), byId);
+    }
+
+    // The first record wins over a later one with the same ID or username
+    positionByName.reserve(records.size());
+    for (Record& r : records) {
+        if (!users.empty() && users.back().getUserId() == r.id) continue;    // duplicate ID
+        users.emplace_back(r.id, r.username, r.password);
+        if (!positionByName.insert(users.back().getUsernameView(),
+                                   static_cast<std::uint32_t>(users.size() - 1))) {
+            users.pop_back();                                                // duplicate name
+            continue;
+        }
+        users.back().setDisplayName(r.displayName);
+        nextUserId = std::max(nextUserId, r.id + 1);
+    }
+}
+
+void UserDirectory::importMessengerUsers(const std::string& csvPath) {
+    std::ifstream in(csvPath);
+    if (!in.is_open()) return;
+
+    bool changed = false;
+    std::string line;
+    std::getline(in, line);   // header
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::string userId = line.substr(0, line.find(','));
+        std::string name = userId.size() < line.size() ? line.substr(userId.size() + 1) : "";
+        if (!isValidUsername(userId)) continue;
+
+        // Same ID on both sides is taken to be the same person
+        if (User* existing = findByName(userId)) {
+            if (existing->getDisplayNameView() != name) {
+                existing->setDisplayName(name);
+                changed = true;
+            }
+        } else {
+            users.emplace_back(nextUserId++, userId, "");
+            users.back().setDisplayName(name);
+            positionByName.insert(users.back().getUsernameView(),
+                                  static_cast<std::uint32_t>(users.size() - 1));
+            changed = true;
+        }
+    }
+    in.close();
+
+    if (changed) saveAll();
+
+    std::error_code ec;
+    std::filesystem::rename(csvPath, csvPath + ".imported", ec);
+}
+
+void UserDirectory::appendToFile(const User& user) const {
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) return;
+    out << user.getUserId() << '\t' << user.getUsernameView() << '\t'
+        << user.getPasswordView() << '\t' << user.getDisplayNameView() << '\n';
+}
+
+void UserDirectory::saveAll() const {
+    std::ofstream out(path);
+    if (!out.is_open()) return;
+    for (const User& u : users) {
+        out << u.getUserId() << '\t' << u.getUsernameView() << '\t'
+            << u.getPasswordView() << '\t' << u.getDisplayNameView() << '\n';
+    }
+}
+
+User* UserDirectory::addUser(const std::string& username, const std::string& password,
+                             const std::string& displayName) {
+    if (!isValidUsername(username) || password.find_first_of("\t\n") != std::string::npos ||
+        displayName.find('\n') != std::string::npos || positionByName.contains(username)) {
+        return nullptr;
+    }
+
+    users.emplace_back(nextUserId++, username, password);
+    User& user = users.back();
+    user.setDisplayName(displayName);
+    positionByName.insert(user.getUsernameView(), static_cast<std::uint32_t>(users.size() - 1));
+
+    appendToFile(user);
+    return &user;
+}
+
+User* UserDirectory::findById(int id) {
+    auto it = std::lower_bound(users.begin(), users.end(), id,
+                               [](const User& u, int target) { return u.getUserId() < target; });
+    return it != users.end() && it->getUserId() == id ? &*it : nullptr;
+}
+
+const User* UserDirectory::findById(int id) const {
+    auto it = std::lower_bound(users.begin(), users.end(), id,
+                               [](const User& u, int target) { return u.getUserId() < target; });
+    return it != users.end() && it->getUserId() == id ? &*it : nullptr;
+}
+
+User* UserDirectory::findByName(std::string_view username) {
+    std::uint32_t position = positionByName.find(username);
+    return position == FlatStringIndex<UsernameAt>::NONE ? nullptr : &users[position];
+}
+
+const User* UserDirectory::findByName(std::string_view username) const {
+    std::uint32_t position = positionByName.find(username);
+    return position == FlatStringIndex<UsernameAt>::NONE ? nullptr : &users[position];
+}
+
+bool UserDirectory::setDisplayName(int id, const std::string& displayName) {
+    User* user = findById(id);
+    if (!user || displayName.find('\n') != std::string::npos) return false;
+
+    user->setDisplayName(displayName);
+    saveAll();
+    return true;
+}
+
+std::size_t UserDirectory::size() const {
+    return users.size();
+}
+
+std::deque<User>& UserDirectory::getUsers() {
+    return users;
+}
+
+const std::deque<User>& UserDirectory::getUsers() const {
+    return users;
+}
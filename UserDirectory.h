@@ -0,0 +1,75 @@
+#ifndef USER_DIRECTORY_H
+#define USER_DIRECTORY_H
+
+#include "User.h"
+#include "FlatStringIndex.h"
+#include <deque>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// The one store of user accounts, shared by AuthenticationService (social
+// side) and MessengerManager. Each user is a single User record: the
+// social username doubles as the messenger user ID, and a display name is
+// kept only when it differs from the username. Records are kept in ID
+// order, so lookups by ID are a binary search. The only index is
+// username -> position in the records, a FlatStringIndex that reads the
+// usernames from the records themselves.
+//
+// users.txt is loaded once and new users are appended to it; a messenger
+// users.csv from before the merge is imported on first start and renamed
+// to users.csv.imported.
+class UserDirectory {
+private:
+    // Username of the record at a position, for the index
+    struct UsernameAt {
+        const std::deque<User>* users;
+        std::string_view operator()(std::uint32_t position) const {
+            return (*users)[position].getUsernameView();
+        }
+    };
+
+    std::deque<User> users;                                  // ascending IDs; never moved
+    FlatStringIndex<UsernameAt> positionByName;
+
+    int nextUserId = 1;
+
+    std::string path;
+
+    void load();
+    void importMessengerUsers(const std::string& csvPath);
+    void appendToFile(const User& user) const;
+    void saveAll() const;
+
+public:
+    static const std::string USERS_FILE;
+    static const std::string MESSENGER_USERS_FILE;
+
+    explicit UserDirectory(const std::string& file = USERS_FILE,
+                           const std::string& legacyMessengerFile = MESSENGER_USERS_FILE);
+
+    UserDirectory(const UserDirectory&) = delete;
+    UserDirectory& operator=(const UserDirectory&) = delete;
+
+    // Returns nullptr if the username is taken or unusable (empty, or with
+    // whitespace). An empty password means the account can only be used
+    // from the messenger.
+    User* addUser(const std::string& username, const std::string& password,
+                  const std::string& displayName = "");
+
+    User*       findById(int id);
+    const User* findById(int id) const;
+
+    User*       findByName(std::string_view username);
+    const User* findByName(std::string_view username) const;
+
+    bool setDisplayName(int id, const std::string& displayName);
+
+    std::size_t size() const;
+
+    std::deque<User>&       getUsers();
+    const std::deque<User>& getUsers() const;
+};
+
+#endif // USER_DIRECTORY_H
@@ -0,0 +1,175 @@
+// Heap allocation count for render and save loops.
+//
+// Walks a set of conversations, group chats and posts the way the UI and
+// the save paths do, once through the by-value getters and once through
+// the non-owning view accessors, and reports how many times operator new
+// was called for each pass. Output goes to a discarding stream so only
+// the accessors themselves are measured.
+//
+//   alloc_count_bench [conversations] [messages_per_conversation]
+
+#include "messenger_system.h"
+#include "Post.h"
+#include "User.h"
+#include "Comment.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<long long> allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace std;
+
+namespace {
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct Fixture {
+    vector<shared_ptr<Conversation>> conversations;
+    vector<shared_ptr<GroupChat>> groups;
+    deque<User> users;
+    vector<unique_ptr<Post>> posts;
+};
+
+void build(Fixture& f, int conversations, int messagesPer) {
+    const string body = "See you at the library after the lecture, bring the notes";
+    for (int c = 0; c < conversations; ++c) {
+        string a = "student_" + to_string(2 * c);
+        string b = "student_" + to_string(2 * c + 1);
+        auto conv = make_shared<Conversation>("conv_" + to_string(c), a, b);
+        auto group = make_shared<GroupChat>("group_" + to_string(c), "Study group " + to_string(c), a);
+        group->addParticipant(b, a);
+        for (int m = 0; m < messagesPer; ++m) {
+            const string& sender = (m % 2) ? b : a;
+            string id = "msg_" + to_string(c) + "_" + to_string(m);
+            conv->addMessage(make_shared<Message>(id, sender, body));
+            group->addMessage(make_shared<Message>(id, sender, body));
+        }
+        f.conversations.push_back(conv);
+        f.groups.push_back(group);
+    }
+
+    for (int u = 0; u < conversations; ++u) {
+        f.users.emplace_back(u + 1, "member_with_long_name_" + to_string(u + 1), "password");
+    }
+    for (int p = 0; p < conversations; ++p) {
+        User* author = &f.users[p];
+        f.posts.push_back(make_unique<Post>(p + 1, author, body, 500, "Announcements and events"));
+        for (int m = 0; m < messagesPer; ++m) {
+            f.posts.back()->addComment(&f.users[(p + m) % f.users.size()], body);
+        }
+    }
+}
+
+void renderByValue(const Fixture& f, ostream& out) {
+    for (const auto& conv : f.conversations) {
+        auto participants = conv->getParticipantIds();
+        for (const auto& msg : conv->getMessages()) {
+            out << participants[0] << participants[1]
+                << msg->getSenderId() << msg->getContent()
+                << msg->toCSV();
+        }
+    }
+    for (const auto& group : f.groups) {
+        auto participants = group->getParticipantIds();
+        for (const auto& msg : group->getMessages()) {
+            out << participants.size() << msg->getSenderId() << msg->getContent();
+        }
+    }
+    for (const auto& post : f.posts) {
+        out << post->getAuthor()->getUsername() << post->getCategory() << post->getText();
+        const auto& comments = post->getComments();
+        for (size_t i = 0; i < comments.size(); ++i) {
+            out << comments[i]->getAuthor()->getUsername() << comments[i]->getText();
+        }
+    }
+}
+
+void renderByView(const Fixture& f, ostream& out) {
+    for (const auto& conv : f.conversations) {
+        const auto& participants = conv->getParticipantIdsView();
+        for (const auto& msg : conv->getMessagesView()) {
+            out << participants[0] << participants[1] << msg->getSenderIdView();
+            msg->writeContent(out);
+            msg->writeCSV(out);
+        }
+    }
+    for (const auto& group : f.groups) {
+        const auto& participants = group->getParticipantIdsView();
+        for (const auto& msg : group->getMessagesView()) {
+            out << participants.size() << msg->getSenderIdView();
+            msg->writeContent(out);
+        }
+    }
+    for (const auto& post : f.posts) {
+        out << post->getAuthor()->getUsernameView() << post->getCategoryView() << post->getTextView();
+        const auto& comments = post->getComments();
+        for (size_t i = 0; i < comments.size(); ++i) {
+            out << comments[i]->getAuthor()->getUsernameView() << comments[i]->getTextView();
+        }
+    }
+}
+
+template <typename Fn>
+void measure(const char* label, Fn&& pass, long long rows) {
+    long long before = allocations.load();
+    auto start = chrono::steady_clock::now();
+    pass();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    long long count = allocations.load() - before;
+
+    cout << left << setw(10) << label
+         << right << setw(12) << count << " allocs"
+         << setw(10) << fixed << setprecision(2) << (double)count / rows << " /row"
+         << setw(10) << setprecision(1) << ms << " ms\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int conversations = argc > 1 ? atoi(argv[1]) : 1000;
+    int messagesPer   = argc > 2 ? atoi(argv[2]) : 50;
+    if (conversations < 1 || messagesPer < 1) {
+        cerr << "usage: alloc_count_bench [conversations] [messages_per_conversation]\n";
+        return 1;
+    }
+
+    // Keep the fixture's constructor chatter out of the report
+    NullBuffer nullBuffer;
+    streambuf* saved = cout.rdbuf(&nullBuffer);
+    Fixture fixture;
+    build(fixture, conversations, messagesPer);
+    cout.rdbuf(saved);
+
+    ostream sink(&nullBuffer);
+    long long rows = 3LL * conversations * messagesPer;
+
+    cout << conversations << " conversations/groups/posts x " << messagesPer << " messages/comments\n";
+    measure("by-value", [&] { renderByValue(fixture, sink); }, rows);
+    measure("views",    [&] { renderByView(fixture, sink); }, rows);
+    return 0;
+}
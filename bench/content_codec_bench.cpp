@@ -0,0 +1,213 @@
+// Message content compression: memory saved and throughput paid.
+//
+// A synthetic chat corpus (Zipf-distributed words from a chat vocabulary,
+// names, numbers and punctuation) is generated and then:
+//
+//   symbol table   trained on the first 16 KiB, as MessengerManager does;
+//                  every message encoded on its own (what stays in memory),
+//                  then decoded in full and one random message at a time
+//   messages       Message::memoryBytes() for the corpus held plain and
+//                  compressed, i.e. the RAM the history budget is charged
+//   blocks         the CSV lines cut into 64 KiB blocks and compressed with
+//                  BlockCodec, as cold segments on disk would be
+//
+// Every encoded message and block is decoded and compared with its input.
+//
+//   content_codec_bench [messages]       (default: 200000)
+
+#include "TextCodec.h"
+#include "messenger_system.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const size_t BLOCK_BYTES = 64 * 1024;
+
+using Clock = chrono::steady_clock;
+
+const vector<string> WORDS = {
+    "the", "i", "you", "to", "a", "and", "is", "it", "in", "for", "of", "at", "we", "on", "that", "do",
+    "are", "be", "have", "me", "so", "can", "this", "what", "just", "but", "not", "with", "lecture",
+    "tomorrow", "today", "library", "notes", "assignment", "deadline", "exam", "project", "class",
+    "meeting", "lab", "professor", "group", "thanks", "okay", "yeah", "sure", "please", "sorry",
+    "see", "you", "there", "later", "morning", "evening", "coffee", "lunch", "room", "building",
+    "submit", "report", "slides", "chapter", "question", "answer", "grade", "quiz", "homework",
+    "send", "share", "check", "know", "think", "need", "want", "going", "will", "did", "does",
+    "about", "after", "before", "when", "where", "why", "how", "who", "maybe", "really", "also",
+};
+
+const vector<string> NAMES = {"Ayesha", "Bilal", "Sara", "Hamza", "Zainab", "Omar", "Fatima", "Ali"};
+
+vector<string> corpus(size_t count) {
+    mt19937 rng(42);
+    // Zipf: weight of the k-th word is 1 / (k + 1)
+    vector<double> weights;
+    for (size_t k = 0; k < WORDS.size(); ++k) weights.push_back(1.0 / static_cast<double>(k + 1));
+    discrete_distribution<size_t> word(weights.begin(), weights.end());
+    uniform_int_distribution<int> length(3, 24), pick(0, 99);
+
+    vector<string> messages;
+    messages.reserve(count);
+    for (size_t m = 0; m < count; ++m) {
+        string text;
+        int words = length(rng);
+        for (int w = 0; w < words; ++w) {
+            if (w) text += ' ';
+            int p = pick(rng);
+            if (p < 4) {
+                text += NAMES[static_cast<size_t>(p) % NAMES.size()];
+            } else if (p < 7) {
+                text += to_string(rng() % 1000);
+            } else {
+                text += WORDS[word(rng)];
+            }
+        }
+        text += pick(rng) < 30 ? "?" : pick(rng) < 50 ? "!" : ".";
+        text[0] = static_cast<char>(toupper(static_cast<unsigned char>(text[0])));
+        messages.push_back(std::move(text));
+    }
+    return messages;
+}
+
+double mbPerSecond(size_t bytes, Clock::duration elapsed) {
+    return static_cast<double>(bytes) / (1 << 20) / chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 200000;
+    if (argc > 1) {
+        long long n = atoll(argv[1]);
+        if (n < 1) {
+            cerr << "usage: content_codec_bench [messages]\n";
+            return 1;
+        }
+        count = static_cast<size_t>(n);
+    }
+
+    vector<string> texts = corpus(count);
+    size_t plainBytes = 0;
+    for (const string& t : texts) plainBytes += t.size();
+    bool ok = true;
+
+    // ─── Symbol table ───
+    auto t0 = Clock::now();
+    auto table = make_shared<SymbolTable>(SymbolTable::train(texts));
+    auto trainTime = Clock::now() - t0;
+
+    vector<string> encoded(texts.size());
+    t0 = Clock::now();
+    for (size_t i = 0; i < texts.size(); ++i) table->encode(texts[i], encoded[i]);
+    auto encodeTime = Clock::now() - t0;
+    size_t encodedBytes = 0;
+    for (const string& e : encoded) encodedBytes += e.size();
+
+    string decoded;
+    t0 = Clock::now();
+    for (const string& e : encoded) {
+        decoded.clear();
+        table->decodeAppend(e, decoded);
+    }
+    auto decodeTime = Clock::now() - t0;
+    for (size_t i = 0; i < texts.size(); ++i) ok = ok && table->decode(encoded[i]) == texts[i];
+
+    mt19937 rng(7);
+    uniform_int_distribution<size_t> any(0, texts.size() - 1);
+    const size_t PROBES = 100000;
+    size_t sink = 0;
+    t0 = Clock::now();
+    for (size_t p = 0; p < PROBES; ++p) sink += table->decode(encoded[any(rng)]).size();
+    double randomNs = chrono::duration<double, nano>(Clock::now() - t0).count() / PROBES;
+
+    cout << fixed << setprecision(1);
+    cout << "corpus: " << count << " messages, " << static_cast<double>(plainBytes) / (1 << 20) << " MiB of text\n\n";
+    cout << "symbol table (" << table->size() << " symbols, trained in "
+         << chrono::duration<double, milli>(trainTime).count() << " ms)\n";
+    cout << "  text bytes      " << setw(10) << plainBytes << " -> " << setw(10) << encodedBytes
+         << "   ratio " << setprecision(2) << static_cast<double>(plainBytes) / static_cast<double>(encodedBytes) << "\n"
+         << setprecision(1);
+    cout << "  encode          " << setw(10) << mbPerSecond(plainBytes, encodeTime) << " MiB/s\n";
+    cout << "  decode          " << setw(10) << mbPerSecond(plainBytes, decodeTime) << " MiB/s\n";
+    cout << "  one message     " << setw(10) << randomNs << " ns (random, decoded to a string)\n\n";
+
+    // ─── Messages in memory ───
+    size_t plainMemory = 0, compressedMemory = 0, compressedCount = 0;
+    {
+        vector<Message> messages;
+        messages.reserve(texts.size());
+        for (size_t i = 0; i < texts.size(); ++i) {
+            messages.emplace_back("msg_" + to_string(i + 1) + "_1792382202", "student_" + to_string(i % 2000), texts[i]);
+            plainMemory += messages.back().memoryBytes();
+        }
+        for (Message& msg : messages) {
+            msg.compressContent(table.get());
+            compressedMemory += msg.memoryBytes();
+            compressedCount += msg.isContentCompressed();
+            ok = ok && msg.getContent() == texts[&msg - messages.data()];
+        }
+    }
+    cout << "messages (Message::memoryBytes)\n";
+    cout << "  plain           " << setw(10) << static_cast<double>(plainMemory) / (1 << 20) << " MiB\n";
+    cout << "  compressed      " << setw(10) << static_cast<double>(compressedMemory) / (1 << 20) << " MiB  ("
+         << compressedCount * 100 / texts.size() << "% of messages encoded, the rest shorter plain)\n\n";
+
+    // ─── Cold blocks ───
+    vector<string> blocks(1);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        Message msg("msg_" + to_string(i + 1) + "_1792382202", "student_" + to_string(i % 2000), texts[i]);
+        blocks.back() += "conv_student_" + to_string(i % 1000) + ",student_" + to_string(i % 1000) +
+                         ",student_" + to_string(i % 1000 + 1000) + "," + msg.toCSV() + "\n";
+        if (blocks.back().size() >= BLOCK_BYTES) blocks.emplace_back();
+    }
+    size_t csvBytes = 0, blockBytes = 0;
+    vector<string> packed;
+    t0 = Clock::now();
+    for (const string& block : blocks) packed.push_back(BlockCodec::compress(block));
+    auto packTime = Clock::now() - t0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        csvBytes += blocks[i].size();
+        blockBytes += packed[i].size();
+    }
+    string unpacked;
+    t0 = Clock::now();
+    for (const string& block : packed) ok = BlockCodec::decompress(block, unpacked) && ok;
+    auto unpackTime = Clock::now() - t0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        ok = ok && BlockCodec::decompress(packed[i], unpacked) && unpacked == blocks[i];
+    }
+
+    cout << "blocks (" << blocks.size() << " x 64 KiB of CSV)\n";
+    cout << "  csv bytes       " << setw(10) << csvBytes << " -> " << setw(10) << blockBytes
+         << "   ratio " << setprecision(2) << static_cast<double>(csvBytes) / static_cast<double>(blockBytes) << "\n"
+         << setprecision(1);
+    cout << "  compress        " << setw(10) << mbPerSecond(csvBytes, packTime) << " MiB/s\n";
+    cout << "  decompress      " << setw(10) << mbPerSecond(csvBytes, unpackTime) << " MiB/s\n";
+
+    // Edge cases: empty text, every byte value, text with no symbol
+    string allBytes;
+    for (int b = 0; b < 256; ++b) allBytes.push_back(static_cast<char>(b));
+    for (const string& edge : {string(), allBytes, string(5000, 'z'), string("a")}) {
+        string e;
+        table->encode(edge, e);
+        ok = ok && table->decode(e) == edge;
+        ok = ok && BlockCodec::decompress(BlockCodec::compress(edge), unpacked) && unpacked == edge;
+    }
+
+    if (!ok) {
+        cerr << "round trip FAILED\n";
+        return 1;
+    }
+    cout << "\nround trip ok\n";
+    return sink > 0 ? 0 : 1;
+}
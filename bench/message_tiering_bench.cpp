@@ -0,0 +1,212 @@
+// Hot/cold message tiering: memory against history, and page reads per tier.
+//
+// For each total message count a conversations.csv is written to a scratch
+// directory (1000 conversations, messages spread evenly). All but the last
+// RECENT messages of every chat are a year old. Each row runs in a fresh
+// child process:
+//
+//   untiered     every chat opened with no history budget before archiving,
+//                i.e. all-time history in memory
+//   archive      archiveOldMessages(): old messages written to cold segments
+//   tiered       every chat opened again, only the recent tail is loaded
+//   page recent  getMessagePage() of PAGE messages at the newest end, which
+//                spans the recent tail and the newest archived block
+//   page oldest  getMessagePage() of PAGE messages at offset 0 (cold only)
+//
+// Memory is resident set growth from /proc/self/statm; page rows report the
+// mean per call over every chat.
+//
+//   message_tiering_bench [messages ...]    (default: 100000 1000000)
+
+#include "messenger_manager.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const int CHATS = 1000;
+const int RECENT = 10;
+const int PAGE = 20;
+
+using Clock = chrono::steady_clock;
+
+struct Sample {
+    double ms = 0;
+    double rssMiB = 0;
+};
+
+double residentMiB() {
+    ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+string user(int i) {
+    return "student_" + to_string(i);
+}
+
+void writeHistory(size_t messages) {
+    for (const char* base : {"conversations.csv", "groups.csv"}) {
+        for (const char* suffix : {"", ".idx", ".sym", ".retention", ".cold"}) {
+            filesystem::remove_all(string(base) + suffix);
+        }
+    }
+
+    ofstream out("conversations.csv");
+    out << "conversationId,participant1,participant2,messageData\n";
+    const string body = "See you at the library after the lecture and bring the notes";
+    const size_t perChat = messages / CHATS;
+    const time_t now = time(nullptr);
+    const time_t yearAgo = now - 365 * 24 * 3600;
+    for (size_t m = 0; m < messages; ++m) {
+        int chat = static_cast<int>(m % CHATS);
+        size_t nth = m / CHATS;
+        string a = user(2 * chat), b = user(2 * chat + 1);
+        time_t stamp = nth + RECENT >= perChat ? now : yearAgo;
+        out << "conv_" << a << "_" << b << "," << a << "," << b << ",msg_" << m + 1 << "_" << stamp << ","
+            << (nth % 2 ? b : a) << "," << body << "," << stamp << ",0,\n";
+    }
+}
+
+// Runs fn in a child process and returns what it measured
+template <typename Fn>
+Sample isolated(Fn fn) {
+    int fds[2];
+    Sample sample;
+    if (pipe(fds) != 0) return sample;
+    cout.flush();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        cout.rdbuf(nullptr);    // the manager's "Loaded N ..." lines
+        Sample s = fn();
+        ssize_t written = write(fds[1], &s, sizeof(s));
+        _exit(written == static_cast<ssize_t>(sizeof(s)) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &sample, sizeof(sample)) != static_cast<ssize_t>(sizeof(sample))) sample = Sample();
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return sample;
+}
+
+Sample openAll() {
+    double before = residentMiB();
+    UserDirectory directory;
+    MessengerManager messenger(directory, "conversations.csv", "groups.csv", SIZE_MAX);
+    auto t0 = Clock::now();
+    for (int chat = 0; chat < CHATS; ++chat) messenger.getConversation(user(2 * chat), user(2 * chat + 1));
+    Sample s;
+    s.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    s.rssMiB = residentMiB() - before;
+    return s;
+}
+
+Sample archive() {
+    UserDirectory directory;
+    MessengerManager messenger(directory);
+    double before = residentMiB();
+    auto t0 = Clock::now();
+    messenger.archiveOldMessages();
+    Sample s;
+    s.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    s.rssMiB = residentMiB() - before;
+    return s;
+}
+
+Sample page(bool oldest) {
+    UserDirectory directory;
+    MessengerManager messenger(directory);
+    size_t read = 0;
+    Clock::duration elapsed{};
+    for (int chat = 0; chat < CHATS; ++chat) {
+        string a = user(2 * chat), b = user(2 * chat + 1);
+        messenger.registerUser(a, a);
+        if (!messenger.login(a)) continue;
+        auto conv = messenger.getConversation(a, b);
+        int offset = oldest || !conv ? 0 : max(0, conv->getMessageCount() - PAGE);
+
+        auto t0 = Clock::now();
+        read += messenger.getMessagePage("conv_" + a + "_" + b, false, offset, PAGE).size();
+        elapsed += Clock::now() - t0;
+        messenger.logout();
+    }
+    Sample s;
+    s.ms = chrono::duration<double, milli>(elapsed).count() / CHATS;
+    s.rssMiB = read == static_cast<size_t>(CHATS) * PAGE ? 0 : -1;    // -1 flags short pages
+    return s;
+}
+
+void row(size_t messages, const char* what, const Sample& s, bool memory = true) {
+    cout << setw(9) << messages << "  " << left << setw(12) << what << right << fixed
+         << setprecision(3) << setw(12) << s.ms << setprecision(1);
+    if (memory) cout << setw(10) << s.rssMiB;
+    else if (s.rssMiB < 0) cout << setw(10) << "SHORT";
+    cout << "\n";
+}
+
+double diskMiB(const filesystem::path& path) {
+    uintmax_t bytes = 0;
+    if (filesystem::is_directory(path)) {
+        for (const auto& entry : filesystem::directory_iterator(path)) bytes += entry.file_size();
+    } else if (filesystem::exists(path)) {
+        bytes = filesystem::file_size(path);
+    }
+    return static_cast<double>(bytes) / (1 << 20);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        long long n = atoll(argv[i]);
+        if (n < CHATS * (RECENT + PAGE)) {
+            cerr << "usage: message_tiering_bench [messages ...]   (at least " << CHATS * (RECENT + PAGE) << " each)\n";
+            return 1;
+        }
+        sizes.push_back(static_cast<size_t>(n));
+    }
+    if (sizes.empty()) sizes = {100000, 1000000};
+
+    filesystem::path scratch = filesystem::temp_directory_path() / ("message_tiering_bench_" + to_string(getpid()));
+    filesystem::create_directories(scratch);
+    filesystem::path home = filesystem::current_path();
+    filesystem::current_path(scratch);
+
+    cout << setw(9) << "messages" << "  " << left << setw(12) << "step" << right
+         << setw(12) << "ms" << setw(10) << "RSS MiB" << "\n";
+    for (size_t n : sizes) {
+        writeHistory(n);
+        double csvBefore = diskMiB("conversations.csv");
+        row(n, "untiered", isolated(openAll));
+        row(n, "archive", isolated(archive));
+        row(n, "tiered", isolated(openAll));
+        row(n, "page recent", isolated([] { return page(false); }), false);
+        row(n, "page oldest", isolated([] { return page(true); }), false);
+        cout << fixed << setprecision(1) << "           disk: csv " << csvBefore << " MiB -> hot csv "
+             << diskMiB("conversations.csv") << " MiB + cold segments " << diskMiB("conversations.csv.cold")
+             << " MiB\n\n";
+    }
+
+    filesystem::current_path(home);
+    filesystem::remove_all(scratch);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Messenger startup against history size.
+//
+// For each total message count a conversations.csv in the old format is
+// written to a scratch directory (1000 conversations, messages spread
+// evenly), and MessengerManager is started on it in a fresh child process
+// each time, so every row starts from an empty heap:
+//
+//   migrate      first start: no directory checkpoint yet, the CSV is scanned
+//   start        later starts: the checkpoint is read, no messages are
+//   open one     getConversation on one chat (its history is read)
+//   open all     every chat opened in turn under the default budget
+//   unbounded    the same with no budget, i.e. every history in memory,
+//                which is what every start used to cost
+//
+// Memory is resident set growth from /proc/self/statm.
+//
+//   messenger_history_bench [messages ...]    (default: 10000 100000 1000000)
+
+#include "messenger_manager.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const int CHATS = 1000;
+
+using Clock = chrono::steady_clock;
+
+struct Sample {
+    double ms = 0;
+    double rssMiB = 0;
+};
+
+double residentMiB() {
+    ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+string user(int i) {
+    return "student_" + to_string(i);
+}
+
+void writeHistory(size_t messages) {
+    filesystem::remove("conversations.csv");
+    filesystem::remove("conversations.csv.idx");
+    filesystem::remove("groups.csv");
+    filesystem::remove("groups.csv.idx");
+
+    ofstream out("conversations.csv");
+    out << "conversationId,participant1,participant2,messageData\n";
+    const string body = "See you at the library after the lecture, bring the notes";
+    for (size_t m = 0; m < messages; ++m) {
+        int chat = static_cast<int>(m % CHATS);
+        string a = user(2 * chat), b = user(2 * chat + 1);
+        out << "conv_" << a << "_" << b << "," << a << "," << b << ",msg_" << m + 1 << "_100,"
+            << ((m / CHATS) % 2 ? b : a) << "," << body << ",100,0,\n";
+    }
+}
+
+// Runs fn in a child process and returns what it measured
+template <typename Fn>
+Sample isolated(Fn fn) {
+    int fds[2];
+    Sample sample;
+    if (pipe(fds) != 0) return sample;
+    cout.flush();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        cout.rdbuf(nullptr);    // the manager's "Loaded N ..." lines
+        Sample s = fn();
+        ssize_t written = write(fds[1], &s, sizeof(s));
+        _exit(written == static_cast<ssize_t>(sizeof(s)) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &sample, sizeof(sample)) != static_cast<ssize_t>(sizeof(sample))) sample = Sample();
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return sample;
+}
+
+Sample start() {
+    double before = residentMiB();
+    auto t0 = Clock::now();
+    UserDirectory directory;
+    MessengerManager messenger(directory);
+    Sample s;
+    s.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    s.rssMiB = residentMiB() - before;
+    return s;
+}
+
+Sample openOne() {
+    UserDirectory directory;
+    MessengerManager messenger(directory);
+    double before = residentMiB();
+    auto t0 = Clock::now();
+    messenger.getConversation(user(CHATS), user(CHATS + 1));
+    Sample s;
+    s.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    s.rssMiB = residentMiB() - before;
+    return s;
+}
+
+Sample openAll(size_t budget) {
+    double before = residentMiB();
+    UserDirectory directory;
+    MessengerManager messenger(directory, "conversations.csv", "groups.csv", budget);
+    auto t0 = Clock::now();
+    for (int chat = 0; chat < CHATS; ++chat) messenger.getConversation(user(2 * chat), user(2 * chat + 1));
+    Sample s;
+    s.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    s.rssMiB = residentMiB() - before;
+    return s;
+}
+
+void row(size_t messages, const char* what, const Sample& s) {
+    cout << setw(9) << messages << "  " << left << setw(12) << what << right << fixed
+         << setprecision(2) << setw(12) << s.ms << setprecision(1) << setw(10) << s.rssMiB << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        long long n = atoll(argv[i]);
+        if (n < CHATS) {
+            cerr << "usage: messenger_history_bench [messages ...]   (at least " << CHATS << " each)\n";
+            return 1;
+        }
+        sizes.push_back(static_cast<size_t>(n));
+    }
+    if (sizes.empty()) sizes = {10000, 100000, 1000000};
+
+    filesystem::path scratch = filesystem::temp_directory_path() / ("messenger_history_bench_" + to_string(getpid()));
+    filesystem::create_directories(scratch);
+    filesystem::path home = filesystem::current_path();
+    filesystem::current_path(scratch);
+
+    cout << setw(9) << "messages" << "  " << left << setw(12) << "step" << right
+         << setw(12) << "ms" << setw(10) << "RSS MiB" << "\n";
+    for (size_t n : sizes) {
+        writeHistory(n);
+        row(n, "migrate", isolated(start));
+        row(n, "start", isolated(start));
+        row(n, "open one", isolated(openOne));
+        row(n, "open all", isolated([] { return openAll(MessengerManager::DEFAULT_HISTORY_BUDGET); }));
+        row(n, "unbounded", isolated([] { return openAll(SIZE_MAX); }));
+        cout << "\n";
+    }
+
+    filesystem::current_path(home);
+    filesystem::remove_all(scratch);
+    return 0;
+}
@@ -0,0 +1,405 @@
+// Load generator for `messenger --serve`: connections, message rate and
+// push delivery latency on one machine.
+//
+// Without --socket or --port a MessengerServer is started in a child
+// process, on a Unix socket in a scratch directory. Then every client
+// connection is opened from one epoll loop. Client i registers and logs in
+// as loadgen_<i>, subscribes, and keeps WINDOW messages in flight to
+// loadgen_<i+1>. Each message carries its send time (steady_clock, shared
+// by every process on the machine), so the recipient's PUSH gives the
+// delivery latency sender -> server -> recipient.
+//
+//   connect    time to connect, register, log in and subscribe every client
+//   sent       messages acknowledged per second over the run, and the
+//              send -> OK latency
+//   pushed     pushes received per second, and the send -> PUSH latency
+//
+//   messenger_load_bench [--socket path | --port n] [--connections n]
+//                        [--seconds s] [--window n]
+//   (defaults: own server, 1000 connections, 5 seconds, window 1)
+
+#include "messenger_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+const string PASSWORD = "loadgen-password";
+
+struct Options {
+    string socketPath;
+    int port = 0;
+    int connections = 1000;
+    double seconds = 5;
+    int window = 1;
+};
+
+struct Client {
+    int fd = -1;
+    string in;
+    string out;
+    size_t outSent = 0;
+    bool queued = false;
+    int setupReplies = 0;            // REGISTER, LOGIN, SUBSCRIBE
+    bool loggedIn = false;
+    string peerId;
+    deque<int64_t> sendTimes;        // of messages awaiting their OK
+};
+
+struct Totals {
+    size_t acked = 0;
+    size_t errors = 0;
+    size_t pushes = 0;
+    vector<double> ackMs;
+    vector<double> pushMs;
+};
+
+int64_t nowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+string user(int i) {
+    return "loadgen_" + to_string(i);
+}
+
+int connectTo(const Options& options) {
+    int fd = -1;
+    if (options.port) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    } else {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+    }
+    if (fd >= 0) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+class LoadClient {
+private:
+    const Options& options;
+    int epollFd;
+    vector<Client> clients;
+    vector<Client*> pendingWrites;
+    Totals totals;
+    bool sending = false;
+    size_t ready = 0;
+
+    void request(Client& c, wire::FrameType type, const vector<string>& fields) {
+        size_t start = wire::beginFrame(c.out, type);
+        for (const string& field : fields) recordio::putString(c.out, field);
+        wire::endFrame(c.out, start);
+        if (!c.queued) {
+            c.queued = true;
+            pendingWrites.push_back(&c);
+        }
+    }
+
+    void sendOne(Client& c) {
+        int64_t sent = nowNs();
+        c.sendTimes.push_back(sent);
+        request(c, wire::FrameType::SEND, {c.peerId, "lg " + to_string(sent) + " see you at the library"});
+    }
+
+    bool onFrame(Client& c, wire::FrameType type, recordio::RecordReader& in) {
+        int64_t now = nowNs();
+        if (type == wire::FrameType::PUSH) {
+            in.str();                // chat
+            in.i32();
+            in.str();                // message ID
+            in.str();                // sender
+            string text = in.str();
+            if (text.compare(0, 3, "lg ") == 0) {
+                totals.pushMs.push_back(static_cast<double>(now - atoll(text.c_str() + 3)) / 1e6);
+            }
+            ++totals.pushes;
+            return in.good();
+        }
+
+        bool ok = type == wire::FrameType::OK;
+        if (c.setupReplies < 3) {
+            // REGISTER fails harmlessly when the user is left from an earlier run
+            if (++c.setupReplies == 2) c.loggedIn = ok;
+            if (c.setupReplies == 3) ++ready;
+            return true;
+        }
+        if (!c.sendTimes.empty()) {
+            totals.ackMs.push_back(static_cast<double>(now - c.sendTimes.front()) / 1e6);
+            c.sendTimes.pop_front();
+        }
+        if (ok) ++totals.acked;
+        else ++totals.errors;
+        if (sending) sendOne(c);
+        return true;
+    }
+
+    void readFrom(Client& c) {
+        char buffer[64 * 1024];
+        while (true) {
+            ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                c.in.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            break;
+        }
+        size_t used = wire::forEachFrame(c.in.data(), c.in.size(),
+                                         [&](wire::FrameType type, recordio::RecordReader& payload) {
+                                             return onFrame(c, type, payload);
+                                         });
+        if (used != SIZE_MAX) c.in.erase(0, used);
+    }
+
+    void flushPending() {
+        for (Client* c : pendingWrites) {
+            c->queued = false;
+            while (c->outSent < c->out.size()) {
+                ssize_t n = send(c->fd, c->out.data() + c->outSent, c->out.size() - c->outSent, MSG_NOSIGNAL);
+                if (n <= 0) break;
+                c->outSent += static_cast<size_t>(n);
+            }
+            if (c->outSent == c->out.size()) {
+                c->out.clear();
+                c->outSent = 0;
+            }
+        }
+        pendingWrites.clear();
+    }
+
+    // One round of the event loop; waits at most timeoutMs
+    void poll(int timeoutMs) {
+        epoll_event events[256];
+        int n = epoll_wait(epollFd, events, 256, timeoutMs);
+        for (int i = 0; i < n; ++i) {
+            Client& c = *static_cast<Client*>(events[i].data.ptr);
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readFrom(c);
+            if ((events[i].events & EPOLLOUT) && c.outSent < c.out.size() && !c.queued) {
+                c.queued = true;
+                pendingWrites.push_back(&c);
+            }
+        }
+        flushPending();
+    }
+
+    size_t inFlight() const {
+        size_t n = 0;
+        for (const Client& c : clients) n += c.sendTimes.size();
+        return n;
+    }
+
+public:
+    explicit LoadClient(const Options& opts) : options(opts), epollFd(epoll_create1(EPOLL_CLOEXEC)) {}
+
+    ~LoadClient() {
+        for (Client& c : clients) {
+            if (c.fd >= 0) ::close(c.fd);
+        }
+        ::close(epollFd);
+    }
+
+    // Connects, registers, logs in and subscribes every client
+    bool connectAll() {
+        clients.resize(static_cast<size_t>(options.connections));
+        for (int i = 0; i < options.connections; ++i) {
+            Client& c = clients[static_cast<size_t>(i)];
+            c.fd = connectTo(options);
+            if (c.fd < 0) {
+                cerr << "connection " << i << " failed: " << strerror(errno) << "\n";
+                return false;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            event.data.ptr = &c;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &event);
+
+            c.peerId = user((i + 1) % options.connections);
+            request(c, wire::FrameType::REGISTER, {user(i), "Load Generator " + to_string(i), PASSWORD});
+            request(c, wire::FrameType::LOGIN, {user(i), PASSWORD});
+            request(c, wire::FrameType::SUBSCRIBE, {});
+            if (i % 64 == 63) poll(0);
+        }
+
+        auto deadline = Clock::now() + chrono::seconds(30);
+        while (ready < clients.size() && Clock::now() < deadline) poll(100);
+        for (const Client& c : clients) {
+            if (!c.loggedIn) {
+                cerr << "a client could not log in\n";
+                return false;
+            }
+        }
+        return ready == clients.size();
+    }
+
+    // Sends for the given time, then waits for messages still in flight
+    double run(double seconds) {
+        sending = true;
+        auto start = Clock::now();
+        for (Client& c : clients) {
+            for (int w = 0; w < options.window; ++w) sendOne(c);
+        }
+        flushPending();
+
+        auto end = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+        while (Clock::now() < end) poll(10);
+        sending = false;
+        double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+        auto grace = Clock::now() + chrono::seconds(5);
+        while ((inFlight() > 0 || totals.pushes < totals.acked) && Clock::now() < grace) poll(10);
+        return elapsed;
+    }
+
+    Totals& getTotals() { return totals; }
+};
+
+double percentile(vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    size_t k = min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+    nth_element(values.begin(), values.begin() + static_cast<long>(k), values.end());
+    return values[k];
+}
+
+void latencyRow(const char* what, size_t count, double seconds, vector<double>& ms) {
+    double p50 = percentile(ms, 0.50), p99 = percentile(ms, 0.99);
+    double worst = ms.empty() ? 0 : *max_element(ms.begin(), ms.end());
+    cout << "  " << left << setw(8) << what << right << setw(10) << count << "  " << setw(10)
+         << static_cast<double>(count) / seconds << "/s   p50 " << setw(7) << p50 << " ms   p99 " << setw(7)
+         << p99 << " ms   max " << setw(7) << worst << " ms\n";
+}
+
+double residentMiB(pid_t pid) {
+    ifstream statm("/proc/" + to_string(pid) + "/statm");
+    long long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+// Starts a server in a child process; returns its pid, or -1
+pid_t startServer(const string& socketPath) {
+    cout.flush();
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    cout.rdbuf(nullptr);             // the manager's "Loaded N ..." lines
+    signal(SIGTERM, [](int) { MessengerServer::requestStop(); });
+    {
+        UserDirectory directory;
+        MessengerManager messenger(directory);
+        AuthenticationService auth(directory);
+        MessengerServer server(messenger, auth);
+        if (server.listenUnix(socketPath)) server.run();
+    }
+    _exit(0);
+}
+
+bool parse(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        string flag = argv[i];
+        if (i + 1 >= argc) return false;
+        string value = argv[++i];
+        if (flag == "--socket") options.socketPath = value;
+        else if (flag == "--port") options.port = atoi(value.c_str());
+        else if (flag == "--connections") options.connections = atoi(value.c_str());
+        else if (flag == "--seconds") options.seconds = atof(value.c_str());
+        else if (flag == "--window") options.window = atoi(value.c_str());
+        else return false;
+    }
+    return options.connections >= 2 && options.seconds > 0 && options.window >= 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        cerr << "usage: messenger_load_bench [--socket path | --port n] [--connections n] [--seconds s] [--window n]\n";
+        return 1;
+    }
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    filesystem::path scratch, home = filesystem::current_path();
+    pid_t server = -1;
+    if (options.socketPath.empty() && !options.port) {
+        scratch = filesystem::temp_directory_path() / ("messenger_load_bench_" + to_string(getpid()));
+        filesystem::create_directories(scratch);
+        filesystem::current_path(scratch);
+        options.socketPath = (scratch / "messenger.sock").string();
+        server = startServer(options.socketPath);
+        if (server < 0) return 1;
+        for (int tries = 0; tries < 500 && !filesystem::exists(options.socketPath); ++tries) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+
+    int status = 0;
+    {
+        LoadClient load(options);
+        auto t0 = Clock::now();
+        if (!load.connectAll()) {
+            status = 1;
+        } else {
+            double connectMs = chrono::duration<double, milli>(Clock::now() - t0).count();
+            double seconds = load.run(options.seconds);
+            Totals& totals = load.getTotals();
+
+            cout << fixed << setprecision(2);
+            cout << options.connections << " connections over "
+                 << (options.port ? "127.0.0.1:" + to_string(options.port) : options.socketPath) << ", window "
+                 << options.window << ", " << setprecision(1) << seconds << " s\n" << setprecision(2);
+            cout << "  connect " << setw(10) << connectMs << " ms (register, log in, subscribe)\n";
+            latencyRow("sent", totals.acked, seconds, totals.ackMs);
+            latencyRow("pushed", totals.pushes, seconds, totals.pushMs);
+            if (totals.errors) cout << "  errors  " << setw(10) << totals.errors << "\n";
+            if (server > 0) cout << "  server RSS " << setprecision(1) << residentMiB(server) << " MiB\n";
+            if (totals.pushes != totals.acked) {
+                cerr << "pushes (" << totals.pushes << ") do not match messages sent (" << totals.acked << ")\n";
+                status = 1;
+            }
+        }
+    }
+
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, nullptr, 0);
+        filesystem::current_path(home);
+        filesystem::remove_all(scratch);
+    }
+    return status;
+}
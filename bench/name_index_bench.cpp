@@ -0,0 +1,152 @@
+// Username index: FlatStringIndex against the maps it replaced.
+//
+// For each user count the three indexes are built one registration at a
+// time, with every insert timed on its own so the cost of growing shows
+// up in the slowest inserts rather than disappearing into the mean. On a
+// shared machine the scheduler alone causes the odd multi-millisecond
+// insert, so compare the tail columns across indexes rather than on their
+// own. Then random lookups of existing names (login) and of unknown
+// names (registration's "already taken" check) are timed.
+//
+//   std::map          the old AuthenticationService::usernameToUserId
+//   unordered_map     string_view keys, as UserDirectory had before
+//   FlatStringIndex   what UserDirectory uses now
+//
+//   name_index_bench [users ...]      (default: 1000000 10000000)
+
+#include "FlatStringIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const size_t LOOKUPS = 1 << 20;
+const size_t MISSES = 4096;
+
+using Clock = chrono::steady_clock;
+
+size_t sink = 0;
+
+struct KeyAt {
+    const vector<string>* names;
+    string_view operator()(uint32_t i) const { return (*names)[i]; }
+};
+
+struct Result {
+    double insertNs;
+    double p999InsertUs;
+    double worstInsertUs;
+    size_t slowInserts;     // over 1 ms
+    double hitNs;
+    double missNs;
+};
+
+// Times insert(i) for every i, then find(name) for hits and misses
+template <typename Insert, typename Find>
+Result measure(const vector<string>& names, const vector<uint32_t>& hits,
+               const vector<string>& misses, Insert insert, Find find) {
+    Result r{};
+    vector<uint64_t> insertNs(names.size());
+    auto start = Clock::now();
+    auto last = start;
+    for (size_t i = 0; i < names.size(); ++i) {
+        insert(static_cast<uint32_t>(i));
+        auto now = Clock::now();
+        insertNs[i] = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now - last).count());
+        if (insertNs[i] > 1000000) ++r.slowInserts;
+        last = now;
+    }
+    r.insertNs = chrono::duration<double, nano>(last - start).count() / static_cast<double>(names.size());
+    size_t p999 = insertNs.size() * 999 / 1000;
+    nth_element(insertNs.begin(), insertNs.begin() + p999, insertNs.end());
+    r.p999InsertUs = static_cast<double>(insertNs[p999]) / 1e3;
+    r.worstInsertUs = static_cast<double>(*max_element(insertNs.begin() + p999, insertNs.end())) / 1e3;
+
+    auto t0 = Clock::now();
+    for (uint32_t i : hits) sink += find(names[i]);
+    r.hitNs = chrono::duration<double, nano>(Clock::now() - t0).count() / static_cast<double>(hits.size());
+
+    t0 = Clock::now();
+    for (size_t round = 0; round < LOOKUPS / MISSES; ++round) {
+        for (const string& name : misses) sink += find(name);
+    }
+    r.missNs = chrono::duration<double, nano>(Clock::now() - t0).count() / static_cast<double>(LOOKUPS);
+    return r;
+}
+
+void report(size_t users, const char* name, const Result& r) {
+    cout << setw(9) << users << "  " << left << setw(16) << name << right << fixed
+         << setprecision(1) << setw(12) << r.insertNs << setw(12) << r.p999InsertUs
+         << setw(14) << r.worstInsertUs << setw(8) << r.slowInserts
+         << setw(10) << r.hitNs << setw(10) << r.missNs << "\n";
+}
+
+void benchUsers(size_t users) {
+    vector<string> names;
+    names.reserve(users);
+    for (size_t i = 0; i < users; ++i) names.push_back("user_" + to_string(i));
+
+    mt19937 rng(static_cast<unsigned>(users));
+    uniform_int_distribution<uint32_t> anyUser(0, static_cast<uint32_t>(users - 1));
+    vector<uint32_t> hits(LOOKUPS);
+    for (uint32_t& h : hits) h = anyUser(rng);
+    vector<string> misses;
+    for (size_t i = 0; i < MISSES; ++i) misses.push_back("nobody_" + to_string(anyUser(rng)));
+
+    {
+        map<string, int> index;
+        Result r = measure(names, hits, misses,
+            [&](uint32_t i) { index.emplace(names[i], static_cast<int>(i)); },
+            [&](const string& name) { return index.count(name); });
+        report(users, "std::map", r);
+    }
+    {
+        unordered_map<string_view, int> index;
+        Result r = measure(names, hits, misses,
+            [&](uint32_t i) { index.emplace(names[i], static_cast<int>(i)); },
+            [&](const string& name) { return index.count(name); });
+        report(users, "unordered_map", r);
+    }
+    {
+        FlatStringIndex<KeyAt> index(KeyAt{&names});
+        Result r = measure(names, hits, misses,
+            [&](uint32_t i) { index.insert(names[i], i); },
+            [&](const string& name) { return static_cast<size_t>(index.contains(name)); });
+        report(users, "FlatStringIndex", r);
+    }
+    cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        long long n = atoll(argv[i]);
+        if (n < 1 || n > static_cast<long long>(UINT32_MAX - 1)) {
+            cerr << "usage: name_index_bench [users ...]\n";
+            return 1;
+        }
+        sizes.push_back(static_cast<size_t>(n));
+    }
+    if (sizes.empty()) sizes = {1000000, 10000000};
+
+    cout << setw(9) << "users" << "  " << left << setw(16) << "index" << right
+         << setw(12) << "insert ns" << setw(12) << "p99.9 us" << setw(14) << "worst us" << setw(8) << ">1ms"
+         << setw(10) << "hit ns" << setw(10) << "miss ns" << "\n";
+    for (size_t n : sizes) benchUsers(n);
+    return sink > 0 ? 0 : 1;
+}
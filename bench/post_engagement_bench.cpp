@@ -0,0 +1,98 @@
+// Multi-threaded stress benchmark for Post engagement.
+//
+// Several worker threads hammer one hot post with likes, shares and
+// comments while also reading the counters, then the totals are checked.
+//
+//   post_engagement_bench [max_threads] [ops_per_thread]
+
+#include "Post.h"
+#include "User.h"
+#include "Like.h"
+#include "Comment.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct RunResult {
+    double seconds;
+    long long likes;
+    long long shares;
+    long long comments;
+};
+
+RunResult runOnce(int threads, int opsPerThread) {
+    // Each thread likes with its own users so every like is accepted
+    deque<User> users;
+    for (int i = 0; i < threads * opsPerThread; ++i) {
+        users.emplace_back(i + 1, "user" + to_string(i + 1), "password");
+    }
+
+    User author(0, "author", "password");
+    Post hot(1, &author, "This post is about to go viral");
+
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            long long seen = 0;
+            for (int i = 0; i < opsPerThread; ++i) {
+                User* u = &users[static_cast<size_t>(t) * opsPerThread + i];
+                hot.addLike(u);
+                hot.sharePost();
+                hot.sharePost();
+                if (i % 8 == 0) hot.addComment(u, "nice");
+                seen += hot.getLikeCount() + hot.getShareCount();
+            }
+            volatile long long sink = seen;   // keep the reads alive
+            (void)sink;
+        });
+    }
+    for (thread& w : workers) w.join();
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return {elapsed.count(), hot.getLikeCount(), hot.getShareCount(), hot.getCommentCount()};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxThreads   = argc > 1 ? atoi(argv[1]) : static_cast<int>(thread::hardware_concurrency());
+    int opsPerThread = argc > 2 ? atoi(argv[2]) : 50000;
+    if (maxThreads < 1) maxThreads = 1;
+
+    cout << "Post engagement stress: " << opsPerThread << " ops/thread "
+         << "(1 like + 2 shares + 2 counter reads, comment every 8th)\n\n";
+    cout << left << setw(10) << "threads" << setw(14) << "seconds"
+         << setw(16) << "Mops/s" << "check\n";
+
+    bool allOk = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RunResult r = runOnce(threads, opsPerThread);
+
+        long long expectedLikes    = static_cast<long long>(threads) * opsPerThread;
+        long long expectedShares   = expectedLikes * 2;
+        long long expectedComments = static_cast<long long>(threads) * ((opsPerThread + 7) / 8);
+        bool ok = r.likes == expectedLikes && r.shares == expectedShares
+               && r.comments == expectedComments;
+        allOk = allOk && ok;
+
+        double ops = static_cast<double>(expectedLikes) * 5 + expectedComments;
+        cout << left << setw(10) << threads
+             << setw(14) << fixed << setprecision(4) << r.seconds
+             << setw(16) << setprecision(2) << ops / r.seconds / 1e6
+             << (ok ? "ok" : "MISMATCH") << "\n";
+    }
+
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+// Throughput of the display path for a feed of posts.
+//
+// Renders the same posts twice into a file: once the way the views used
+// to write, straight to an ostream with a flush at every line (what a
+// line-buffered terminal does), and once through RenderBuffer with
+// Post::viewPost(RenderBuffer&). The file is unbuffered underneath, so the
+// reported write count is the number of write calls the file saw.
+//
+//   render_bench [posts]
+
+#include "RenderBuffer.h"
+#include "Post.h"
+#include "User.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Stream buffer over an unbuffered FILE that counts its writes
+class CountingFileBuf : public streambuf {
+private:
+    FILE* file;
+    char chunk[4096];
+    long long writes = 0;
+
+    void drain() {
+        size_t n = static_cast<size_t>(pptr() - pbase());
+        if (n == 0) return;
+        fwrite(pbase(), 1, n, file);
+        ++writes;
+        setp(chunk, chunk + sizeof(chunk));
+    }
+
+protected:
+    int overflow(int c) override {
+        drain();
+        if (c != EOF) {
+            *pptr() = static_cast<char>(c);
+            pbump(1);
+        }
+        return c == EOF ? 0 : c;
+    }
+
+    int sync() override {
+        drain();
+        return 0;
+    }
+
+public:
+    explicit CountingFileBuf(FILE* f) : file(f) {
+        setvbuf(file, nullptr, _IONBF, 0);
+        setp(chunk, chunk + sizeof(chunk));
+    }
+
+    long long getWrites() const { return writes; }
+};
+
+// The pre-RenderBuffer viewPost, with a flush per line
+void legacyViewPost(ostream& os, const Post& p) {
+    os << "@" << p.getAuthor()->getUsernameView() << ":" << endl;
+    os << left << setw(14) << "Author:" << p.getAuthor()->getUsernameView() << endl
+       << left << setw(14) << "Category:" << p.getCategoryView() << endl
+       << left << setw(14) << "Content:" << p.getTextView() << endl
+       << left << setw(14) << "Likes:" << p.getLikeCount()
+       << setw(14) << "Comments:" << p.getCommentCount()
+       << setw(14) << "Shares:" << p.getShareCount() << endl;
+
+    time_t created = p.getCreationTime();
+    tm* timeinfo = localtime(&created);
+    char buffer[64];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
+    os << left << setw(14) << "Created:" << buffer << endl;
+    os << string(50, '-') << endl;
+}
+
+struct Result {
+    double seconds;
+    long long writes;
+    uintmax_t bytes;
+};
+
+template <typename Render>
+Result renderTo(const filesystem::path& path, Render render) {
+    FILE* file = fopen(path.string().c_str(), "wb");
+    if (!file) {
+        cerr << "cannot open " << path << "\n";
+        exit(1);
+    }
+
+    Result r;
+    {
+        CountingFileBuf buf(file);
+        ostream os(&buf);
+        auto t0 = chrono::steady_clock::now();
+        render(os);
+        os.flush();
+        r.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        r.writes = buf.getWrites();
+    }
+    fclose(file);
+    r.bytes = filesystem::file_size(path);
+    return r;
+}
+
+void report(const char* name, const Result& r, int posts) {
+    cout << left << setw(14) << name << right << fixed << setprecision(0)
+         << setw(12) << posts / r.seconds << " posts/s"
+         << setw(10) << r.writes << " writes"
+         << setprecision(1) << setw(10) << r.bytes / r.seconds / 1e6 << " MB/s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int postCount = argc > 1 ? atoi(argv[1]) : 200000;
+    if (postCount < 1) {
+        cerr << "usage: render_bench [posts]\n";
+        return 1;
+    }
+
+    deque<User> users;
+    for (int u = 0; u < 100; ++u) {
+        users.emplace_back(u + 1, "reader_" + to_string(u + 1), "password");
+    }
+
+    // A feed spread over a few days, newest first
+    const time_t start = 1700000000;
+    vector<unique_ptr<Post>> posts;
+    posts.reserve(postCount);
+    for (int i = 0; i < postCount; ++i) {
+        posts.push_back(make_unique<Post>(i + 1, &users[i % users.size()],
+                                          "Notes from today's lecture, part " + to_string(i + 1),
+                                          500, "Study", start - i * 2));
+    }
+
+    filesystem::path path = filesystem::temp_directory_path() / "render_bench.txt";
+
+    Result legacy = renderTo(path, [&](ostream& os) {
+        for (const auto& p : posts) legacyViewPost(os, *p);
+    });
+
+    Result buffered = renderTo(path, [&](ostream& os) {
+        RenderBuffer out(os);
+        for (const auto& p : posts) {
+            out << "@" << p->getAuthor()->getUsernameView() << ":\n";
+            p->viewPost(out);
+            out.repeat('-', 50) << '\n';
+        }
+    });
+
+    filesystem::remove(path);
+
+    cout << postCount << " posts, " << legacy.bytes << " bytes each run\n";
+    report("line flush", legacy, postCount);
+    report("RenderBuffer", buffered, postCount);
+    cout << setprecision(1) << "speedup: " << legacy.seconds / buffered.seconds << "x\n";
+    return legacy.bytes == buffered.bytes ? 0 : 1;
+}
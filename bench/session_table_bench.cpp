@@ -0,0 +1,173 @@
+// Session tokens: creation, validation and timing-wheel expiry.
+//
+// Time is simulated by passing explicit clock values, so hours of session
+// life run in moments:
+//
+//   memory       resident growth per session, tokens not counted
+//   create       sessions started, with their 128-bit random tokens
+//   validate     one thread, tokens looked up in random order
+//   threads      THREADS threads validating at once (shards keep them apart)
+//   quiet tick   expire() at a tick where nothing is due, against a plain
+//                scan of every session, which is what a sweeper would cost
+//   expiry       the clock moved through the idle timeout one second at a
+//                time; half the sessions stay in use and are refiled, the
+//                other half expire
+//
+//   session_table_bench [sessions]       (default: 1000000)
+
+#include "SessionTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const int THREADS = 4;
+
+using Clock = chrono::steady_clock;
+
+double residentMiB() {
+    ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+double nsPer(Clock::duration elapsed, size_t ops) {
+    return chrono::duration<double, nano>(elapsed).count() / static_cast<double>(ops);
+}
+
+void row(const char* what, double value, const char* unit) {
+    cout << "  " << left << setw(14) << what << right << setw(12) << value << " " << unit << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 1000000;
+    if (argc > 1) {
+        long long n = atoll(argv[1]);
+        if (n < 2) {
+            cerr << "usage: session_table_bench [sessions]\n";
+            return 1;
+        }
+        count = static_cast<size_t>(n);
+    }
+
+    SessionTable table;
+    const Clock::time_point start = Clock::now();
+    bool ok = true;
+    cout << fixed << setprecision(1);
+    cout << count << " sessions, idle timeout " << table.getIdleTimeout().count() << " s, absolute "
+         << table.getAbsoluteTimeout().count() << " s, " << SessionTable::SHARDS << " shards\n";
+
+    // ─── Create ───
+    // Memory is measured on a table of its own, whose tokens are dropped
+    {
+        double before = residentMiB();
+        SessionTable alone;
+        for (size_t i = 0; i < count; ++i) alone.create(static_cast<int>(i), start);
+        row("memory", (residentMiB() - before) * (1 << 20) / static_cast<double>(count),
+            "bytes/session (table and wheel)");
+    }
+
+    vector<string> tokens;
+    tokens.reserve(count);
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < count; ++i) tokens.push_back(table.create(static_cast<int>(i), start));
+    row("create", nsPer(Clock::now() - t0, count), "ns/session");
+
+    // ─── Validate ───
+    vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    shuffle(order.begin(), order.end(), mt19937(42));
+
+    Clock::time_point now = start + chrono::seconds(1);
+    t0 = Clock::now();
+    for (size_t i : order) ok = table.validate(tokens[i], now) == static_cast<int>(i) && ok;
+    row("validate", nsPer(Clock::now() - t0, count), "ns/check");
+    ok = table.validate("not-a-token", now) == -1 && ok;
+    ok = table.validate(string(32, 'f'), now) == -1 && ok;
+
+    atomic<size_t> checked{0};
+    atomic<bool> allValid{true};
+    vector<thread> workers;
+    t0 = Clock::now();
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&, t] {
+            size_t done = 0;
+            for (size_t k = static_cast<size_t>(t); k < count; k += THREADS) {
+                size_t i = order[k];
+                if (table.validate(tokens[i], now) != static_cast<int>(i)) allValid = false;
+                ++done;
+            }
+            checked += done;
+        });
+    }
+    for (thread& w : workers) w.join();
+    auto threadTime = Clock::now() - t0;
+    ok = ok && allValid;
+    cout << "  " << left << setw(14) << "threads" << right << setw(12)
+         << static_cast<double>(checked) / chrono::duration<double>(threadTime).count() / 1e6 << " M checks/s ("
+         << THREADS << " threads, " << thread::hardware_concurrency() << " cores)\n";
+
+    // ─── Quiet tick against a full scan ───
+    now += chrono::seconds(1);
+    t0 = Clock::now();
+    size_t dropped = table.expire(now);
+    row("quiet tick", chrono::duration<double, micro>(Clock::now() - t0).count(), "us (wheel)");
+    ok = dropped == 0 && ok;
+
+    // A sweeper without a wheel visits every session on every pass
+    t0 = Clock::now();
+    size_t live = 0;
+    for (size_t i = 0; i < count; ++i) live += table.validate(tokens[i], now) != -1;
+    row("", chrono::duration<double, micro>(Clock::now() - t0).count(), "us (scanning every session)");
+    ok = live == count && ok;
+
+    // ─── Expiry ───
+    // Odd sessions are used once a minute until the idle timeout has
+    // passed for the even ones
+    const auto idle = table.getIdleTimeout();
+    Clock::time_point end = now + idle + chrono::seconds(2);
+    Clock::duration wheelTime{};
+    size_t expired = 0;
+    while (now < end) {
+        now += chrono::seconds(1);
+        if (chrono::duration_cast<chrono::seconds>(now - start).count() % 60 == 0) {
+            for (size_t i = 1; i < count; i += 2) table.validate(tokens[i], now);
+        }
+        t0 = Clock::now();
+        expired += table.expire(now);
+        wheelTime += Clock::now() - t0;
+    }
+    row("expiry", chrono::duration<double, milli>(wheelTime).count(), "ms for every tick of the idle timeout");
+    row("", nsPer(wheelTime, max<size_t>(expired, 1)), "ns per expired session (refiling included)");
+    ok = expired == (count + 1) / 2 && table.size() == count / 2 && ok;
+    ok = table.validate(tokens[0], now) == -1 && table.validate(tokens[1], now) == 1 && ok;
+    ok = table.end(tokens[1]) && table.validate(tokens[1], now) == -1 && ok;
+
+    // Absolute timeout: still in use, but too old
+    now = start + table.getAbsoluteTimeout() + chrono::seconds(1);
+    ok = table.validate(tokens[3], now) == -1 && ok;
+
+    if (!ok) {
+        cerr << "session table check FAILED\n";
+        return 1;
+    }
+    cout << "\nchecks ok\n";
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Microbenchmarks for the social core hot paths.
+//
+// For each user count the services are built in a scratch directory from
+// a generated users.txt, every user gets a ring of friends, and each case
+// is called until it has run for about MIN_SECONDS (or has used up its
+// inputs). Reports nanoseconds per call. Console output from the services
+// goes to a discarding stream so only the calls themselves are measured.
+//
+//   social_bench [max_users] [friends_per_user]
+
+#include "AuthenticationService.h"
+#include "UserDirectory.h"
+#include "FriendService.h"
+#include "FeedService.h"
+#include "User.h"
+#include "Post.h"
+#include "Like.h"
+#include "messenger_system.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const double MIN_SECONDS = 0.2;
+const int POSTS_PER_USER = 2;
+const size_t FEED_PAGE_SIZE = 20;
+const int LIKE_TARGETS = 64;
+
+// Discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+size_t sink = 0;
+
+// Calls op(0), op(1), ... until MIN_SECONDS have passed or maxOps calls
+// were made; the clock is read every 64 calls to keep it out of the way
+template <typename Op>
+void run(int users, const char* name, size_t maxOps, Op op) {
+    using clock = chrono::steady_clock;
+
+    streambuf* saved = cout.rdbuf();
+    NullBuffer null;
+    cout.rdbuf(&null);
+
+    size_t ops = 0;
+    auto t0 = clock::now();
+    double seconds = 0;
+    while (ops < maxOps) {
+        op(ops++);
+        if (ops % 64 == 0 || ops < 64) {
+            seconds = chrono::duration<double>(clock::now() - t0).count();
+            if (seconds >= MIN_SECONDS) break;
+        }
+    }
+    seconds = chrono::duration<double>(clock::now() - t0).count();
+
+    cout.rdbuf(saved);
+    cout << setw(9) << users << "  " << left << setw(34) << name << right
+         << setw(14) << fixed << setprecision(1) << seconds * 1e9 / static_cast<double>(ops)
+         << setw(10) << ops << "\n";
+}
+
+string usernameOf(int id) {
+    return "user" + to_string(id);
+}
+
+string passwordOf(int id) {
+    return "password" + to_string(id);
+}
+
+void writeUsers(int count) {
+    ofstream out("users.txt");
+    for (int id = 1; id <= count; ++id) {
+        out << id << " " << usernameOf(id) << " " << passwordOf(id) << "\n";
+    }
+}
+
+// Ring of friends: each user befriends the next friendsPerUser / 2 users
+void addFriendRing(AuthenticationService& auth, int count, int friendsPerUser) {
+    deque<User>& users = auth.getUsers();
+    for (int i = 0; i < count; ++i) {
+        for (int d = 1; d <= friendsPerUser / 2 && d < count; ++d) {
+            int j = (i + d) % count;
+            users[i].addFriend(j + 1);
+            users[j].addFriend(i + 1);
+        }
+    }
+}
+
+vector<string> messageLines(int count) {
+    vector<string> lines;
+    lines.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Message msg("msg_" + to_string(i), "student_" + to_string(i % 97),
+                    "See you at the library after the lecture, bring the notes");
+        for (int l = 0; l < i % 5; ++l) {
+            msg.addLike("student_" + to_string(l));
+        }
+        lines.push_back(msg.toCSV());
+    }
+    return lines;
+}
+
+void benchUsers(int count, int friendsPerUser) {
+    for (const char* file : {"users.txt", "friends.txt", "friend_requests.txt"}) {
+        filesystem::remove(file);
+    }
+    writeUsers(count);
+
+    UserDirectory directory;
+    AuthenticationService auth(directory);
+    FriendService friends(auth);
+    FeedService feed(auth);
+    addFriendRing(auth, count, friendsPerUser);
+
+    mt19937 rng(static_cast<unsigned>(count));
+    uniform_int_distribution<int> anyUser(1, count);
+    vector<int> ids(4096);
+    for (int& id : ids) id = anyUser(rng);
+    const size_t mask = ids.size() - 1;
+
+    run(count, "AuthenticationService::findUserById", SIZE_MAX, [&](size_t i) {
+        sink += auth.findUserById(ids[i & mask]) != nullptr;
+    });
+
+    run(count, "AuthenticationService::login", SIZE_MAX, [&](size_t i) {
+        int id = ids[i & mask];
+        sink += static_cast<size_t>(auth.login(usernameOf(id), passwordOf(id)));
+    });
+
+    run(count, "User::hasFriend", SIZE_MAX, [&](size_t i) {
+        const User* u = auth.findUserById(ids[i & mask]);
+        sink += u->hasFriend(ids[(i + 1) & mask]);
+    });
+
+    // Requests go half-way round the ring so the pair is never already
+    // friends; each sender is used once and no request is answered by a
+    // mutual one, so every call does the full work
+    size_t requests = 0;
+    run(count, "FriendService::sendFriendRequest", static_cast<size_t>(count / 2), [&](size_t i) {
+        int sender = static_cast<int>(i) + 1;
+        int target = static_cast<int>((i + count / 2) % count) + 1;
+        if (friends.sendFriendRequest(sender, usernameOf(target))) ++requests;
+    });
+
+    run(count, "FriendService::acceptFriendRequest", requests, [&](size_t i) {
+        int sender = static_cast<int>(i) + 1;
+        int target = static_cast<int>((i + count / 2) % count) + 1;
+        sink += friends.acceptFriendRequest(target, sender);
+    });
+
+    // News feed: publishing fans out to the author's friends, reading
+    // takes the first page of a user's timeline
+    vector<unique_ptr<Post>> posts;
+    posts.reserve(static_cast<size_t>(count) * POSTS_PER_USER);
+    const time_t start = 1700000000;
+    int nextPostId = 1;
+    run(count, "FeedService::publishPost", static_cast<size_t>(count) * POSTS_PER_USER, [&](size_t i) {
+        User* author = auth.findUserById(static_cast<int>(i % count) + 1);
+        posts.push_back(make_unique<Post>(nextPostId, author, "post " + to_string(nextPostId), 500,
+                                          "General", start + static_cast<time_t>(i)));
+        ++nextPostId;
+        author->addPost(posts.back().get());
+        feed.publishPost(posts.back().get());
+    });
+
+    run(count, "FeedService::getFeedPage", SIZE_MAX, [&](size_t i) {
+        sink += feed.getFeedPage(ids[i & mask], FEED_PAGE_SIZE).posts.size();
+    });
+
+    // Every user likes each of the first LIKE_TARGETS posts once
+    size_t likeTargets = min(posts.size(), static_cast<size_t>(LIKE_TARGETS));
+    run(count, "Like::createLike", static_cast<size_t>(count) * likeTargets, [&](size_t i) {
+        User* user = &auth.getUsers()[i % count];
+        sink += Like::createLike(user, posts[(i / count) % likeTargets].get()) != nullptr;
+    });
+
+    vector<string> lines = messageLines(min(count, 100000));
+    run(count, "Message::fromCSV", SIZE_MAX, [&](size_t i) {
+        sink += static_cast<size_t>(Message::fromCSV(lines[i % lines.size()]).getLikeCount());
+    });
+
+    cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxUsers = argc > 1 ? atoi(argv[1]) : 100000;
+    int friendsPerUser = argc > 2 ? atoi(argv[2]) : 20;
+    if (maxUsers < 1 || friendsPerUser < 0) {
+        cerr << "usage: social_bench [max_users] [friends_per_user]\n";
+        return 1;
+    }
+
+    // The services read and write their files in the working directory
+    filesystem::path original = filesystem::current_path();
+    filesystem::path scratch = filesystem::temp_directory_path() /
+        ("social_bench_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    filesystem::create_directories(scratch);
+    filesystem::current_path(scratch);
+
+    cout << setw(9) << "users" << "  " << left << setw(34) << "case" << right
+         << setw(14) << "ns/call" << setw(10) << "calls" << "\n";
+
+    vector<int> sizes;
+    for (int n = 1000; n < maxUsers; n *= 10) sizes.push_back(n);
+    sizes.push_back(maxUsers);
+    for (int n : sizes) benchUsers(n, friendsPerUser);
+
+    filesystem::current_path(original);
+    filesystem::remove_all(scratch);
+    return sink > 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// Benchmark for TrendingEngine under a skewed engagement stream.
+//
+// Engagements (70% likes, 20% comments, 10% shares) are drawn from a Zipf
+// distribution over the posts while a simulated clock moves forward, so a
+// few posts get most of the traffic and the leaders change over time.
+// Reports update throughput and top-K read latency, then checks the top K
+// against a full rescoring of the recorded stream.
+//
+//   trending_bench [posts] [events] [zipf_s]
+
+#include "TrendingEngine.h"
+#include "Post.h"
+#include "User.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const double HALF_LIFE_HOURS = 6.0;
+const size_t TOP_K = 10;
+
+struct Event {
+    int post;
+    TrendingEngine::Engagement kind;
+    time_t at;
+};
+
+// Inverse-CDF sampler for ranks 0..n-1 with P(rank) ~ 1 / (rank + 1)^s
+class ZipfSampler {
+private:
+    vector<double> cdf;
+    uniform_real_distribution<double> unit{0.0, 1.0};
+
+public:
+    ZipfSampler(size_t n, double s) : cdf(n) {
+        double total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += 1.0 / pow(static_cast<double>(i + 1), s);
+            cdf[i] = total;
+        }
+        for (double& c : cdf) c /= total;
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng& rng) {
+        auto it = lower_bound(cdf.begin(), cdf.end(), unit(rng));
+        return min(static_cast<size_t>(it - cdf.begin()), cdf.size() - 1);
+    }
+};
+
+double weightOf(TrendingEngine::Engagement kind) {
+    switch (kind) {
+        case TrendingEngine::LIKE:    return TrendingEngine::LIKE_WEIGHT;
+        case TrendingEngine::COMMENT: return TrendingEngine::COMMENT_WEIGHT;
+        case TrendingEngine::SHARE:   return TrendingEngine::SHARE_WEIGHT;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int postCount = argc > 1 ? atoi(argv[1]) : 100000;
+    long long eventCount = argc > 2 ? atoll(argv[2]) : 2000000;
+    double zipfS = argc > 3 ? atof(argv[3]) : 1.1;
+    if (postCount < 1 || eventCount < 1) {
+        cerr << "usage: trending_bench [posts] [events] [zipf_s]\n";
+        return 1;
+    }
+
+    const time_t start = 1700000000;
+    User author(1, "author", "password");
+    vector<unique_ptr<Post>> posts;
+    posts.reserve(postCount);
+    for (int i = 0; i < postCount; ++i) {
+        posts.push_back(make_unique<Post>(i + 1, &author, "post " + to_string(i + 1), 500, "General", start));
+    }
+
+    // Popularity ranks are shuffled so hot posts are spread over the IDs,
+    // and the stream covers a week so older bursts decay away
+    mt19937_64 rng(42);
+    vector<int> byRank(postCount);
+    for (int i = 0; i < postCount; ++i) byRank[i] = i;
+    shuffle(byRank.begin(), byRank.end(), rng);
+
+    ZipfSampler zipf(postCount, zipfS);
+    uniform_int_distribution<int> kindDist(0, 9);
+    const double secondsPerEvent = 7.0 * 24 * 3600 / static_cast<double>(eventCount);
+
+    vector<Event> events;
+    events.reserve(eventCount);
+    for (long long e = 0; e < eventCount; ++e) {
+        int k = kindDist(rng);
+        TrendingEngine::Engagement kind = k < 7 ? TrendingEngine::LIKE
+                                        : k < 9 ? TrendingEngine::COMMENT
+                                                : TrendingEngine::SHARE;
+        // Reshuffle the head of the distribution once a day
+        if (e > 0 && static_cast<long long>(e * secondsPerEvent) / 86400 !=
+                     static_cast<long long>((e - 1) * secondsPerEvent) / 86400) {
+            shuffle(byRank.begin(), byRank.begin() + min(postCount, 100), rng);
+        }
+        events.push_back({byRank[zipf(rng)], kind, start + static_cast<time_t>(e * secondsPerEvent)});
+    }
+    const time_t end = events.back().at;
+
+    TrendingEngine engine(HALF_LIFE_HOURS, start);
+
+    auto t0 = chrono::steady_clock::now();
+    for (const Event& ev : events) {
+        engine.record(*posts[ev.post], ev.kind, ev.at);
+    }
+    double updateSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    const int READS = 100000;
+    size_t sink = 0;
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < READS; ++r) {
+        sink += engine.getTopPosts(TOP_K, end).size();
+    }
+    double readSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    cout << postCount << " posts, " << eventCount << " events, zipf s=" << zipfS
+         << ", " << engine.size() << " posts ranked\n";
+    cout << fixed << setprecision(1)
+         << "updates:  " << setw(10) << eventCount / updateSeconds / 1e6 << " M/s ("
+         << setprecision(0) << updateSeconds * 1e9 / eventCount << " ns each)\n"
+         << setprecision(2)
+         << "top-" << TOP_K << ":   " << setw(10) << readSeconds * 1e9 / READS << " ns per read\n";
+
+    // Full rescoring of the stream at `end` for comparison
+    const double halfLifeSeconds = HALF_LIFE_HOURS * 3600.0;
+    vector<double> exact(postCount, 0.0);
+    for (const Event& ev : events) {
+        exact[ev.post] += weightOf(ev.kind) * exp2(-static_cast<double>(end - ev.at) / halfLifeSeconds);
+    }
+    vector<int> order(postCount);
+    for (int i = 0; i < postCount; ++i) order[i] = i;
+    partial_sort(order.begin(), order.begin() + min<size_t>(TOP_K, postCount), order.end(),
+                 [&](int a, int b) { return exact[a] > exact[b]; });
+
+    vector<TrendingEntry> top = engine.getTopPosts(TOP_K, end);
+    bool ok = top.size() == min<size_t>(TOP_K, postCount);
+    for (size_t i = 0; ok && i < top.size(); ++i) {
+        double expected = exact[order[i]];
+        if (fabs(top[i].score - expected) > 1e-6 * max(1.0, expected)) ok = false;
+    }
+
+    cout << "top-" << TOP_K << " vs full rescoring: " << (ok ? "match" : "MISMATCH") << "\n";
+    for (size_t i = 0; i < top.size() && i < 3; ++i) {
+        cout << "  #" << i + 1 << " post " << top[i].post->getPostId()
+             << "  score " << setprecision(3) << top[i].score << "\n";
+    }
+    return ok && sink > 0 ? 0 : 1;
+}
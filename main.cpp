@@ -3,25 +3,73 @@
 #include <vector>
 #include <limits>
 #include <iomanip>
+#include <map>
+#include <memory>
 
 #include "AuthenticationService.h"
 #include "FriendService.h"
+#include "SuggestionService.h"
+#include "FeedService.h"
+#include "PostStore.h"
+#include "CategoryRegistry.h"
+#include "TrendingEngine.h"
+#include "SocialBatch.h"
+#include "UserDirectory.h"
+#include "LatencyTrace.h"
+#include "Like.h"
+#include "page.h"
 #include "User.h"
 #include "Post.h"
 
 using namespace std;
 
-int main() {
-    AuthenticationService auth;         
+int main(int argc, char* argv[]) {
+    UserDirectory directory;
+    AuthenticationService auth(directory);
     FriendService friendService(auth);  
+    SuggestionService suggestions(auth, friendService);
+    PostStore postStore(auth);
+    FeedService feed(auth);
+    CategoryRegistry categories;
+    TrendingEngine trending;
+    for (Post* p : postStore.getPosts()) {
+        feed.publishPost(p);
+        categories.addPost(p);
+        trending.seedPost(*p);
+    }
+
+    map<string, unique_ptr<Page>> pages;    // keyed by Page::fileFor(name)
+    for (const string& name : Page::findSavedPages()) {
+        auto page = make_unique<Page>(name, auth, postStore);
+        page->attachFeed(&feed);
+        pages[Page::fileFor(name)] = std::move(page);
+    }
 
+    // Headless mode: social_app --batch <script | ->
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        BatchRunner runner;
+        SocialBatch batch(auth, friendService, suggestions, feed, postStore, categories, trending);
+        batch.install(runner);
+        return runner.runFile(argc > 2 ? argv[2] : "-");
+    }
+
+    // The login is held as a session token and checked before every menu,
+    // so an idle console logs itself out like any other client
+    string sessionToken;
     int currentUserId = -1;
     string inputLine;
-    static int nextPostId = 1000;
 
     while (true) {
         cout << "\n";
 
+        if (!sessionToken.empty()) {
+            currentUserId = auth.validateSession(sessionToken);
+            if (currentUserId == -1) {
+                cout << "Your session has expired. Please log in again.\n";
+                sessionToken.clear();
+            }
+        }
+
         if (currentUserId == -1) {
             // ───────────── Not logged in ─────────────
            
@@ -58,8 +106,8 @@ int main() {
                 cout << "Password: ";
                 getline(cin, password);
 
-                currentUserId = auth.login(username, password);
-                if (currentUserId != -1) {
+                sessionToken = auth.startSession(username, password);
+                if (!sessionToken.empty()) {
                     cout << "Login successful!\n";
                 } else {
                     cout << "Login failed – wrong username or password.\n";
@@ -78,11 +126,13 @@ int main() {
             User* currentUser = auth.findUserById(currentUserId);
             if (!currentUser) {
                 cout << "Session error: user not found. Logging out...\n";
+                auth.endSession(sessionToken);
+                sessionToken.clear();
                 currentUserId = -1;
                 continue;
             }
 
-            cout << "=== Welcome, @" << currentUser->getUsername()
+            cout << "=== Welcome, @" << currentUser->getUsernameView()
                  << " (ID: " << currentUserId << ") ===\n";
             cout << string(50, '-') << "\n";
 
@@ -95,6 +145,11 @@ int main() {
             cout << " 7. Create new post\n";
             cout << " 8. View my posts\n";
             cout << " 9. View news feed\n";
+            cout << "10. People you may know\n";
+            cout << "11. Browse posts by category\n";
+            cout << "12. Trending posts\n";
+            cout << "13. Pages\n";
+            cout << "14. Admin: latency report\n";
             cout << " 0. Logout\n";
             cout << "Choice: ";
 
@@ -106,7 +161,12 @@ int main() {
                 cout << "Enter target username: ";
                 getline(cin, target);
                 if (!target.empty()) {
-                    friendService.sendFriendRequest(currentUserId, target);
+                    if (friendService.sendFriendRequest(currentUserId, target)) {
+                        User* targetUser = auth.findUserByUsername(target);
+                        if (targetUser && friendService.areFriends(currentUserId, targetUser->getUserId())) {
+                            feed.backfillFriendship(currentUserId, targetUser->getUserId());
+                        }
+                    }
                 } else {
                     cout << "Username cannot be empty.\n";
                 }
@@ -124,7 +184,9 @@ int main() {
                 }
                 User* sender = auth.findUserByUsername(senderName);
                 if (sender) {
-                    friendService.acceptFriendRequest(currentUserId, sender->getUserId());
+                    if (friendService.acceptFriendRequest(currentUserId, sender->getUserId())) {
+                        feed.backfillFriendship(currentUserId, sender->getUserId());
+                    }
                 } else {
                     cout << "User not found.\n";
                 }
@@ -166,9 +228,12 @@ int main() {
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
                 cout << "\n--- Create New Post ---\n";
-                Post* newPost = Post::createPost(nextPostId++, currentUser);
+                Post* newPost = Post::createPost(postStore.allocatePostId(), currentUser);
                 if (newPost) {
                     currentUser->addPost(newPost);
+                    postStore.appendPost(newPost);
+                    feed.publishPost(newPost);
+                    categories.addPost(newPost);
                     cout << "Your post has been published!\n";
                 } else {
                     cout << "Post creation cancelled or failed.\n";
@@ -179,34 +244,153 @@ int main() {
                 currentUser->showMyPosts();
             }
             else if (inputLine == "9") {
+                const size_t FEED_PAGE_SIZE = 10;
+                FeedCursor cursor;
+                int pageNumber = 1;
+
                 cout << "\n=== News Feed ===\n";
-                cout << string(50, '-') << "\n";
+                while (true) {
+                    FeedPage page;
+                    {
+                        TRACE_SCOPE("main: news feed page");
+                        page = feed.getFeedPage(currentUserId, FEED_PAGE_SIZE, cursor);
+                        cout << string(50, '-') << "\n";
+                        cout << "Page " << pageNumber << "\n";
+                        cout << string(50, '-') << "\n";
+                        feed.showFeedPage(page);
+                    }
 
-                cout << "Your recent posts:\n";
-                currentUser->showMyPosts();
+                    if (!page.hasMore) break;
 
-                vector<int> friendIds = friendService.getFriendIdsOf(currentUserId);
-                if (!friendIds.empty()) {
-                    cout << "\nFriends' posts:\n";
+                    cout << "Press Enter for older posts, or 0 to go back: ";
+                    getline(cin, inputLine);
+                    if (inputLine == "0") break;
+
+                    cursor = page.next;
+                    ++pageNumber;
+                }
+            }
+            else if (inputLine == "10") {
+                suggestions.showSuggestionsFor(currentUserId);
+            }
+            else if (inputLine == "11") {
+                categories.showCategories();
+                if (categories.listCategories().empty()) continue;
+
+                string categoryName;
+                cout << "Enter category: ";
+                getline(cin, categoryName);
+                if (categories.findCategory(categoryName) < 0) {
+                    cout << "Category not found.\n";
+                    continue;
+                }
+
+                const size_t CATEGORY_PAGE_SIZE = 10;
+                FeedCursor cursor;
+                int pageNumber = 1;
+
+                cout << "\n=== " << categories.getCategoryName(categories.findCategory(categoryName)) << " ===\n";
+                while (true) {
+                    FeedPage page = categories.getCategoryPage(categoryName, CATEGORY_PAGE_SIZE, cursor);
                     cout << string(50, '-') << "\n";
-                    for (int fid : friendIds) {
-                        User* friendUser = auth.findUserById(fid);
-                        if (friendUser) {
-                            cout << "@" << friendUser->getUsername() << ":\n";
-                            friendUser->showMyPosts();
-                            cout << "\n";
-                        }
+                    cout << "Page " << pageNumber << "\n";
+                    cout << string(50, '-') << "\n";
+                    feed.showFeedPage(page);
+
+                    if (!page.hasMore) break;
+
+                    cout << "Press Enter for older posts, or 0 to go back: ";
+                    getline(cin, inputLine);
+                    if (inputLine == "0") break;
+
+                    cursor = page.next;
+                    ++pageNumber;
+                }
+            }
+            else if (inputLine == "12") {
+                const size_t TRENDING_COUNT = 10;
+
+                cout << "\n=== Trending ===\n";
+                trending.showTrending(TRENDING_COUNT);
+
+                cout << "Enter a post ID to like, comment on or share (Enter to go back): ";
+                getline(cin, inputLine);
+                if (inputLine.empty()) continue;
+
+                Post* post = nullptr;
+                try {
+                    post = feed.findPost(stoi(inputLine));
+                } catch (...) {
+                    post = nullptr;
+                }
+                if (!post || post->isDeletedPost()) {
+                    cout << "Post not found.\n";
+                    continue;
+                }
+
+                cout << "(l)ike, (c)omment or (s)hare: ";
+                getline(cin, inputLine);
+                if (inputLine == "l") {
+                    Like::createLike(currentUser, post);
+                } else if (inputLine == "c") {
+                    string text;
+                    cout << "Enter comment: ";
+                    getline(cin, text);
+                    if (text.empty() || !post->addComment(currentUser, text)) {
+                        cout << "Comment cancelled.\n";
+                    } else {
+                        cout << "Comment added.\n";
                     }
+                } else if (inputLine == "s") {
+                    post->sharePost();
+                    cout << "Post shared.\n";
                 } else {
-                    cout << "\nNo friends yet. Add some friends to see their posts!\n";
+                    cout << "Invalid choice.\n";
+                }
+            }
+            else if (inputLine == "13") {
+                cout << "\n--- Pages ---\n";
+                if (pages.empty()) {
+                    cout << "No pages yet.\n";
+                }
+                for (const auto& entry : pages) {
+                    cout << "  - " << entry.second->getName()
+                         << " (" << entry.second->getFollowerCount() << " followers)\n";
+                }
+
+                string pageName;
+                cout << "Enter page name to open (a new name creates the page): ";
+                getline(cin, pageName);
+                if (pageName.find_first_not_of(" \t") == string::npos) continue;
+
+                unique_ptr<Page>& page = pages[Page::fileFor(pageName)];
+                if (!page) {
+                    page = make_unique<Page>(pageName, auth, postStore);
+                    page->attachFeed(&feed);
+                    cout << "Page created.\n";
+                }
+
+                vector<User*> users;
+                for (User& u : auth.getUsers()) users.push_back(&u);
+                page->showMenu(users);
+            }
+            else if (inputLine == "14") {
+                const string LATENCY_REPORT_FILE = "latency_report.txt";
+
+                cout << "\n=== Latency Report ===\n";
+                LatencyTrace::report(cout);
+                if (LatencyTrace::dump(LATENCY_REPORT_FILE)) {
+                    cout << "Saved to " << LATENCY_REPORT_FILE << "\n";
                 }
             }
             else if (inputLine == "0") {
+                auth.endSession(sessionToken);
+                sessionToken.clear();
                 cout << "Logged out successfully.\n";
                 currentUserId = -1;
             }
             else {
-                cout << "Invalid choice. Please enter a number from 0-9.\n";
+                cout << "Invalid choice. Please enter a number from 0-14.\n";
             }
         }
     }
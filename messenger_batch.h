@@ -0,0 +1,147 @@
+#ifndef MESSENGER_BATCH_H
+#define MESSENGER_BATCH_H
+
+#include "messenger_manager.h"
+#include "BatchRunner.h"
+
+using namespace std;
+
+// Script commands for `messenger --batch`, mirroring the chat menu. The
+// "last" placeholder stands for the newest group the script created or
+// the newest message it sent.
+class MessengerBatch {
+private:
+    MessengerManager& messenger;
+
+    string lastGroupId;
+    string lastMessageId;
+    string lastChatId;           // conversation or group of lastMessageId
+    bool lastInGroup = false;
+
+    // Renders a transcript the way the chat views do
+    static void render(const vector<shared_ptr<Message>>& messages) {
+        RenderBuffer out;
+        for (const auto& msg : messages) {
+            out << "\n[" << msg->getMessageIdView() << "]\n"
+                << msg->getSenderIdView() << ": ";
+            msg->writeContent(out);
+            out << '\n';
+        }
+    }
+
+public:
+    MessengerBatch(MessengerManager& mgr) : messenger(mgr) {}
+
+    void install(BatchRunner& runner) {
+        runner.add("register", 2, "<user-id> <name...>", [this](const BatchCommand& c) {
+            return messenger.registerUser(c[1], c.text(2));
+        });
+
+        runner.add("login", 1, "<user-id>", [this](const BatchCommand& c) {
+            return messenger.login(c[1]);
+        });
+
+        runner.add("logout", 0, "", [this](const BatchCommand&) {
+            if (!messenger.isUserLoggedIn()) return false;
+            messenger.logout();
+            return true;
+        });
+
+        runner.add("send", 2, "<user-id> <text...>", [this](const BatchCommand& c) {
+            auto msg = messenger.sendMessage(c[1], c.text(2));
+            if (!msg) return false;
+
+            auto conv = messenger.getConversation(messenger.getCurrentUserId(), c[1]);
+            lastMessageId = msg->getMessageId();
+            lastChatId = conv ? conv->getConversationId() : "";
+            lastInGroup = false;
+            return true;
+        });
+
+        // Members are comma-separated, without spaces
+        runner.add("group-create", 1, "<name> [member,member...]", [this](const BatchCommand& c) {
+            vector<string> members;
+            if (c.size() > 2) {
+                stringstream ss(c[2]);
+                string id;
+                while (getline(ss, id, ',')) {
+                    if (!id.empty()) members.push_back(id);
+                }
+            }
+
+            auto group = messenger.createGroup(c[1], members);
+            if (!group) return false;
+            lastGroupId = group->getGroupId();
+            return true;
+        });
+
+        runner.add("group-send", 2, "<group-id|last> <text...>", [this](const BatchCommand& c) {
+            string groupId = c[1] == "last" ? lastGroupId : c[1];
+            auto msg = messenger.sendGroupMessage(groupId, c.text(2));
+            if (!msg) return false;
+
+            lastMessageId = msg->getMessageId();
+            lastChatId = groupId;
+            lastInGroup = true;
+            return true;
+        });
+
+        // like last | like <message-id> <chat-id> [group]
+        runner.add("like", 1, "last | <message-id> <chat-id> [group]", [this](const BatchCommand& c) {
+            if (c[1] == "last") {
+                return !lastMessageId.empty() && messenger.likeMessage(lastMessageId, lastChatId, lastInGroup);
+            }
+            if (c.size() < 3) return false;
+            return messenger.likeMessage(c[1], c[2], c.size() > 3 && c[3] == "group");
+        });
+
+        runner.add("view", 1, "<user-id>", [this](const BatchCommand& c) {
+            if (!messenger.isUserLoggedIn()) return false;
+            auto conv = messenger.getConversation(messenger.getCurrentUserId(), c[1]);
+            if (!conv) return false;
+            render(conv->getMessagesView());
+            return true;
+        });
+
+        runner.add("view-group", 1, "<group-id|last>", [this](const BatchCommand& c) {
+            auto group = messenger.getGroup(c[1] == "last" ? lastGroupId : c[1]);
+            if (!group || !group->isParticipant(messenger.getCurrentUserIdView())) return false;
+            render(group->getMessagesView());
+            return true;
+        });
+
+        // Messages [offset, offset + limit) across archived and recent
+        runner.add("page", 3, "<chat-id> <offset> <limit> [group]", [this](const BatchCommand& c) {
+            auto page = messenger.getMessagePage(c[1], c.size() > 4 && c[4] == "group",
+                                                 atoi(c[2].c_str()), atoi(c[3].c_str()));
+            render(page);
+            return !page.empty();
+        });
+
+        runner.add("retention", 3, "<chat-id> <max-days> <max-messages> [group]", [this](const BatchCommand& c) {
+            RetentionPolicy policy;
+            policy.maxAgeDays = atoi(c[2].c_str());
+            policy.maxMessages = atoi(c[3].c_str());
+            return messenger.setRetention(c[1], c.size() > 4 && c[4] == "group", policy);
+        });
+
+        // Optional argument: archive messages older than this many seconds
+        runner.add("archive", 0, "[cold-age-seconds]", [this](const BatchCommand& c) {
+            if (c.size() > 1) messenger.setColdAge(static_cast<time_t>(atoll(c[1].c_str())));
+            messenger.archiveOldMessages();
+            return true;
+        });
+
+        runner.add("conversations", 0, "", [this](const BatchCommand&) {
+            if (!messenger.isUserLoggedIn()) return false;
+            return !messenger.getMyConversations().empty();
+        });
+
+        runner.add("users", 0, "", [this](const BatchCommand&) {
+            messenger.displayAllUsers();
+            return true;
+        });
+    }
+};
+
+#endif // MESSENGER_BATCH_H
@@ -0,0 +1,502 @@
+#ifndef MESSENGER_CHAT_LOG_H
+#define MESSENGER_CHAT_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CHAT LOG
+// Message history of one kind of chat (conversations.csv, groups.csv).
+//
+// The CSV keeps its format, one line per message: the chat's fields
+// (ID first) and then the message. Lines are only ever appended, so a
+// chat's lines sit in one or more extents of the file. At startup only
+// the chat directory is read (ID, leading fields, message count and
+// extents) from a checkpoint next to the CSV (<file>.idx); lines added
+// after the checkpoint are indexed by scanning just that tail. Without a
+// checkpoint (a CSV from an older version) the whole file is scanned once.
+//
+// A changed message (a like) is appended again and the later line wins
+// when the chat is read. Once superseded lines or scattered extents add
+// up, compact() rewrites the file with each chat's lines together, from
+// append() unless the owner turned that off to run it at a better time.
+// ============================================================================
+class ChatLog {
+public:
+    struct Extent {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    struct Entry {
+        string meta;               // the chat's fields, as on its first line
+        int messageCount = 0;
+        vector<Extent> extents;    // file order
+    };
+
+    // Lets the owner take messages out of the file while it is compacted
+    // (archiving, retention). edit() gets each chat's messages, oldest
+    // first, and may remove some; commit() runs once the new file is
+    // written, before it replaces the old one, and can cancel; done()
+    // runs after the swap.
+    struct CompactionHooks {
+        function<void()> begin;
+        function<void(const string& chatId, vector<string>& messages)> edit;
+        function<bool()> commit;
+        function<void()> done;
+    };
+
+    // Compact when superseded bytes pass this and half the file, or when
+    // there are this many more extents than chats
+    static constexpr uint64_t COMPACT_DEAD_BYTES = 1 << 20;
+    static constexpr size_t COMPACT_EXTRA_EXTENTS = 65536;
+
+private:
+    string path;
+    string indexPath;
+    string header;
+    size_t metaFields;
+
+    map<string, Entry> chats;
+    uint64_t dataSize = 0;
+    uint64_t deadBytes = 0;
+    size_t extentCount = 0;
+
+    ofstream appender;
+    ifstream reader;
+    CompactionHooks hooks;
+    bool autoCompact = true;
+
+    // Splits a line into its chat fields and the message; false if the
+    // line has fewer fields than a chat line needs
+    bool splitLine(string_view line, string_view& meta, string_view& message) const {
+        size_t pos = 0;
+        for (size_t field = 0; field < metaFields; ++field) {
+            pos = line.find(',', pos);
+            if (pos == string_view::npos) return false;
+            ++pos;
+        }
+        meta = line.substr(0, pos - 1);
+        message = line.substr(pos);
+        return true;
+    }
+
+    static string_view idOf(string_view meta) {
+        return meta.substr(0, meta.find(','));
+    }
+
+    void addExtent(Entry& entry, uint64_t offset, uint64_t length) {
+        if (!entry.extents.empty() && entry.extents.back().offset + entry.extents.back().length == offset) {
+            entry.extents.back().length += length;
+        } else {
+            entry.extents.push_back(Extent{offset, length});
+            ++extentCount;
+        }
+    }
+
+    // Indexes the lines from `from` to the end of the file. A superseding
+    // line cannot be told apart here, so counts from a scanned tail can be
+    // high until the chat is next read.
+    void scan(uint64_t from) {
+        ifstream in(path, ios::binary);
+        if (!in.is_open()) return;
+        in.seekg(static_cast<streamoff>(from));
+
+        string line;
+        uint64_t offset = from;
+        while (getline(in, line)) {
+            uint64_t length = line.size() + 1;
+            if (offset > 0) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                string_view meta, message;
+                if (splitLine(line, meta, message)) {
+                    Entry& entry = chats[string(idOf(meta))];
+                    if (entry.meta.empty()) entry.meta = string(meta);
+                    ++entry.messageCount;
+                    addExtent(entry, offset, length);
+                }
+            }
+            offset += length;
+        }
+    }
+
+    bool readIndex(uint64_t fileSize) {
+        ifstream in(indexPath);
+        if (!in.is_open()) return false;
+
+        string magic;
+        int version = 0;
+        uint64_t indexedSize = 0, dead = 0;
+        if (!(in >> magic >> version >> indexedSize >> dead) || magic != "chatlog" || version != 1 ||
+            indexedSize > fileSize) {
+            return false;
+        }
+        in.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        map<string, Entry> loaded;
+        size_t extents = 0;
+        string line;
+        while (getline(in, line)) {
+            size_t tab1 = line.find('\t');
+            size_t tab2 = tab1 == string::npos ? string::npos : line.find('\t', tab1 + 1);
+            if (tab2 == string::npos) return false;
+
+            Entry entry;
+            entry.messageCount = atoi(line.c_str());
+            entry.meta = line.substr(tab2 + 1);
+
+            stringstream ranges(line.substr(tab1 + 1, tab2 - tab1 - 1));
+            string range;
+            while (getline(ranges, range, ';')) {
+                size_t colon = range.find(':');
+                if (colon == string::npos) return false;
+                entry.extents.push_back(Extent{strtoull(range.c_str(), nullptr, 10),
+                                               strtoull(range.c_str() + colon + 1, nullptr, 10)});
+                ++extents;
+            }
+            loaded[string(idOf(entry.meta))] = std::move(entry);
+        }
+
+        chats = std::move(loaded);
+        dataSize = indexedSize;
+        deadBytes = dead;
+        extentCount = extents;
+        return true;
+    }
+
+    // The chat's message lines, later lines for a message ID replacing
+    // earlier ones in place
+    vector<string> readMessages(const Entry& entry) {
+        appender.flush();
+        reader.clear();
+
+        vector<string> messages;
+        unordered_map<string, size_t> slotById;
+        string block;
+        for (const Extent& extent : entry.extents) {
+            block.resize(static_cast<size_t>(extent.length));
+            reader.seekg(static_cast<streamoff>(extent.offset));
+            if (!reader.read(&block[0], static_cast<streamsize>(extent.length))) {
+                reader.clear();
+                continue;
+            }
+
+            string_view rest(block);
+            while (!rest.empty()) {
+                size_t end = rest.find('\n');
+                string_view line = rest.substr(0, end);
+                rest = end == string_view::npos ? string_view() : rest.substr(end + 1);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+                string_view meta, message;
+                if (!splitLine(line, meta, message)) continue;
+                string id(message.substr(0, message.find(',')));
+                auto [it, added] = slotById.emplace(std::move(id), messages.size());
+                if (added) {
+                    messages.emplace_back(message);
+                } else {
+                    messages[it->second].assign(message);
+                }
+            }
+        }
+        return messages;
+    }
+
+    void openFiles() {
+        appender.close();
+        reader.close();
+        appender.open(path, ios::binary | ios::app);
+        reader.open(path, ios::binary);
+        if (!appender.is_open()) {
+            cout << "Error: Could not open " << path << " for writing!" << endl;
+        }
+    }
+
+    void compactIfNeeded() {
+        if (autoCompact && needsCompaction()) compact();
+    }
+
+public:
+    ChatLog(const string& file, const string& headerLine, size_t chatFields)
+        : path(file), indexPath(file + ".idx"), header(headerLine), metaFields(chatFields) {
+        error_code ec;
+        uint64_t fileSize = filesystem::exists(path, ec) ? filesystem::file_size(path, ec) : 0;
+        if (ec) fileSize = 0;
+
+        if (fileSize == 0) {
+            ofstream create(path, ios::binary | ios::trunc);
+            create << header << "\n";
+            fileSize = header.size() + 1;
+        }
+
+        bool indexed = readIndex(fileSize);
+        if (!indexed) {
+            chats.clear();
+            dataSize = deadBytes = 0;
+            extentCount = 0;
+        }
+        if (dataSize < fileSize) scan(dataSize);
+        bool scanned = dataSize < fileSize;
+        dataSize = fileSize;
+
+        openFiles();
+        if (scanned) {
+            // An old CSV interleaves chats line by line; rewrite it once so
+            // each chat is one extent and the directory stays small
+            compactIfNeeded();
+            writeIndex();
+        }
+    }
+
+    ~ChatLog() {
+        writeIndex();
+    }
+
+    ChatLog(const ChatLog&) = delete;
+    ChatLog& operator=(const ChatLog&) = delete;
+
+    const map<string, Entry>& getChats() const { return chats; }
+
+    void setCompactionHooks(CompactionHooks compactionHooks) { hooks = std::move(compactionHooks); }
+
+    // Off: append() leaves compaction to the owner (needsCompaction)
+    void setAutoCompact(bool on) { autoCompact = on; }
+
+    bool needsCompaction() const {
+        bool manyDead = deadBytes > COMPACT_DEAD_BYTES && deadBytes * 2 > dataSize;
+        bool scattered = extentCount > chats.size() * 2 + COMPACT_EXTRA_EXTENTS;
+        return manyDead || scattered;
+    }
+
+    // Registers a chat before its first message; meta starts with chatId
+    void addChat(const string& chatId, const string& meta) {
+        Entry& entry = chats[chatId];
+        if (entry.meta.empty()) entry.meta = meta;
+    }
+
+    // Appends one message line. `replaces` marks a new version of a
+    // message already in the chat (it then does not add to the count).
+    bool append(const string& chatId, const string& messageCsv, bool replaces = false) {
+        auto it = chats.find(chatId);
+        if (it == chats.end() || !appender.is_open()) return false;
+        Entry& entry = it->second;
+
+        uint64_t length = entry.meta.size() + 1 + messageCsv.size() + 1;
+        appender << entry.meta << ',' << messageCsv << '\n';
+        appender.flush();
+        addExtent(entry, dataSize, length);
+        dataSize += length;
+
+        if (replaces) {
+            deadBytes += length;
+        } else {
+            ++entry.messageCount;
+        }
+        compactIfNeeded();
+        return true;
+    }
+
+    // Calls visit(messageCsv) for each message of the chat, oldest first;
+    // returns the number of messages
+    template <typename Visit>
+    int forEachMessage(const string& chatId, Visit visit) {
+        auto it = chats.find(chatId);
+        if (it == chats.end()) return 0;
+
+        vector<string> messages = readMessages(it->second);
+        for (const string& message : messages) visit(message);
+        it->second.messageCount = static_cast<int>(messages.size());
+        return it->second.messageCount;
+    }
+
+    // Calls visit(messageCsv) for the messages in the first maxBytes of
+    // the file, whatever chats they belong to; for sampling the text
+    template <typename Visit>
+    void sampleMessages(size_t maxBytes, Visit visit) {
+        ifstream in(path, ios::binary);
+        string line;
+        getline(in, line);    // header
+        size_t read = 0;
+        while (read < maxBytes && getline(in, line)) {
+            read += line.size() + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            string_view meta, message;
+            if (splitLine(line, meta, message)) visit(string(message));
+        }
+    }
+
+    // Rewrites the file with each chat's current lines together, then
+    // checkpoints the directory. Memory use is bounded by the largest chat.
+    bool compact() {
+        string tmpPath = path + ".tmp";
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            cout << "Error: Could not open " << tmpPath << " for writing!" << endl;
+            return false;
+        }
+        if (hooks.begin) hooks.begin();
+
+        out << header << "\n";
+        uint64_t offset = header.size() + 1;
+        map<string, Entry> rewritten;
+        size_t extents = 0;
+        for (auto& [id, entry] : chats) {
+            Entry fresh;
+            fresh.meta = entry.meta;
+            uint64_t start = offset;
+            vector<string> messages = readMessages(entry);
+            if (hooks.edit) hooks.edit(id, messages);
+            for (const string& message : messages) {
+                out << entry.meta << ',' << message << '\n';
+                offset += entry.meta.size() + 1 + message.size() + 1;
+                ++fresh.messageCount;
+            }
+            if (offset > start) {
+                fresh.extents.push_back(Extent{start, offset - start});
+                ++extents;
+            }
+            rewritten[id] = std::move(fresh);
+        }
+        out.close();
+        error_code ec;
+        if (!out || (hooks.commit && !hooks.commit())) {
+            filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        appender.close();
+        reader.close();
+        filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            openFiles();
+            return false;
+        }
+
+        chats = std::move(rewritten);
+        dataSize = offset;
+        deadBytes = 0;
+        extentCount = extents;
+        openFiles();
+        writeIndex();
+        if (hooks.done) hooks.done();
+        return true;
+    }
+
+    // Saves the directory so the next start reads it instead of the file
+    bool writeIndex() const {
+        string tmpPath = indexPath + ".tmp";
+        {
+            ofstream out(tmpPath, ios::trunc);
+            if (!out.is_open()) return false;
+            out << "chatlog 1 " << dataSize << " " << deadBytes << "\n";
+            for (const auto& [id, entry] : chats) {
+                out << entry.messageCount << '\t';
+                for (size_t i = 0; i < entry.extents.size(); ++i) {
+                    if (i) out << ';';
+                    out << entry.extents[i].offset << ':' << entry.extents[i].length;
+                }
+                out << '\t' << entry.meta << '\n';
+            }
+            if (!out) return false;
+        }
+        error_code ec;
+        filesystem::rename(tmpPath, indexPath, ec);
+        return !ec;
+    }
+
+    uint64_t getFileSize() const { return dataSize; }
+    uint64_t getDeadBytes() const { return deadBytes; }
+};
+
+// ============================================================================
+// HISTORY CACHE
+// Least-recently-used set of chats whose messages are in memory, under a
+// byte budget. Chats register with an unload callback; when the total goes
+// over budget the least recently used chats are unloaded, never the one
+// being used now.
+// ============================================================================
+class HistoryCache {
+private:
+    struct Resident {
+        const void* chat;
+        size_t bytes;
+        function<void()> unload;
+    };
+
+    list<Resident> order;    // most recently used first
+    unordered_map<const void*, list<Resident>::iterator> byChat;
+    size_t budget;
+    size_t used = 0;
+
+    void enforce() {
+        while (used > budget && order.size() > 1) {
+            Resident& victim = order.back();
+            victim.unload();
+            used -= victim.bytes;
+            byChat.erase(victim.chat);
+            order.pop_back();
+        }
+    }
+
+public:
+    explicit HistoryCache(size_t budgetBytes) : budget(budgetBytes) {}
+
+    void add(const void* chat, size_t bytes, function<void()> unload) {
+        auto it = byChat.find(chat);
+        if (it != byChat.end()) {
+            used -= it->second->bytes;
+            order.erase(it->second);
+        }
+        order.push_front(Resident{chat, bytes, std::move(unload)});
+        byChat[chat] = order.begin();
+        used += bytes;
+        enforce();
+    }
+
+    void touch(const void* chat) {
+        auto it = byChat.find(chat);
+        if (it != byChat.end()) order.splice(order.begin(), order, it->second);
+    }
+
+    // The chat got bigger (a message was added while it is loaded)
+    void grow(const void* chat, size_t bytes) {
+        auto it = byChat.find(chat);
+        if (it == byChat.end()) return;
+        it->second->bytes += bytes;
+        used += bytes;
+        order.splice(order.begin(), order, it->second);
+        enforce();
+    }
+
+    // Unloads one chat, if it is loaded
+    void remove(const void* chat) {
+        auto it = byChat.find(chat);
+        if (it == byChat.end()) return;
+        it->second->unload();
+        used -= it->second->bytes;
+        order.erase(it->second);
+        byChat.erase(it);
+    }
+
+    size_t getResidentBytes() const { return used; }
+    size_t getResidentChats() const { return order.size(); }
+    size_t getBudget() const { return budget; }
+};
+
+#endif // MESSENGER_CHAT_LOG_H
@@ -0,0 +1,369 @@
+#ifndef MESSENGER_COLD_STORE_H
+#define MESSENGER_COLD_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "RecordIO.h"
+#include "TextCodec.h"
+
+using namespace std;
+
+// ============================================================================
+// COLD STORE
+// Archived messages of one kind of chat, in immutable segment files under
+// <file>.cold/ (segment_<n>.seg). An archive pass writes one new segment:
+// for each chat, the messages leaving the hot CSV, cut into blocks of about
+// BLOCK_BYTES of CSV lines, each compressed with BlockCodec, plus an index
+// of the blocks at the end of the file.
+//
+// A chat whose archived messages are trimmed by retention is written whole
+// into the new segment, marked as replacing its blocks in older segments.
+// Segments left with no live blocks are deleted.
+//
+// Only the segment indexes are read at startup. Messages are read a block
+// at a time, by position (oldest first), when a page asks for them.
+// ============================================================================
+class ColdStore {
+public:
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+    // One archived message: its CSV (as in the hot file) and its time
+    struct Line {
+        string csv;
+        int64_t timestamp;
+    };
+
+private:
+    struct Block {
+        uint32_t segment;
+        uint64_t offset;
+        uint32_t length;
+        uint32_t messages;
+        int64_t oldest;
+        int64_t newest;
+    };
+
+    struct Chat {
+        vector<Block> blocks;   // oldest first
+        int messageCount = 0;
+    };
+
+    struct PendingChat {
+        bool replaces = false;
+        vector<Block> blocks;
+    };
+
+    static constexpr char SEGMENT_MAGIC[9] = "coldseg1";
+    static constexpr char INDEX_MAGIC[9] = "coldidx1";
+    static constexpr size_t TRAILER_SIZE = 2 * sizeof(int64_t) + 8;
+
+    string directory;
+    map<string, Chat> chats;
+    map<uint32_t, size_t> liveBlocks;    // per segment
+    uint32_t nextSegment = 1;
+
+    // The segment being written
+    ofstream writer;
+    uint64_t writeOffset = 0;
+    map<string, PendingChat> pending;
+
+    // Last block read, for paging through a chat
+    uint32_t cachedSegment = 0;
+    uint64_t cachedOffset = 0;
+    string cachedBlock;
+
+    string segmentPath(uint32_t segment) const {
+        return directory + "/segment_" + to_string(segment) + ".seg";
+    }
+
+    // Reads one segment's index; false if the file is not a complete segment
+    bool readIndex(uint32_t segment, map<string, PendingChat>& index) const {
+        ifstream in(segmentPath(segment), ios::binary | ios::ate);
+        if (!in.is_open()) return false;
+        int64_t fileSize = static_cast<int64_t>(in.tellg());
+        if (fileSize < static_cast<int64_t>(8 + TRAILER_SIZE)) return false;
+
+        char trailer[TRAILER_SIZE];
+        in.seekg(fileSize - static_cast<int64_t>(TRAILER_SIZE));
+        if (!in.read(trailer, TRAILER_SIZE) || memcmp(trailer + 16, INDEX_MAGIC, 8) != 0) return false;
+        recordio::RecordReader tail(trailer, 16);
+        int64_t indexOffset = tail.i64();
+        int64_t indexLength = tail.i64();
+        if (indexOffset < 8 || indexLength < 0 || indexOffset + indexLength > fileSize) return false;
+
+        string payload(static_cast<size_t>(indexLength), '\0');
+        in.seekg(indexOffset);
+        if (!in.read(&payload[0], indexLength)) return false;
+
+        recordio::RecordReader r(payload.data(), payload.size());
+        int32_t chatCount = r.i32();
+        for (int32_t c = 0; c < chatCount && r.good(); ++c) {
+            string chatId = r.str();
+            PendingChat& chat = index[chatId];
+            chat.replaces = r.i32() != 0;
+            int32_t blockCount = r.i32();
+            for (int32_t b = 0; b < blockCount && r.good(); ++b) {
+                Block block;
+                block.segment = segment;
+                block.offset = static_cast<uint64_t>(r.i64());
+                block.length = static_cast<uint32_t>(r.i32());
+                block.messages = static_cast<uint32_t>(r.i32());
+                block.oldest = r.i64();
+                block.newest = r.i64();
+                chat.blocks.push_back(block);
+            }
+        }
+        return r.good();
+    }
+
+    // Applies a segment's index on top of the older ones
+    void apply(const map<string, PendingChat>& index) {
+        for (const auto& [chatId, update] : index) {
+            Chat& chat = chats[chatId];
+            if (update.replaces) {
+                for (const Block& block : chat.blocks) --liveBlocks[block.segment];
+                chat.blocks.clear();
+                chat.messageCount = 0;
+            }
+            for (const Block& block : update.blocks) {
+                chat.blocks.push_back(block);
+                chat.messageCount += static_cast<int>(block.messages);
+                ++liveBlocks[block.segment];
+            }
+            if (chat.blocks.empty()) chats.erase(chatId);
+        }
+    }
+
+    void removeDeadSegments() {
+        for (auto it = liveBlocks.begin(); it != liveBlocks.end();) {
+            if (it->second == 0) {
+                error_code ec;
+                filesystem::remove(segmentPath(it->first), ec);
+                if (cachedSegment == it->first) cachedSegment = 0;
+                it = liveBlocks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const string* readBlock(const Block& block) {
+        if (cachedSegment == block.segment && cachedOffset == block.offset) return &cachedBlock;
+
+        ifstream in(segmentPath(block.segment), ios::binary);
+        string packed(block.length, '\0');
+        in.seekg(static_cast<streamoff>(block.offset));
+        if (!in.read(&packed[0], block.length) || !BlockCodec::decompress(packed, cachedBlock)) {
+            cout << "Error: Archived messages in " << segmentPath(block.segment) << " are unreadable!" << endl;
+            cachedSegment = 0;
+            return nullptr;
+        }
+        cachedSegment = block.segment;
+        cachedOffset = block.offset;
+        return &cachedBlock;
+    }
+
+    void writeBlock(PendingChat& chat, const string& data, uint32_t messages, int64_t oldest, int64_t newest) {
+        string packed = BlockCodec::compress(data);
+        writer.write(packed.data(), static_cast<streamsize>(packed.size()));
+        chat.blocks.push_back(Block{nextSegment, writeOffset, static_cast<uint32_t>(packed.size()),
+                                    messages, oldest, newest});
+        writeOffset += packed.size();
+    }
+
+public:
+    // Archive of the CSV at `file`; reads every segment's index
+    explicit ColdStore(const string& file) : directory(file + ".cold") {
+        error_code ec;
+        if (!filesystem::is_directory(directory, ec)) return;
+
+        set<uint32_t> segments;
+        for (const auto& entry : filesystem::directory_iterator(directory, ec)) {
+            string name = entry.path().filename().string();
+            unsigned long number = 0;
+            if (sscanf(name.c_str(), "segment_%lu.seg", &number) == 1 && name == "segment_" + to_string(number) + ".seg") {
+                segments.insert(static_cast<uint32_t>(number));
+            }
+        }
+        for (uint32_t segment : segments) {
+            map<string, PendingChat> index;
+            if (readIndex(segment, index)) {
+                liveBlocks[segment];
+                apply(index);
+            } else {
+                cout << "Warning: Skipping incomplete archive segment " << segmentPath(segment) << endl;
+            }
+            nextSegment = segment + 1;
+        }
+        removeDeadSegments();
+    }
+
+    ColdStore(const ColdStore&) = delete;
+    ColdStore& operator=(const ColdStore&) = delete;
+
+    ~ColdStore() {
+        abortSegment();
+    }
+
+    int messageCount(const string& chatId) const {
+        auto it = chats.find(chatId);
+        return it == chats.end() ? 0 : it->second.messageCount;
+    }
+
+    // Time of the oldest archived message of the chat; 0 if none
+    int64_t oldest(const string& chatId) const {
+        auto it = chats.find(chatId);
+        return it == chats.end() ? 0 : it->second.blocks.front().oldest;
+    }
+
+    size_t chatCount() const { return chats.size(); }
+    bool isWriting() const { return writer.is_open(); }
+    size_t segmentCount() const { return liveBlocks.size(); }
+
+    // Calls visit(messageCsv) for archived messages [first, first + count)
+    // of the chat, oldest first; only the blocks holding them are read
+    template <typename Visit>
+    void readRange(const string& chatId, int first, int count, Visit visit) {
+        auto it = chats.find(chatId);
+        if (it == chats.end() || count <= 0) return;
+
+        int position = 0;
+        int end = first + count;
+        for (const Block& block : it->second.blocks) {
+            int blockEnd = position + static_cast<int>(block.messages);
+            if (blockEnd > first && position < end) {
+                const string* data = readBlock(block);
+                if (!data) return;
+                string_view rest(*data);
+                for (int i = position; i < blockEnd && !rest.empty(); ++i) {
+                    size_t newline = rest.find('\n');
+                    string_view line = rest.substr(0, newline);
+                    rest = newline == string_view::npos ? string_view() : rest.substr(newline + 1);
+                    if (i >= first && i < end) visit(string(line));
+                }
+            }
+            position = blockEnd;
+            if (position >= end) break;
+        }
+    }
+
+    template <typename Visit>
+    void forEachMessage(const string& chatId, Visit visit) {
+        readRange(chatId, 0, messageCount(chatId), visit);
+    }
+
+    // ------------------------------------------------------------------------
+    // Writing: beginSegment(), addChat() for each chat, then commitSegment()
+    // (or abortSegment()). Nothing changes for readers until the commit.
+    // ------------------------------------------------------------------------
+    bool beginSegment() {
+        abortSegment();
+        error_code ec;
+        filesystem::create_directories(directory, ec);
+        writer.open(segmentPath(nextSegment) + ".tmp", ios::binary | ios::trunc);
+        if (!writer.is_open()) {
+            cout << "Error: Could not open " << segmentPath(nextSegment) << " for writing!" << endl;
+            return false;
+        }
+        writer.write(SEGMENT_MAGIC, 8);
+        writeOffset = 8;
+        return true;
+    }
+
+    // Archives lines (oldest first) for the chat. With `replaces`, they
+    // become the chat's whole archive (none at all if lines is empty).
+    void addChat(const string& chatId, const vector<Line>& lines, bool replaces) {
+        if (!writer.is_open() || (lines.empty() && !replaces)) return;
+        PendingChat& chat = pending[chatId];
+        chat.replaces = chat.replaces || replaces;
+
+        string data;
+        uint32_t messages = 0;
+        int64_t oldestTime = 0, newestTime = 0;
+        for (const Line& line : lines) {
+            if (messages == 0) oldestTime = newestTime = line.timestamp;
+            oldestTime = min(oldestTime, line.timestamp);
+            newestTime = max(newestTime, line.timestamp);
+            data += line.csv;
+            data += '\n';
+            ++messages;
+            if (data.size() >= BLOCK_BYTES) {
+                writeBlock(chat, data, messages, oldestTime, newestTime);
+                data.clear();
+                messages = 0;
+            }
+        }
+        if (messages) writeBlock(chat, data, messages, oldestTime, newestTime);
+    }
+
+    bool commitSegment() {
+        if (!writer.is_open()) return false;
+        if (pending.empty()) {
+            abortSegment();
+            return true;
+        }
+
+        string index;
+        recordio::putI32(index, static_cast<int32_t>(pending.size()));
+        for (const auto& [chatId, chat] : pending) {
+            recordio::putString(index, chatId);
+            recordio::putI32(index, chat.replaces ? 1 : 0);
+            recordio::putI32(index, static_cast<int32_t>(chat.blocks.size()));
+            for (const Block& block : chat.blocks) {
+                recordio::putI64(index, static_cast<int64_t>(block.offset));
+                recordio::putI32(index, static_cast<int32_t>(block.length));
+                recordio::putI32(index, static_cast<int32_t>(block.messages));
+                recordio::putI64(index, block.oldest);
+                recordio::putI64(index, block.newest);
+            }
+        }
+        string trailer;
+        recordio::putI64(trailer, static_cast<int64_t>(writeOffset));
+        recordio::putI64(trailer, static_cast<int64_t>(index.size()));
+        trailer.append(INDEX_MAGIC, 8);
+        writer.write(index.data(), static_cast<streamsize>(index.size()));
+        writer.write(trailer.data(), static_cast<streamsize>(trailer.size()));
+        writer.close();
+
+        if (!writer) {
+            abortSegment();
+            return false;
+        }
+        string finalPath = segmentPath(nextSegment);
+        error_code ec;
+        filesystem::rename(finalPath + ".tmp", finalPath, ec);
+        if (ec) {
+            abortSegment();
+            return false;
+        }
+
+        liveBlocks[nextSegment];
+        apply(pending);
+        pending.clear();
+        ++nextSegment;
+        removeDeadSegments();
+        return true;
+    }
+
+    void abortSegment() {
+        if (writer.is_open()) writer.close();
+        pending.clear();
+        error_code ec;
+        filesystem::remove(segmentPath(nextSegment) + ".tmp", ec);
+    }
+};
+
+#endif // MESSENGER_COLD_STORE_H
@@ -0,0 +1,46 @@
+#include "messenger_ui.h"
+#include "messenger_batch.h"
+#ifdef __linux__
+#include "messenger_server.h"
+#endif
+
+// Stand-alone messenger: accounts are shared with the social app through
+// users.txt; conversations and groups are kept in conversations.csv and
+// groups.csv in the working directory.
+// `messenger --batch <script | ->` runs a command script instead of the menus.
+// `messenger --serve <socket-path | port>` serves clients (MessengerServer)
+// on a Unix-domain socket, or on 127.0.0.1 if given a port number, until
+// interrupted (Linux only).
+int main(int argc, char* argv[]) {
+    UserDirectory directory;
+    MessengerManager messenger(directory);
+
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        BatchRunner runner;
+        MessengerBatch batch(messenger);
+        batch.install(runner);
+        return runner.runFile(argc > 2 ? argv[2] : "-");
+    }
+
+#ifdef __linux__
+    if (argc > 2 && string(argv[1]) == "--serve") {
+        string where = argv[2];
+        AuthenticationService auth(directory);
+        MessengerServer server(messenger, auth);
+        bool isPort = all_of(where.begin(), where.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); });
+        if (!(isPort ? server.listenTcp(atoi(where.c_str())) : server.listenUnix(where))) return 1;
+
+        signal(SIGINT, [](int) { MessengerServer::requestStop(); });
+        signal(SIGTERM, [](int) { MessengerServer::requestStop(); });
+        cout << "Serving on " << (isPort ? "127.0.0.1:" : "") << where << " (Ctrl+C to stop)" << endl;
+        server.run();
+        return 0;
+    }
+#endif
+
+    MessengerUI ui(messenger);
+
+    ui.displayWelcome();
+    ui.runLoginMenu();
+    return 0;
+}
@@ -2,25 +2,92 @@
 #define MESSENGER_MANAGER_H
 
 #include "messenger_system.h"
+#include "messenger_chat_log.h"
+#include "messenger_cold_store.h"
+#include "UserDirectory.h"
+#include "LatencyTrace.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <sstream>
 #include <iomanip>
 
+// How long a chat keeps its messages; 0 means no limit
+struct RetentionPolicy {
+    int maxAgeDays = 0;
+    int maxMessages = 0;
+};
+
+// Told about every new message after it is stored: its chat, whether that
+// is a group, the chat's participants and the message text (the Message
+// itself may hold it compressed)
+using MessageListener = function<void(const string& chatId, bool isGroup, const vector<string>& participants,
+                                      const Message& message, const string& text)>;
+
 // ============================================================================
 // MESSENGER MANAGER CLASS
 // Handles all messenger operations and data persistence
+//
+// Message histories are loaded on demand. Startup reads only the chat
+// directories of conversations.csv and groups.csv (see ChatLog), so every
+// chat starts with just its participants and message count; the messages
+// are read when the chat is opened (getConversation, getGroup, likes).
+// Loaded histories are kept under a memory budget, least recently used
+// first out. New messages and likes are appended to the files.
+//
+// Message text in memory is compressed with a SymbolTable trained on the
+// stored messages once there are enough of them, and saved next to the
+// conversations file (<file>.sym) so every later start uses the same one.
+//
+// Whenever a history file is compacted (saveConversations/saveGroups, or
+// automatically as it grows), messages older than the cold age move to the
+// chat kind's ColdStore, and retention policies drop what a chat no longer
+// keeps. The CSV and loaded histories then hold only recent messages;
+// getMessagePage() reads across both tiers. A front end can turn the
+// automatic compaction off and run compactIfDue() when it is idle.
+//
+// Every new message is also passed to the MessageListener, if one is set;
+// MessengerServer uses it to push messages to connected recipients.
 // ============================================================================
 class MessengerManager {
+public:
+    static constexpr size_t DEFAULT_HISTORY_BUDGET = 8 << 20;
+
+    // Memory charged per loaded message beyond Message::memoryBytes():
+    // its shared_ptr control block and slot in the chat's vector
+    static constexpr size_t MESSAGE_OVERHEAD = 32;
+
+    // Stored text needed before a content table is trained
+    static constexpr uint64_t CODEC_TRAINING_BYTES = 16 * 1024;
+
+    // Messages older than this are archived at the next compaction
+    static constexpr time_t DEFAULT_COLD_AGE = 30 * 24 * 60 * 60;
+
 private:
+    // Accounts are shared with the social app: a messenger user ID is a
+    // social username, and the name shown here is its display name
+    UserDirectory& directory;
+
     // In-memory storage
-    map<string, string> users;  // userId -> username (storing minimal user data)
     map<string, shared_ptr<Conversation>> conversations;
     map<string, shared_ptr<GroupChat>> groups;
 
-    // Database file paths
-    string usersFile;
-    string conversationsFile;
-    string groupsFile;
+    // Message history files and the loaded-history budget
+    ChatLog conversationLog;
+    ChatLog groupLog;
+    HistoryCache history;
+
+    // Compression of message text in memory; null until trained, then
+    // kept for good since every compressed Message points at it
+    unique_ptr<const SymbolTable> contentCodec;
+    string codecFile;
+
+    // Cold tier and retention
+    ColdStore conversationArchive;
+    ColdStore groupArchive;
+    unordered_set<string> trimmedChats;   // lost messages in this compaction
+    time_t coldAge;
+    map<string, RetentionPolicy> retentionPolicies;
+    string retentionFile;
 
     // Counters for ID generation
     int messageCounter;
@@ -31,6 +98,8 @@ private:
     string currentUserId;
     bool isLoggedIn;
 
+    MessageListener messageListener;
+
     // Helper functions
     string generateMessageId() {
         return "msg_" + to_string(++messageCounter) + "_" + to_string(time(nullptr));
@@ -48,18 +117,223 @@ private:
 
     // Validation
     bool userExists(const string& userId) const {
-        return users.find(userId) != users.end();
+        return directory.findByName(userId) != nullptr;
+    }
+
+    static string conversationMeta(const Conversation& conv) {
+        const auto& participants = conv.getParticipantIdsView();
+        return conv.getConversationId() + "," + participants[0] + "," + participants[1];
+    }
+
+    static string groupMeta(const GroupChat& group) {
+        string meta = group.getGroupId() + "," + group.getGroupName() + "," + group.getAdminId() + ",";
+        const auto& participants = group.getParticipantIdsView();
+        for (size_t i = 0; i < participants.size(); i++) {
+            meta += participants[i];
+            if (i < participants.size() - 1) meta += ';';
+        }
+        return meta;
+    }
+
+    // Reads a chat's messages from its log unless they are in memory
+    template <typename Chat>
+    void loadHistory(const shared_ptr<Chat>& chat, ChatLog& log, const string& chatId) {
+        if (chat->isHistoryLoaded()) {
+            history.touch(chat.get());
+            return;
+        }
+        TRACE_SCOPE("MessengerManager::loadHistory");
+
+        vector<shared_ptr<Message>> messages;
+        size_t bytes = 0;
+        log.forEachMessage(chatId, [&](const string& csv) {
+            auto message = make_shared<Message>(Message::fromCSV(csv));
+            message->compressContent(contentCodec.get());
+            bytes += message->memoryBytes() + MESSAGE_OVERHEAD;
+            messages.push_back(std::move(message));
+        });
+        chat->loadMessages(std::move(messages));
+        trackHistory(chat.get(), bytes);
+    }
+
+    template <typename Chat>
+    void trackHistory(Chat* chat, size_t bytes) {
+        history.add(chat, bytes, [chat] { chat->unloadMessages(); });
+    }
+
+    // Appends a new or changed message to its chat's log
+    template <typename Chat>
+    void recordMessage(Chat* chat, ChatLog& log, const string& chatId, Message& message,
+                       bool replaces) {
+        log.append(chatId, message.toCSV(), replaces);
+        if (!contentCodec && log.getFileSize() >= CODEC_TRAINING_BYTES) trainContentCodec();
+        if (replaces) {
+            if (chat->isHistoryLoaded()) history.touch(chat);
+            return;
+        }
+        message.compressContent(contentCodec.get());
+        if (chat->isHistoryLoaded()) history.grow(chat, message.memoryBytes() + MESSAGE_OVERHEAD);
+    }
+
+    // Learns the content table from the start of both message files
+    void trainContentCodec() {
+        TRACE_SCOPE("MessengerManager::trainContentCodec");
+        vector<string> sample;
+        size_t sampled = 0;
+        auto collect = [&](const string& csv) {
+            sample.push_back(Message::fromCSV(csv).getContent());
+            sampled += sample.back().size();
+        };
+        conversationLog.sampleMessages(2 * SymbolTable::SAMPLE_BYTES, collect);
+        groupLog.sampleMessages(2 * SymbolTable::SAMPLE_BYTES, collect);
+        if (sampled == 0) return;
+
+        auto table = make_unique<SymbolTable>(SymbolTable::train(sample));
+        if (!table->save(codecFile)) {
+            cout << "Error: Could not open " << codecFile << " for writing!" << endl;
+        }
+        contentCodec = std::move(table);
+    }
+
+    static int64_t timestampOf(const string& csv) {
+        return static_cast<int64_t>(Message::fromCSV(csv).getTimestamp());
+    }
+
+    // Runs while a history file is compacted: drops what the chat's
+    // retention no longer keeps, then moves messages older than the cold
+    // age (oldest first, so the file keeps the newest) into the archive
+    void archiveMessages(ColdStore& archive, const string& chatId, vector<string>& messages) {
+        if (!archive.isWriting()) return;
+        RetentionPolicy policy = getRetention(chatId);
+        int64_t now = static_cast<int64_t>(time(nullptr));
+        int64_t ageCutoff = policy.maxAgeDays > 0 ? now - policy.maxAgeDays * 86400LL : INT64_MIN;
+        int64_t coldCutoff = now - static_cast<int64_t>(coldAge);
+
+        int cold = archive.messageCount(chatId);
+        int total = cold + static_cast<int>(messages.size());
+        int dropCount = policy.maxMessages > 0 && total > policy.maxMessages ? total - policy.maxMessages : 0;
+
+        // Retention reaching into the archive rewrites the chat's archive
+        vector<ColdStore::Line> archived;
+        bool rewrite = cold > 0 && (dropCount > 0 || archive.oldest(chatId) < ageCutoff);
+        int position = 0;
+        if (rewrite) {
+            archive.forEachMessage(chatId, [&](const string& csv) {
+                int64_t ts = timestampOf(csv);
+                if (position++ >= dropCount && ts >= ageCutoff) archived.push_back({csv, ts});
+            });
+        } else {
+            position = cold;
+        }
+
+        size_t keepFrom = 0;
+        for (; keepFrom < messages.size(); ++keepFrom, ++position) {
+            int64_t ts = timestampOf(messages[keepFrom]);
+            bool expired = position < dropCount || ts < ageCutoff;
+            if (!expired && ts >= coldCutoff) break;
+            if (!expired) archived.push_back({messages[keepFrom], ts});
+        }
+        messages.erase(messages.begin(), messages.begin() + static_cast<ptrdiff_t>(keepFrom));
+        if (keepFrom > 0) trimmedChats.insert(chatId);
+        archive.addChat(chatId, archived, rewrite);
+    }
+
+    // After a compaction, a loaded history that lost messages to the
+    // archive or retention goes back to counts only; the others still
+    // match the file and stay loaded
+    template <typename Chat>
+    void refreshChats(const ChatLog& log, const ColdStore& archive, map<string, shared_ptr<Chat>>& chats) {
+        for (auto& [chatId, chat] : chats) {
+            if (chat->isHistoryLoaded() && !trimmedChats.count(chatId)) {
+                chat->setArchivedCount(archive.messageCount(chatId));
+                continue;
+            }
+            history.remove(chat.get());
+            auto entry = log.getChats().find(chatId);
+            chat->markUnloaded(entry == log.getChats().end() ? 0 : entry->second.messageCount);
+            chat->setArchivedCount(archive.messageCount(chatId));
+        }
+        trimmedChats.clear();
+    }
+
+    template <typename Chat>
+    ChatLog::CompactionHooks archiveHooks(ChatLog& log, ColdStore& archive, map<string, shared_ptr<Chat>>& chats) {
+        ChatLog::CompactionHooks hooks;
+        hooks.begin = [this, &archive] {
+            trimmedChats.clear();
+            archive.beginSegment();
+        };
+        hooks.edit = [this, &archive](const string& chatId, vector<string>& messages) {
+            archiveMessages(archive, chatId, messages);
+        };
+        hooks.commit = [&archive] { return !archive.isWriting() || archive.commitSegment(); };
+        hooks.done = [this, &log, &archive, &chats] { refreshChats(log, archive, chats); };
+        return hooks;
+    }
+
+    // Messages [offset, offset + limit) of one chat across both tiers
+    template <typename Chat>
+    vector<shared_ptr<Message>> collectPage(const shared_ptr<Chat>& chat, ChatLog& log, ColdStore& archive,
+                                            const string& chatId, int offset, int limit) {
+        TRACE_SCOPE("MessengerManager::getMessagePage");
+        vector<shared_ptr<Message>> page;
+        int archived = chat->getArchivedCount();
+        if (offset < archived) {
+            archive.readRange(chatId, offset, min(limit, archived - offset), [&](const string& csv) {
+                auto message = make_shared<Message>(Message::fromCSV(csv));
+                message->compressContent(contentCodec.get());
+                page.push_back(std::move(message));
+            });
+        }
+
+        int hotFirst = max(0, offset - archived);
+        int hotEnd = offset + limit - archived;
+        if (hotEnd > hotFirst) {
+            loadHistory(chat, log, chatId);
+            const auto& hot = chat->getMessagesView();
+            for (int i = hotFirst; i < hotEnd && i < static_cast<int>(hot.size()); ++i) page.push_back(hot[i]);
+        }
+        return page;
+    }
+
+    void loadRetention() {
+        ifstream file(retentionFile);
+        string chatId;
+        RetentionPolicy policy;
+        while (file >> chatId >> policy.maxAgeDays >> policy.maxMessages) {
+            retentionPolicies[chatId] = policy;
+        }
+    }
+
+    void saveRetention() const {
+        ofstream file(retentionFile);
+        if (!file.is_open()) {
+            cout << "Error: Could not open " << retentionFile << " for writing!" << endl;
+            return;
+        }
+        for (const auto& [chatId, policy] : retentionPolicies) {
+            file << chatId << " " << policy.maxAgeDays << " " << policy.maxMessages << "\n";
+        }
     }
 
 public:
     // Constructor
-    MessengerManager(const string& usersDB = "users.csv",
-                    const string& conversationsDB = "conversations.csv",
-                    const string& groupsDB = "groups.csv")
-        : usersFile(usersDB), conversationsFile(conversationsDB), 
-          groupsFile(groupsDB), messageCounter(0), conversationCounter(0), 
+    explicit MessengerManager(UserDirectory& users,
+                              const string& conversationsDB = "conversations.csv",
+                              const string& groupsDB = "groups.csv",
+                              size_t historyBudget = DEFAULT_HISTORY_BUDGET)
+        : directory(users),
+          conversationLog(conversationsDB, "conversationId,participant1,participant2,messageData", 3),
+          groupLog(groupsDB, "groupId,groupName,adminId,participants,messageData", 4),
+          history(historyBudget), codecFile(conversationsDB + ".sym"),
+          conversationArchive(conversationsDB), groupArchive(groupsDB),
+          coldAge(DEFAULT_COLD_AGE), retentionFile(conversationsDB + ".retention"),
+          messageCounter(0), conversationCounter(0),
           groupCounter(0), currentUserId(""), isLoggedIn(false) {
+        loadRetention();
         loadDatabase();
+        conversationLog.setCompactionHooks(archiveHooks(conversationLog, conversationArchive, conversations));
+        groupLog.setCompactionHooks(archiveHooks(groupLog, groupArchive, groups));
     }
 
     // ========================================================================
@@ -72,18 +346,26 @@ public:
         }
         currentUserId = userId;
         isLoggedIn = true;
-        cout << "Logged in as: " << users[userId] << " (ID: " << userId << ")" << endl;
+        cout << "Logged in as: " << getUsernameView(userId) << " (ID: " << userId << ")" << endl;
         return true;
     }
 
     void logout() {
         if (isLoggedIn) {
-            cout << "Logged out: " << users[currentUserId] << endl;
+            cout << "Logged out: " << getUsernameView(currentUserId) << endl;
             currentUserId = "";
             isLoggedIn = false;
         }
     }
 
+    // Switches the session without the console messages, for front ends
+    // that serve several users at once (MessengerServer). The user must
+    // exist; an empty ID logs out.
+    void setCurrentUser(const string& userId) {
+        currentUserId = userId;
+        isLoggedIn = !userId.empty();
+    }
+
     bool checkLoggedIn() const {
         if (!isLoggedIn) {
             cout << "Error: You must be logged in to perform this action!" << endl;
@@ -96,9 +378,13 @@ public:
         return currentUserId;
     }
 
+    string_view getCurrentUserIdView() const {
+        return currentUserId;
+    }
+
     string getCurrentUsername() const {
         if (isLoggedIn) {
-            return users.at(currentUserId);
+            return string(getUsernameView(currentUserId));
         }
         return "";
     }
@@ -115,8 +401,10 @@ public:
             cout << "Error: User ID already exists!" << endl;
             return false;
         }
-        users[userId] = username;
-        saveUsers();
+        if (!directory.addUser(userId, "", username)) {
+            cout << "Error: User ID must not be empty or contain spaces or commas!" << endl;
+            return false;
+        }
         cout << "User registered: " << username << " (ID: " << userId << ")" << endl;
         return true;
     }
@@ -126,25 +414,28 @@ public:
     }
 
     string getUsername(const string& userId) const {
-        auto it = users.find(userId);
-        if (it != users.end()) {
-            return it->second;
-        }
-        return "";
+        return string(getUsernameView(userId));
+    }
+
+    // Non-owning lookup for render loops; empty for unknown users
+    string_view getUsernameView(string_view userId) const {
+        const User* user = static_cast<const UserDirectory&>(directory).findByName(userId);
+        return user ? user->getDisplayNameView() : string_view();
     }
 
     vector<pair<string, string>> getAllUsers() const {
         vector<pair<string, string>> allUsers;
-        for (const auto& pair : users) {
-            allUsers.push_back({pair.first, pair.second});
+        for (const auto& user : static_cast<const UserDirectory&>(directory).getUsers()) {
+            allUsers.push_back({user.getUsername(), string(user.getDisplayNameView())});
         }
         return allUsers;
     }
 
     void displayAllUsers() const {
-        cout << "\n=== Registered Users ===" << endl;
-        for (const auto& pair : users) {
-            cout << "ID: " << pair.first << " | Name: " << pair.second << endl;
+        RenderBuffer out;
+        out << "\n=== Registered Users ===\n";
+        for (const auto& user : static_cast<const UserDirectory&>(directory).getUsers()) {
+            out << "ID: " << user.getUsernameView() << " | Name: " << user.getDisplayNameView() << '\n';
         }
     }
 
@@ -152,6 +443,7 @@ public:
     // MESSAGING (One-on-One)
     // ========================================================================
     shared_ptr<Message> sendMessage(const string& receiverId, const string& content) {
+        TRACE_SCOPE("MessengerManager::sendMessage");
         // Check if logged in
         if (!checkLoggedIn()) return nullptr;
 
@@ -174,6 +466,8 @@ public:
         if (it == conversations.end()) {
             conv = make_shared<Conversation>(convId, currentUserId, receiverId);
             conversations[convId] = conv;
+            conversationLog.addChat(convId, conversationMeta(*conv));
+            trackHistory(conv.get(), 0);
         } else {
             conv = it->second;
         }
@@ -183,7 +477,8 @@ public:
         conv->addMessage(message);
 
         // Save to database
-        saveConversations();
+        recordMessage(conv.get(), conversationLog, convId, *message, false);
+        if (messageListener) messageListener(convId, false, conv->getParticipantIdsView(), *message, content);
 
         cout << "Message sent to " << getUsername(receiverId) << endl;
 
@@ -194,6 +489,7 @@ public:
         string convId = generateConversationId(user1, user2);
         auto it = conversations.find(convId);
         if (it != conversations.end()) {
+            loadHistory(it->second, conversationLog, convId);
             return it->second;
         }
         return nullptr;
@@ -249,7 +545,8 @@ public:
         }
 
         groups[group->getGroupId()] = group;
-        saveGroups();
+        groupLog.addChat(group->getGroupId(), groupMeta(*group));
+        trackHistory(group.get(), 0);
 
         cout << "Group created: " << groupName << " (You are the admin)" << endl;
         cout << "Total members: " << group->getParticipantCount() << endl;
@@ -258,6 +555,7 @@ public:
     }
 
     shared_ptr<Message> sendGroupMessage(const string& groupId, const string& content) {
+        TRACE_SCOPE("MessengerManager::sendGroupMessage");
         // Check if logged in
         if (!checkLoggedIn()) return nullptr;
 
@@ -281,7 +579,8 @@ public:
         group->addMessage(message);
 
         // Save to database
-        saveGroups();
+        recordMessage(group.get(), groupLog, groupId, *message, false);
+        if (messageListener) messageListener(groupId, true, group->getParticipantIdsView(), *message, content);
 
         cout << "Message sent to " << group->getGroupName() << endl;
 
@@ -291,6 +590,7 @@ public:
     shared_ptr<GroupChat> getGroup(const string& groupId) {
         auto it = groups.find(groupId);
         if (it != groups.end()) {
+            loadHistory(it->second, groupLog, groupId);
             return it->second;
         }
         return nullptr;
@@ -319,6 +619,92 @@ public:
         return userGroups;
     }
 
+    // One listener at most; an empty function removes it
+    void setMessageListener(MessageListener listener) {
+        messageListener = std::move(listener);
+    }
+
+    // ========================================================================
+    // HISTORY PAGES, ARCHIVE AND RETENTION
+    // ========================================================================
+    // Messages [offset, offset + limit) of a chat, oldest first, counting
+    // archived messages (getArchivedCount() of them come first). Archived
+    // messages are read from the cold store and not kept in memory.
+    vector<shared_ptr<Message>> getMessagePage(const string& chatId, bool isGroup, int offset, int limit) {
+        if (!checkLoggedIn()) return {};
+        if (offset < 0 || limit <= 0) return {};
+
+        if (isGroup) {
+            auto it = groups.find(chatId);
+            if (it == groups.end() || !it->second->isParticipant(currentUserId)) {
+                cout << "Error: You are not a member of this group!" << endl;
+                return {};
+            }
+            return collectPage(it->second, groupLog, groupArchive, chatId, offset, limit);
+        }
+        auto it = conversations.find(chatId);
+        if (it == conversations.end() || !it->second->isParticipant(currentUserId)) {
+            cout << "Error: You are not a participant in this conversation!" << endl;
+            return {};
+        }
+        return collectPage(it->second, conversationLog, conversationArchive, chatId, offset, limit);
+    }
+
+    // Messages older than this leave memory and the CSV at the next archive
+    void setColdAge(time_t seconds) { coldAge = seconds; }
+    time_t getColdAge() const { return coldAge; }
+
+    RetentionPolicy getRetention(const string& chatId) const {
+        auto it = retentionPolicies.find(chatId);
+        return it == retentionPolicies.end() ? RetentionPolicy() : it->second;
+    }
+
+    // Either participant sets a conversation's policy; a group's is set by
+    // its admin. Takes effect at the next archive pass.
+    bool setRetention(const string& chatId, bool isGroup, const RetentionPolicy& policy) {
+        if (!checkLoggedIn()) return false;
+        if (policy.maxAgeDays < 0 || policy.maxMessages < 0) {
+            cout << "Error: Retention limits cannot be negative!" << endl;
+            return false;
+        }
+
+        if (isGroup) {
+            auto it = groups.find(chatId);
+            if (it == groups.end() || !it->second->isAdmin(currentUserId)) {
+                cout << "Error: Only the group admin can change retention!" << endl;
+                return false;
+            }
+        } else {
+            auto it = conversations.find(chatId);
+            if (it == conversations.end() || !it->second->isParticipant(currentUserId)) {
+                cout << "Error: You are not a participant in this conversation!" << endl;
+                return false;
+            }
+        }
+
+        if (policy.maxAgeDays == 0 && policy.maxMessages == 0) {
+            retentionPolicies.erase(chatId);
+        } else {
+            retentionPolicies[chatId] = policy;
+        }
+        saveRetention();
+        cout << "Retention set for " << chatId << ": "
+             << (policy.maxAgeDays ? to_string(policy.maxAgeDays) + " day(s)" : string("no age limit")) << ", "
+             << (policy.maxMessages ? to_string(policy.maxMessages) + " message(s)" : string("no count limit"))
+             << endl;
+        return true;
+    }
+
+    // Archives old messages and applies retention now (compacts both files)
+    void archiveOldMessages() {
+        TRACE_SCOPE("MessengerManager::archiveOldMessages");
+        saveConversations();
+        saveGroups();
+        cout << "Archive: " << conversationArchive.chatCount() + groupArchive.chatCount()
+             << " chat(s) with archived messages in "
+             << conversationArchive.segmentCount() + groupArchive.segmentCount() << " segment(s)" << endl;
+    }
+
     // ========================================================================
     // LIKES
     // ========================================================================
@@ -338,6 +724,7 @@ public:
         } else {
             auto it = conversations.find(chatId);
             if (it != conversations.end() && it->second->isParticipant(currentUserId)) {
+                loadHistory(it->second, conversationLog, chatId);
                 message = it->second->findMessage(messageId);
             } else {
                 cout << "Error: You are not a participant in this conversation!" << endl;
@@ -349,15 +736,10 @@ public:
             bool result = message->addLike(currentUserId);
             if (result) {
                 cout << "Message liked!" << endl;
+                saveLikes(chatId, *message, isGroup);
             } else {
                 cout << "You already liked this message!" << endl;
             }
-            // Save changes
-            if (isGroup) {
-                saveGroups();
-            } else {
-                saveConversations();
-            }
             return result;
         }
 
@@ -378,6 +760,7 @@ public:
         } else {
             auto it = conversations.find(chatId);
             if (it != conversations.end() && it->second->isParticipant(currentUserId)) {
+                loadHistory(it->second, conversationLog, chatId);
                 message = it->second->findMessage(messageId);
             }
         }
@@ -386,15 +769,10 @@ public:
             bool result = message->removeLike(currentUserId);
             if (result) {
                 cout << "Like removed!" << endl;
+                saveLikes(chatId, *message, isGroup);
             } else {
                 cout << "You haven't liked this message!" << endl;
             }
-            // Save changes
-            if (isGroup) {
-                saveGroups();
-            } else {
-                saveConversations();
-            }
             return result;
         }
 
@@ -404,165 +782,108 @@ public:
     // ========================================================================
     // DATABASE OPERATIONS
     // ========================================================================
-    void saveUsers() {
-        ofstream file(usersFile);
-        if (!file.is_open()) {
-            cout << "Error: Could not open users file for writing!" << endl;
-            return;
-        }
-
-        file << "userId,username\n";
-        for (const auto& pair : users) {
-            file << pair.first << "," << pair.second << "\n";
+    // A changed message is appended again; the newer line wins on load
+    void saveLikes(const string& chatId, Message& message, bool isGroup) {
+        if (isGroup) {
+            recordMessage(groups[chatId].get(), groupLog, chatId, message, true);
+        } else {
+            recordMessage(conversations[chatId].get(), conversationLog, chatId, message, true);
         }
-        file.close();
     }
 
+    // Messages are appended as they are sent, so saving only rewrites the
+    // files without superseded lines, archives old messages and
+    // checkpoints the directories
     void saveConversations() {
-        ofstream file(conversationsFile);
-        if (!file.is_open()) {
+        TRACE_SCOPE("MessengerManager::saveConversations");
+        if (!conversationLog.compact()) {
             cout << "Error: Could not open conversations file for writing!" << endl;
-            return;
         }
-
-        file << "conversationId,participant1,participant2,messageData\n";
-        for (const auto& pair : conversations) {
-            auto conv = pair.second;
-            auto participants = conv->getParticipantIds();
-            
-            for (const auto& msg : conv->getMessages()) {
-                file << conv->getConversationId() << ","
-                     << participants[0] << ","
-                     << participants[1] << ","
-                     << msg->toCSV() << "\n";
-            }
-        }
-        file.close();
     }
 
     void saveGroups() {
-        ofstream file(groupsFile);
-        if (!file.is_open()) {
+        TRACE_SCOPE("MessengerManager::saveGroups");
+        if (!groupLog.compact()) {
             cout << "Error: Could not open groups file for writing!" << endl;
-            return;
         }
+    }
 
-        file << "groupId,groupName,adminId,participants,messageData\n";
-        for (const auto& pair : groups) {
-            auto group = pair.second;
-            
-            // Serialize participants
-            stringstream participantsSS;
-            auto participants = group->getParticipantIds();
-            for (size_t i = 0; i < participants.size(); i++) {
-                participantsSS << participants[i];
-                if (i < participants.size() - 1) participantsSS << ";";
-            }
+    // Off: sending and liking never compact a history file; the caller
+    // runs compactIfDue() instead (MessengerServer, between requests)
+    void setAutoCompact(bool on) {
+        conversationLog.setAutoCompact(on);
+        groupLog.setAutoCompact(on);
+    }
 
-            for (const auto& msg : group->getMessages()) {
-                file << group->getGroupId() << ","
-                     << group->getGroupName() << ","
-                     << group->getAdminId() << ","
-                     << participantsSS.str() << ","
-                     << msg->toCSV() << "\n";
-            }
-        }
-        file.close();
+    bool isCompactionDue() const {
+        return conversationLog.needsCompaction() || groupLog.needsCompaction();
+    }
+
+    // Compacts the history files that have grown enough to need it
+    void compactIfDue() {
+        if (conversationLog.needsCompaction()) saveConversations();
+        if (groupLog.needsCompaction()) saveGroups();
     }
 
     void loadDatabase() {
-        loadUsers();
+        TRACE_SCOPE("MessengerManager::loadDatabase");
         loadConversations();
         loadGroups();
-    }
-
-    void loadUsers() {
-        ifstream file(usersFile);
-        if (!file.is_open()) {
-            return;  // File doesn't exist yet
-        }
 
-        string line;
-        getline(file, line);  // Skip header
+        // New IDs continue after the stored ones; a reused message ID
+        // would read as a newer version of the old message
+        for (const auto& pair : conversations) messageCounter += pair.second->getMessageCount();
+        for (const auto& pair : groups) messageCounter += pair.second->getMessageCount();
+        groupCounter = static_cast<int>(groups.size());
 
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string userId, username;
-            getline(ss, userId, ',');
-            getline(ss, username);
-            users[userId] = username;
+        auto table = make_unique<SymbolTable>();
+        if (table->load(codecFile)) {
+            contentCodec = std::move(table);
+        } else if (conversationLog.getFileSize() + groupLog.getFileSize() >= CODEC_TRAINING_BYTES) {
+            trainContentCodec();
         }
-        file.close();
-        cout << "Loaded " << users.size() << " users from database" << endl;
     }
 
+    // Builds each conversation from the directory, messages left on disk
     void loadConversations() {
-        ifstream file(conversationsFile);
-        if (!file.is_open()) {
-            return;
-        }
-
-        string line;
-        getline(file, line);  // Skip header
-
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string convId, p1, p2, msgData;
-            getline(ss, convId, ',');
+        for (const auto& [convId, entry] : conversationLog.getChats()) {
+            stringstream ss(entry.meta);
+            string id, p1, p2;
+            getline(ss, id, ',');
             getline(ss, p1, ',');
             getline(ss, p2, ',');
-            getline(ss, msgData);
-
-            // Get or create conversation
-            if (conversations.find(convId) == conversations.end()) {
-                conversations[convId] = make_shared<Conversation>(convId, p1, p2);
-            }
 
-            // Add message
-            auto msg = make_shared<Message>(Message::fromCSV(msgData));
-            conversations[convId]->addMessage(msg);
+            auto conv = make_shared<Conversation>(convId, p1, p2);
+            conv->markUnloaded(entry.messageCount);
+            conv->setArchivedCount(conversationArchive.messageCount(convId));
+            conversations[convId] = conv;
         }
-        file.close();
         cout << "Loaded " << conversations.size() << " conversations from database" << endl;
     }
 
     void loadGroups() {
-        ifstream file(groupsFile);
-        if (!file.is_open()) {
-            return;
-        }
-
-        string line;
-        getline(file, line);  // Skip header
-
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string groupId, groupName, adminId, participantsStr, msgData;
-            getline(ss, groupId, ',');
+        for (const auto& [groupId, entry] : groupLog.getChats()) {
+            stringstream ss(entry.meta);
+            string id, groupName, adminId, participantsStr;
+            getline(ss, id, ',');
             getline(ss, groupName, ',');
             getline(ss, adminId, ',');
-            getline(ss, participantsStr, ',');
-            getline(ss, msgData);
-
-            // Get or create group
-            if (groups.find(groupId) == groups.end()) {
-                groups[groupId] = make_shared<GroupChat>(groupId, groupName, adminId);
-                
-                // Add participants
-                stringstream pSS(participantsStr);
-                string userId;
-                while (getline(pSS, userId, ';')) {
-                    if (!userId.empty() && userId != adminId) {
-                        groups[groupId]->addParticipant(userId, adminId);
-                    }
+            getline(ss, participantsStr);
+
+            auto group = make_shared<GroupChat>(groupId, groupName, adminId);
+
+            // Add participants
+            stringstream pSS(participantsStr);
+            string userId;
+            while (getline(pSS, userId, ';')) {
+                if (!userId.empty() && userId != adminId) {
+                    group->addParticipant(userId, adminId);
                 }
             }
-
-            // Add message
-            auto msg = make_shared<Message>(Message::fromCSV(msgData));
-            groups[groupId]->addMessage(msg);
+            group->markUnloaded(entry.messageCount);
+            group->setArchivedCount(groupArchive.messageCount(groupId));
+            groups[groupId] = group;
         }
-        file.close();
         cout << "Loaded " << groups.size() << " groups from database" << endl;
     }
 
@@ -570,10 +891,11 @@ public:
     // UTILITY FUNCTIONS
     // ========================================================================
     void displayStatistics() const {
-        cout << "\n=== Messenger Statistics ===" << endl;
-        cout << "Total Users: " << users.size() << endl;
-        cout << "Total Conversations: " << conversations.size() << endl;
-        cout << "Total Groups: " << groups.size() << endl;
+        RenderBuffer out;
+        out << "\n=== Messenger Statistics ===\n";
+        out << "Total Users: " << directory.size() << '\n';
+        out << "Total Conversations: " << conversations.size() << '\n';
+        out << "Total Groups: " << groups.size() << '\n';
         
         int totalMessages = 0;
         for (const auto& pair : conversations) {
@@ -582,7 +904,10 @@ public:
         for (const auto& pair : groups) {
             totalMessages += pair.second->getMessageCount();
         }
-        cout << "Total Messages: " << totalMessages << endl;
+        out << "Total Messages: " << totalMessages << '\n';
+        out << "Loaded Histories: " << history.getResidentChats() << " ("
+            << history.getResidentBytes() / 1024 << " KiB of "
+            << history.getBudget() / 1024 << " KiB)\n";
     }
 };
 
@@ -0,0 +1,90 @@
+#ifndef MESSENGER_PROTOCOL_H
+#define MESSENGER_PROTOCOL_H
+
+#include "RecordIO.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// ============================================================================
+// MESSENGER WIRE PROTOCOL
+// Frames exchanged with MessengerServer. A frame is a RecordIO record,
+// u8 type | u32 payload length | payload, with integers in host byte order
+// (the server is only reachable on the same machine) and strings as u32
+// length + bytes.
+//
+// Requests on one connection are answered in order, one OK, ERROR or
+// MESSAGES frame each. PUSH frames for subscribed connections can arrive
+// between replies.
+// ============================================================================
+namespace wire {
+
+enum class FrameType : uint8_t {
+    // Requests                         payload
+    REGISTER = 1,                    // userId, name, password
+    LOGIN = 2,                       // userId, password
+    SUBSCRIBE = 3,                   // -: push new messages in my chats
+    SEND = 4,                        // receiverId, text
+    GROUP_CREATE = 5,                // name, members (comma-separated)
+    GROUP_SEND = 6,                  // groupId, text
+    PAGE = 7,                        // chatId, i32 isGroup, i32 offset, i32 limit
+    LIKE = 8,                        // messageId, chatId, i32 isGroup
+    RESUME = 9,                      // session token from an earlier LOGIN
+
+    // Replies and pushes
+    OK = 64,                         // session token, user ID (RESUME), new message or group ID, else empty
+    ERROR = 65,                      // the manager's error message
+    MESSAGES = 66,                   // i32 count, count x message
+    PUSH = 67,                       // chatId, i32 isGroup, message
+};
+// message = messageId, senderId, text, i64 timestamp
+
+// Larger frames are a protocol error and close the connection
+const size_t MAX_FRAME = 1 << 20;
+
+// Starts a frame at the end of out; returns where its payload begins
+inline size_t beginFrame(string& out, FrameType type) {
+    out.push_back(static_cast<char>(type));
+    out.append(sizeof(uint32_t), '\0');
+    return out.size();
+}
+
+// Fills in the payload length of the frame begun at payloadStart
+inline void endFrame(string& out, size_t payloadStart) {
+    uint32_t length = static_cast<uint32_t>(out.size() - payloadStart);
+    memcpy(&out[payloadStart - sizeof(length)], &length, sizeof(length));
+}
+
+inline void putMessage(string& out, string_view messageId, string_view senderId, string_view text,
+                       int64_t timestamp) {
+    recordio::putString(out, messageId);
+    recordio::putString(out, senderId);
+    recordio::putString(out, text);
+    recordio::putI64(out, timestamp);
+}
+
+// Calls visit(type, reader) for each complete frame at the front of data
+// and returns the bytes they used. Returns SIZE_MAX if a frame is larger
+// than MAX_FRAME or visit returns false.
+template <typename Visit>
+size_t forEachFrame(const char* data, size_t size, Visit visit) {
+    size_t pos = 0;
+    while (size - pos >= recordio::RECORD_HEADER_SIZE) {
+        uint32_t length = 0;
+        memcpy(&length, data + pos + 1, sizeof(length));
+        if (length > MAX_FRAME) return SIZE_MAX;
+        if (size - pos - recordio::RECORD_HEADER_SIZE < length) break;
+
+        recordio::RecordReader reader(data + pos + recordio::RECORD_HEADER_SIZE, length);
+        if (!visit(static_cast<FrameType>(data[pos]), reader)) return SIZE_MAX;
+        pos += recordio::RECORD_HEADER_SIZE + length;
+    }
+    return pos;
+}
+
+} // namespace wire
+
+#endif // MESSENGER_PROTOCOL_H
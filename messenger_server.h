@@ -0,0 +1,585 @@
+#ifndef MESSENGER_SERVER_H
+#define MESSENGER_SERVER_H
+
+#include "AuthenticationService.h"
+#include "messenger_manager.h"
+#include "messenger_protocol.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ============================================================================
+// MESSENGER SERVER
+// Serves one MessengerManager to many clients over a Unix-domain socket or
+// a loopback TCP port, speaking the frames of messenger_protocol.h. Linux
+// only (epoll).
+//
+// Everything runs on one thread around one epoll set: the manager is not
+// thread-safe and its operations are short, so the loop never blocks on
+// anything but epoll_wait. Sockets are non-blocking and edge-triggered.
+//
+// Each connection logs in as one user with its password, or with a session
+// token (AuthenticationService) from an earlier login, and the manager's
+// session is switched to that user before each of its requests. A session
+// that has expired logs the connection out again. Accounts registered
+// without a password (from the messenger's menus) cannot log in here. The manager's console
+// output during a request is captured, and becomes the text of an ERROR
+// reply when the request fails.
+//
+// Replies and pushes are queued on their connection and written once per
+// loop iteration, so a burst of requests or pushes costs one send(). A
+// subscribed connection gets a PUSH for every new message in its user's
+// chats that someone else sent. A connection whose unsent output passes
+// MAX_PENDING has stopped reading and is closed.
+//
+// At most MAX_READ bytes are read from a connection per wakeup, so one fast
+// sender cannot hold up the others; a connection with more to read is
+// retried after the next epoll_wait, which then does not block.
+//
+// History files are not compacted while a request is handled: the manager's
+// automatic compaction is off, and the loop runs it once no event has come
+// for COMPACT_IDLE_MS, or after COMPACT_MAX_DELAY_MS without such a pause.
+// ============================================================================
+class MessengerServer {
+public:
+    static constexpr size_t MAX_PENDING = 8 << 20;
+    static constexpr size_t MAX_READ = 256 << 10;
+    static constexpr int COMPACT_IDLE_MS = 200;
+    static constexpr int COMPACT_MAX_DELAY_MS = 60 * 1000;
+    static constexpr int MAX_EVENTS = 256;
+
+private:
+    struct Connection {
+        int fd;
+        string in;                   // received bytes, not yet a whole frame
+        string out;                  // queued replies and pushes
+        size_t outSent = 0;          // bytes of out already written
+        string userId;               // empty until LOGIN or RESUME succeeds
+        string token;                // session behind userId
+        bool subscribed = false;
+        bool queued = false;         // listed in pendingWrites
+        bool moreToRead = false;     // listed in pendingReads
+        bool closed = false;
+    };
+
+    MessengerManager& messenger;
+    AuthenticationService& auth;
+    int epollFd = -1;
+    int listenFd = -1;
+    string socketPath;               // removed again on shutdown
+
+    unordered_map<int, unique_ptr<Connection>> connections;
+    unordered_map<string, vector<Connection*>> subscribers;
+    vector<Connection*> pendingWrites;
+    vector<Connection*> pendingReads;     // stopped at MAX_READ
+    vector<Connection*> retryReads;
+    vector<unique_ptr<Connection>> closedConnections;    // freed after each iteration
+
+    stringbuf captured;              // console output of the current request
+    string pushFrame;
+
+    // Totals since start, reported on shutdown
+    size_t acceptedCount = 0;
+    size_t requestCount = 0;
+    size_t pushCount = 0;
+
+    // When the manager last reported a compaction due
+    chrono::steady_clock::time_point compactionDueSince;
+    bool compactionPending = false;
+
+    static inline volatile sig_atomic_t stopRequested = 0;
+
+    static void raiseFileLimit() {
+        rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    bool startListening(int fd, const string& where) {
+        if (listen(fd, SOMAXCONN) != 0) {
+            cout << "Error: Cannot listen on " << where << ": " << strerror(errno) << endl;
+            ::close(fd);
+            return false;
+        }
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            cout << "Error: epoll_create1 failed: " << strerror(errno) << endl;
+            ::close(fd);
+            return false;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = nullptr;    // the listening socket
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+        listenFd = fd;
+        raiseFileLimit();
+        return true;
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    cout << "Error: accept failed: " << strerror(errno) << endl;
+                }
+                return;
+            }
+            if (socketPath.empty()) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+
+            auto conn = make_unique<Connection>();
+            conn->fd = fd;
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.ptr = conn.get();
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                ::close(fd);
+                continue;
+            }
+            connections[fd] = std::move(conn);
+            ++acceptedCount;
+        }
+    }
+
+    void closeConnection(Connection& c) {
+        if (c.closed) return;
+        c.closed = true;
+        if (c.subscribed) unsubscribe(c);
+        if (c.moreToRead) pendingReads.erase(find(pendingReads.begin(), pendingReads.end(), &c));
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+
+        auto it = connections.find(c.fd);
+        closedConnections.push_back(std::move(it->second));
+        connections.erase(it);
+    }
+
+    void unsubscribe(Connection& c) {
+        auto it = subscribers.find(c.userId);
+        if (it == subscribers.end()) return;
+        auto& list = it->second;
+        list.erase(remove(list.begin(), list.end(), &c), list.end());
+        if (list.empty()) subscribers.erase(it);
+        c.subscribed = false;
+    }
+
+    // Reads until the socket is drained or MAX_READ bytes came in, then
+    // handles every whole frame. Frames that arrived before the peer closed
+    // are still handled.
+    void readFrom(Connection& c) {
+        char buffer[64 * 1024];
+        bool ended = false;
+        size_t received = 0;
+        while (true) {
+            if (received >= MAX_READ) {
+                c.moreToRead = true;
+                pendingReads.push_back(&c);
+                break;
+            }
+            ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                c.in.append(buffer, static_cast<size_t>(n));
+                received += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            ended = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
+        }
+
+        size_t used = wire::forEachFrame(c.in.data(), c.in.size(),
+                                         [&](wire::FrameType type, recordio::RecordReader& payload) {
+                                             return handle(c, type, payload);
+                                         });
+        if (used == SIZE_MAX || ended) {
+            if (ended && used != SIZE_MAX) flush(c);
+            closeConnection(c);
+            return;
+        }
+        c.in.erase(0, used);
+        if (c.in.size() > wire::MAX_FRAME + recordio::RECORD_HEADER_SIZE) closeConnection(c);
+    }
+
+    // Reads on from the connections that stopped at MAX_READ last time
+    void retryPendingReads() {
+        retryReads.swap(pendingReads);
+        for (Connection* c : retryReads) c->moreToRead = false;
+        for (Connection* c : retryReads) {
+            if (!c->closed && !c->moreToRead) readFrom(*c);
+        }
+        retryReads.clear();
+    }
+
+    void queue(Connection& c) {
+        if (c.queued || c.closed) return;
+        c.queued = true;
+        pendingWrites.push_back(&c);
+    }
+
+    void reply(Connection& c, wire::FrameType type, string_view text) {
+        size_t start = wire::beginFrame(c.out, type);
+        recordio::putString(c.out, text);
+        wire::endFrame(c.out, start);
+        queue(c);
+    }
+
+    // Replies OK with detail, or ERROR with the manager's message
+    void replyResult(Connection& c, bool ok, string_view detail = {}) {
+        if (ok) {
+            reply(c, wire::FrameType::OK, detail);
+            return;
+        }
+        string text = captured.str();
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+        size_t lastLine = text.rfind('\n');
+        if (lastLine != string::npos) text.erase(0, lastLine + 1);
+        reply(c, wire::FrameType::ERROR, text.empty() ? "Error: Request failed!" : text);
+    }
+
+    // Returns false for a malformed frame, which closes the connection
+    bool handle(Connection& c, wire::FrameType type, recordio::RecordReader& in) {
+        TRACE_SCOPE("MessengerServer::handle");
+        ++requestCount;
+        captured.str("");
+        streambuf* console = cout.rdbuf(&captured);
+        if (!c.userId.empty() && auth.validateSession(c.token) == -1) {
+            cout << "Error: Session expired, log in again!" << endl;
+            setUser(c, "", "");
+        }
+        messenger.setCurrentUser(c.userId);
+        bool wellFormed = dispatch(c, type, in);
+        cout.rdbuf(console);
+        return wellFormed;
+    }
+
+    bool dispatch(Connection& c, wire::FrameType type, recordio::RecordReader& in) {
+        using wire::FrameType;
+        switch (type) {
+        case FrameType::REGISTER: {
+            string userId = in.str();
+            string name = in.str();
+            string password = in.str();
+            if (!in.good()) return false;
+            replyResult(c, auth.registerUser(userId, password, name));
+            return true;
+        }
+        case FrameType::LOGIN: {
+            string userId = in.str();
+            string password = in.str();
+            if (!in.good()) return false;
+            string token = auth.startSession(userId, password);
+            if (!token.empty()) setUser(c, userId, token);
+            replyResult(c, !token.empty(), token);
+            return true;
+        }
+        case FrameType::RESUME: {
+            string token = in.str();
+            if (!in.good()) return false;
+            int id = auth.validateSession(token);
+            const User* user = id == -1 ? nullptr : auth.findUserById(id);
+            if (!user) {
+                cout << "Error: Session expired or unknown!" << endl;
+                replyResult(c, false);
+                return true;
+            }
+            string userId(user->getUsernameView());
+            setUser(c, userId, token);
+            replyResult(c, true, userId);
+            return true;
+        }
+        case FrameType::SUBSCRIBE: {
+            bool ok = messenger.checkLoggedIn();
+            if (ok && !c.subscribed) subscribe(c);
+            replyResult(c, ok);
+            return true;
+        }
+        case FrameType::SEND: {
+            string receiverId = in.str();
+            string text = in.str();
+            if (!in.good()) return false;
+            auto message = messenger.sendMessage(receiverId, text);
+            replyResult(c, message != nullptr, message ? message->getMessageIdView() : string_view());
+            return true;
+        }
+        case FrameType::GROUP_CREATE: {
+            string name = in.str();
+            string memberList = in.str();
+            if (!in.good()) return false;
+            vector<string> members;
+            stringstream ss(memberList);
+            string id;
+            while (getline(ss, id, ',')) {
+                if (!id.empty()) members.push_back(id);
+            }
+            auto group = messenger.createGroup(name, members);
+            replyResult(c, group != nullptr, group ? group->getGroupId() : string());
+            return true;
+        }
+        case FrameType::GROUP_SEND: {
+            string groupId = in.str();
+            string text = in.str();
+            if (!in.good()) return false;
+            auto message = messenger.sendGroupMessage(groupId, text);
+            replyResult(c, message != nullptr, message ? message->getMessageIdView() : string_view());
+            return true;
+        }
+        case FrameType::PAGE: {
+            string chatId = in.str();
+            bool isGroup = in.i32() != 0;
+            int offset = in.i32();
+            int limit = in.i32();
+            if (!in.good()) return false;
+            auto page = messenger.getMessagePage(chatId, isGroup, offset, limit);
+            if (page.empty() && !captured.str().empty()) {
+                replyResult(c, false);
+                return true;
+            }
+            size_t start = wire::beginFrame(c.out, FrameType::MESSAGES);
+            recordio::putI32(c.out, static_cast<int32_t>(page.size()));
+            for (const auto& msg : page) {
+                wire::putMessage(c.out, msg->getMessageIdView(), msg->getSenderIdView(), msg->getContent(),
+                                 msg->getTimestamp());
+            }
+            wire::endFrame(c.out, start);
+            queue(c);
+            return true;
+        }
+        case FrameType::LIKE: {
+            string messageId = in.str();
+            string chatId = in.str();
+            bool isGroup = in.i32() != 0;
+            if (!in.good()) return false;
+            replyResult(c, messenger.likeMessage(messageId, chatId, isGroup));
+            return true;
+        }
+        default:
+            reply(c, FrameType::ERROR, "Error: Unknown request!");
+            return true;
+        }
+    }
+
+    // Switches the connection to another user (or none), ending the
+    // session it held and keeping its subscription
+    void setUser(Connection& c, const string& userId, const string& token) {
+        if (!c.token.empty() && c.token != token) auth.endSession(c.token);
+        c.token = token;
+        if (userId == c.userId) return;
+        bool resubscribe = c.subscribed;
+        if (resubscribe) unsubscribe(c);
+        c.userId = userId;
+        if (resubscribe && !userId.empty()) subscribe(c);
+    }
+
+    void subscribe(Connection& c) {
+        subscribers[c.userId].push_back(&c);
+        c.subscribed = true;
+    }
+
+    // MessageListener: one PUSH frame, copied to every subscribed
+    // connection of every participant but the sender
+    void push(const string& chatId, bool isGroup, const vector<string>& participants, const Message& message,
+              const string& text) {
+        if (subscribers.empty()) return;
+        pushFrame.clear();
+        size_t start = wire::beginFrame(pushFrame, wire::FrameType::PUSH);
+        recordio::putString(pushFrame, chatId);
+        recordio::putI32(pushFrame, isGroup ? 1 : 0);
+        wire::putMessage(pushFrame, message.getMessageIdView(), message.getSenderIdView(), text,
+                         message.getTimestamp());
+        wire::endFrame(pushFrame, start);
+
+        for (const string& userId : participants) {
+            if (userId == message.getSenderIdView()) continue;
+            auto it = subscribers.find(userId);
+            if (it == subscribers.end()) continue;
+            for (Connection* conn : it->second) {
+                conn->out += pushFrame;
+                queue(*conn);
+                ++pushCount;
+            }
+        }
+    }
+
+    // Writes queued output until done or the socket is full; a full socket
+    // is retried on its next EPOLLOUT edge
+    void flush(Connection& c) {
+        while (c.outSent < c.out.size()) {
+            ssize_t n = send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+            if (n > 0) {
+                c.outSent += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            closeConnection(c);
+            return;
+        }
+        if (c.outSent == c.out.size()) {
+            c.out.clear();
+            c.outSent = 0;
+        } else if (c.out.size() - c.outSent > MAX_PENDING) {
+            closeConnection(c);
+        } else if (c.outSent > c.out.size() / 2) {
+            c.out.erase(0, c.outSent);
+            c.outSent = 0;
+        }
+    }
+
+    // Compacts on an idle loop, or once the compaction has waited too long
+    void compactWhenIdle(bool idle) {
+        if (!messenger.isCompactionDue()) {
+            compactionPending = false;
+            return;
+        }
+        auto now = chrono::steady_clock::now();
+        if (!compactionPending) {
+            compactionPending = true;
+            compactionDueSince = now;
+        }
+        if (idle || now - compactionDueSince >= chrono::milliseconds(COMPACT_MAX_DELAY_MS)) {
+            messenger.compactIfDue();
+            compactionPending = false;
+        }
+    }
+
+    int waitTimeout() const {
+        if (!pendingReads.empty()) return 0;
+        return compactionPending ? COMPACT_IDLE_MS : -1;
+    }
+
+    void flushPending() {
+        for (size_t i = 0; i < pendingWrites.size(); ++i) {
+            Connection* c = pendingWrites[i];
+            c->queued = false;
+            if (!c->closed) flush(*c);
+        }
+        pendingWrites.clear();
+    }
+
+public:
+    // auth must share mgr's UserDirectory
+    MessengerServer(MessengerManager& mgr, AuthenticationService& authService) : messenger(mgr), auth(authService) {
+        messenger.setAutoCompact(false);
+        messenger.setMessageListener([this](const string& chatId, bool isGroup, const vector<string>& participants,
+                                            const Message& message, const string& text) {
+            push(chatId, isGroup, participants, message, text);
+        });
+    }
+
+    ~MessengerServer() {
+        messenger.setMessageListener(nullptr);
+        messenger.setAutoCompact(true);
+        for (auto& [fd, conn] : connections) ::close(fd);
+        if (listenFd >= 0) ::close(listenFd);
+        if (epollFd >= 0) ::close(epollFd);
+        if (!socketPath.empty()) unlink(socketPath.c_str());
+    }
+
+    MessengerServer(const MessengerServer&) = delete;
+    MessengerServer& operator=(const MessengerServer&) = delete;
+
+    // Listens on a Unix-domain socket; a stale socket file is replaced
+    bool listenUnix(const string& path) {
+        sockaddr_un address{};
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            cout << "Error: Socket path must be 1-" << sizeof(address.sun_path) - 1 << " characters!" << endl;
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) unlink(path.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            cout << "Error: Cannot bind " << path << ": " << strerror(errno) << endl;
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        socketPath = path;
+        return startListening(fd, path);
+    }
+
+    // Listens on 127.0.0.1:port
+    bool listenTcp(int port) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            cout << "Error: Cannot bind 127.0.0.1:" << port << ": " << strerror(errno) << endl;
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        return startListening(fd, "127.0.0.1:" + to_string(port));
+    }
+
+    // Serves until requestStop(); call after listenUnix or listenTcp
+    void run() {
+        if (epollFd < 0) return;
+        epoll_event events[MAX_EVENTS];
+        while (!stopRequested) {
+            int timeout = waitTimeout();
+            int n = epoll_wait(epollFd, events, MAX_EVENTS, timeout);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                cout << "Error: epoll_wait failed: " << strerror(errno) << endl;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (!events[i].data.ptr) {
+                    acceptAll();
+                    continue;
+                }
+                Connection& c = *static_cast<Connection*>(events[i].data.ptr);
+                if (c.closed) continue;
+                if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !c.moreToRead) readFrom(c);
+                if (!c.closed && (events[i].events & EPOLLOUT) && c.outSent < c.out.size()) queue(c);
+            }
+            retryPendingReads();
+            flushPending();
+            closedConnections.clear();
+            compactWhenIdle(n == 0 && timeout > 0);
+        }
+
+        cout << "Server stopped: " << acceptedCount << " connection(s), " << requestCount
+             << " request(s), " << pushCount << " push(es)" << endl;
+    }
+
+    // Safe to call from a signal handler
+    static void requestStop() { stopRequested = 1; }
+
+    size_t getConnectionCount() const { return connections.size(); }
+};
+
+#endif // MESSENGER_SERVER_H
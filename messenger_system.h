@@ -2,6 +2,7 @@
 #define MESSENGER_SYSTEM_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
@@ -11,6 +12,9 @@
 #include <fstream>
 #include <sstream>
 
+#include "RenderBuffer.h"
+#include "TextCodec.h"
+
 using namespace std;
 
 // Enum for message status
@@ -32,11 +36,16 @@ class Message {
 private:
     string messageId;
     string senderId;
-    string content;
+    string content;        // plain text, or encoded with codec if set
+    const SymbolTable* codec = nullptr;    // owned by MessengerManager
     time_t timestamp;
     vector<string> likes;  // List of user IDs who liked the message
     MessageStatus status;
 
+    static size_t heapBytes(const string& s) {
+        return s.capacity() > string().capacity() ? s.capacity() + 1 : 0;
+    }
+
 public:
     // Constructor
     Message(const string& msgId, const string& sender, const string& cont)
@@ -46,16 +55,57 @@ public:
     // Getters
     string getMessageId() const { return messageId; }
     string getSenderId() const { return senderId; }
-    string getContent() const { return content; }
+    string getContent() const { return codec ? codec->decode(content) : content; }
+
+    // Non-owning views; valid while the message is alive and unmodified
+    string_view getMessageIdView() const { return messageId; }
+    string_view getSenderIdView() const { return senderId; }
     time_t getTimestamp() const { return timestamp; }
     vector<string> getLikes() const { return likes; }
     MessageStatus getStatus() const { return status; }
 
     // Setters
     void setStatus(MessageStatus s) { status = s; }
-    void setContent(const string& cont) { content = cont; }
+    void setContent(const string& cont) {
+        content = cont;
+        codec = nullptr;
+    }
     void setTimestamp(time_t t) { timestamp = t; }
 
+    // Content compression: the text stays encoded in memory and is decoded
+    // only when written out. Kept plain if encoding would not shrink it.
+    // The table must outlive the message; the manager keeps one for good.
+    void compressContent(const SymbolTable* table) {
+        if (codec || !table) return;
+        string encoded;
+        table->encode(content, encoded);
+        if (encoded.size() < content.size()) {
+            encoded.shrink_to_fit();
+            content = std::move(encoded);
+            codec = table;
+        }
+    }
+
+    bool isContentCompressed() const { return codec != nullptr; }
+
+    // Writes the text to out (an ostream or RenderBuffer), decoding on the way
+    template <typename Out>
+    void writeContent(Out& out) const {
+        if (codec) {
+            codec->decodeTo(content, out);
+        } else {
+            out << string_view(content);
+        }
+    }
+
+    // Bytes held by this message, its strings' heap blocks included
+    size_t memoryBytes() const {
+        size_t bytes = sizeof(Message) + heapBytes(messageId) + heapBytes(senderId) + heapBytes(content);
+        bytes += likes.capacity() * sizeof(string);
+        for (const auto& userId : likes) bytes += heapBytes(userId);
+        return bytes;
+    }
+
     // Like functionality
     bool addLike(const string& userId) {
         if (find(likes.begin(), likes.end(), userId) == likes.end()) {
@@ -80,24 +130,38 @@ public:
 
     // Display
     void display() const {
-        cout << "From: " << senderId << endl;
-        cout << "Message: " << content << endl;
-        cout << "Likes: " << likes.size() << endl;
-        cout << "Time: " << ctime(&timestamp);
+        RenderBuffer out;
+        display(out);
+    }
+
+    void display(RenderBuffer& out) const {
+        out << "From: " << senderId << '\n';
+        out << "Message: ";
+        writeContent(out);
+        out << '\n';
+        out << "Likes: " << likes.size() << '\n';
+        out << "Time: ";
+        out.timestamp(timestamp) << '\n';
     }
 
     // Serialization
     string toCSV() const {
         stringstream ss;
-        ss << messageId << "," << senderId << "," << content << "," 
-           << timestamp << "," << static_cast<int>(status) << ",";
+        writeCSV(ss);
+        return ss.str();
+    }
+
+    // Streams the CSV row straight to out without building a temporary string
+    void writeCSV(ostream& out) const {
+        out << messageId << "," << senderId << ",";
+        writeContent(out);
+        out << "," << timestamp << "," << static_cast<int>(status) << ",";
         
         // Add likes (separated by semicolons)
         for (size_t i = 0; i < likes.size(); i++) {
-            ss << likes[i];
-            if (i < likes.size() - 1) ss << ";";
+            out << likes[i];
+            if (i < likes.size() - 1) out << ";";
         }
-        return ss.str();
     }
 
     static Message fromCSV(const string& csvLine) {
@@ -143,6 +207,9 @@ private:
     vector<string> participantIds;  // Exactly 2 participants
     vector<shared_ptr<Message>> messages;
     time_t createdAt;
+    bool historyLoaded = true;
+    int unloadedCount = 0;      // message count while the history is on disk
+    int archivedCount = 0;      // older messages moved to the cold store
 
 public:
     // Constructor
@@ -159,20 +226,52 @@ public:
     vector<shared_ptr<Message>> getMessages() const { return messages; }
     time_t getCreatedAt() const { return createdAt; }
 
+    // Non-owning views for render and save loops
+    const vector<string>& getParticipantIdsView() const { return participantIds; }
+    const vector<shared_ptr<Message>>& getMessagesView() const { return messages; }
+
     // Check if user is participant
-    bool isParticipant(const string& userId) const {
+    bool isParticipant(string_view userId) const {
         return find(participantIds.begin(), participantIds.end(), userId) != participantIds.end();
     }
 
-    // Add message
+    // Add message; while the history is unloaded it is only counted
     bool addMessage(shared_ptr<Message> message) {
-        if (!isParticipant(message->getSenderId())) {
+        if (!isParticipant(message->getSenderIdView())) {
             return false;
         }
+        if (!historyLoaded) {
+            ++unloadedCount;
+            return true;
+        }
         messages.push_back(message);
         return true;
     }
 
+    // History on demand: MessengerManager keeps only the message count of
+    // a chat it has not opened, and loads or drops the messages as needed
+    bool isHistoryLoaded() const { return historyLoaded; }
+
+    void markUnloaded(int count) {
+        messages.clear();
+        messages.shrink_to_fit();
+        unloadedCount = count;
+        historyLoaded = false;
+    }
+
+    void unloadMessages() {
+        markUnloaded(static_cast<int>(messages.size()));
+    }
+
+    void loadMessages(vector<shared_ptr<Message>> loaded) {
+        messages = std::move(loaded);
+        historyLoaded = true;
+    }
+
+    // Archived messages come before the ones in getMessagesView()
+    int getArchivedCount() const { return archivedCount; }
+    void setArchivedCount(int count) { archivedCount = count; }
+
     // Get recent messages
     vector<shared_ptr<Message>> getRecentMessages(int limit = -1) const {
         if (limit < 0 || limit > static_cast<int>(messages.size())) {
@@ -199,20 +298,26 @@ public:
 
     // Display conversation
     void display() const {
-        cout << "\n=== Conversation: " << conversationId << " ===" << endl;
-        cout << "Participants: " << participantIds[0] << " <-> " << participantIds[1] << endl;
-        cout << "Messages: " << messages.size() << endl;
-        cout << "Created: " << ctime(&createdAt);
+        RenderBuffer out;
+        display(out);
+    }
+
+    void display(RenderBuffer& out) const {
+        out << "\n=== Conversation: " << conversationId << " ===\n";
+        out << "Participants: " << participantIds[0] << " <-> " << participantIds[1] << '\n';
+        out << "Messages: " << messages.size() << '\n';
+        out << "Created: ";
+        out.timestamp(createdAt) << '\n';
         
         for (const auto& msg : messages) {
-            cout << "\n---" << endl;
-            msg->display();
+            out << "\n---\n";
+            msg->display(out);
         }
     }
 
     // Get message count
     int getMessageCount() const {
-        return messages.size();
+        return archivedCount + (historyLoaded ? static_cast<int>(messages.size()) : unloadedCount);
     }
 };
 
@@ -227,6 +332,9 @@ private:
     vector<string> participantIds;
     vector<shared_ptr<Message>> messages;
     time_t createdAt;
+    bool historyLoaded = true;
+    int unloadedCount = 0;      // message count while the history is on disk
+    int archivedCount = 0;      // older messages moved to the cold store
 
 public:
     // Constructor
@@ -243,11 +351,15 @@ public:
     vector<shared_ptr<Message>> getMessages() const { return messages; }
     time_t getCreatedAt() const { return createdAt; }
 
+    // Non-owning views for render and save loops
+    const vector<string>& getParticipantIdsView() const { return participantIds; }
+    const vector<shared_ptr<Message>>& getMessagesView() const { return messages; }
+
     // Setters
     void setGroupName(const string& name) { groupName = name; }
 
     // Check if user is participant
-    bool isParticipant(const string& userId) const {
+    bool isParticipant(string_view userId) const {
         return find(participantIds.begin(), participantIds.end(), userId) != participantIds.end();
     }
 
@@ -281,15 +393,43 @@ public:
         return false;
     }
 
-    // Add message
+    // Add message; while the history is unloaded it is only counted
     bool addMessage(shared_ptr<Message> message) {
-        if (!isParticipant(message->getSenderId())) {
+        if (!isParticipant(message->getSenderIdView())) {
             return false;
         }
+        if (!historyLoaded) {
+            ++unloadedCount;
+            return true;
+        }
         messages.push_back(message);
         return true;
     }
 
+    // History on demand: MessengerManager keeps only the message count of
+    // a chat it has not opened, and loads or drops the messages as needed
+    bool isHistoryLoaded() const { return historyLoaded; }
+
+    void markUnloaded(int count) {
+        messages.clear();
+        messages.shrink_to_fit();
+        unloadedCount = count;
+        historyLoaded = false;
+    }
+
+    void unloadMessages() {
+        markUnloaded(static_cast<int>(messages.size()));
+    }
+
+    void loadMessages(vector<shared_ptr<Message>> loaded) {
+        messages = std::move(loaded);
+        historyLoaded = true;
+    }
+
+    // Archived messages come before the ones in getMessagesView()
+    int getArchivedCount() const { return archivedCount; }
+    void setArchivedCount(int count) { archivedCount = count; }
+
     // Get recent messages
     vector<shared_ptr<Message>> getRecentMessages(int limit = -1) const {
         if (limit < 0 || limit > static_cast<int>(messages.size())) {
@@ -316,27 +456,33 @@ public:
 
     // Display group
     void display() const {
-        cout << "\n=== Group: " << groupName << " ===" << endl;
-        cout << "Group ID: " << groupId << endl;
-        cout << "Admin: " << adminId << endl;
-        cout << "Participants (" << participantIds.size() << "): ";
+        RenderBuffer out;
+        display(out);
+    }
+
+    void display(RenderBuffer& out) const {
+        out << "\n=== Group: " << groupName << " ===\n";
+        out << "Group ID: " << groupId << '\n';
+        out << "Admin: " << adminId << '\n';
+        out << "Participants (" << participantIds.size() << "): ";
         for (size_t i = 0; i < participantIds.size(); i++) {
-            cout << participantIds[i];
-            if (i < participantIds.size() - 1) cout << ", ";
+            out << participantIds[i];
+            if (i < participantIds.size() - 1) out << ", ";
         }
-        cout << endl;
-        cout << "Messages: " << messages.size() << endl;
-        cout << "Created: " << ctime(&createdAt);
+        out << '\n';
+        out << "Messages: " << messages.size() << '\n';
+        out << "Created: ";
+        out.timestamp(createdAt) << '\n';
         
         for (const auto& msg : messages) {
-            cout << "\n---" << endl;
-            msg->display();
+            out << "\n---\n";
+            msg->display(out);
         }
     }
 
     // Get message count
     int getMessageCount() const {
-        return messages.size();
+        return archivedCount + (historyLoaded ? static_cast<int>(messages.size()) : unloadedCount);
     }
 
     // Get participant count
@@ -37,6 +37,10 @@ private:
         cout << "|  7. View Group Details                                 |" << endl;
         cout << "|  8. Like/Unlike Message                                |" << endl;
         cout << "|  9. View All Users                                     |" << endl;
+        cout << "| 10. Latency Report (admin)                             |" << endl;
+        cout << "| 11. View Older Messages                                |" << endl;
+        cout << "| 12. Message Retention                                  |" << endl;
+        cout << "| 13. Archive Old Messages (admin)                       |" << endl;
         cout << "|  0. Logout                                             |" << endl;
         cout << "|--------------------------------------------------------|" << endl;
         cout << "Enter choice: ";
@@ -67,18 +71,36 @@ private:
         if (convs.empty()) {
             cout << "No conversations yet." << endl;
         } else {
-            cout << "You have " << convs.size() << " conversation(s):" << endl;
+            RenderBuffer out;
+            out << "You have " << convs.size() << " conversation(s):\n";
             for (const auto& conv : convs) {
-                auto participants = conv->getParticipantIds();
-                string otherUser = (participants[0] == messenger.getCurrentUserId()) 
-                                 ? participants[1] : participants[0];
-                cout << "  - With " << messenger.getUsername(otherUser) 
-                     << " (ID: " << otherUser << ")"
-                     << " - " << conv->getMessageCount() << " message(s)" << endl;
+                const auto& participants = conv->getParticipantIdsView();
+                const string& otherUser = (participants[0] == messenger.getCurrentUserIdView()) 
+                                        ? participants[1] : participants[0];
+                out << "  - With " << messenger.getUsernameView(otherUser) 
+                    << " (ID: " << otherUser << ")"
+                    << " - " << conv->getMessageCount() << " message(s)\n";
             }
         }
     }
 
+    // Chat transcript shared by conversations and groups
+    void renderMessages(RenderBuffer& out, const vector<shared_ptr<Message>>& messages) {
+        for (const auto& msg : messages) {
+            bool isMine = (msg->getSenderIdView() == messenger.getCurrentUserIdView());
+            string_view sender = isMine ? "You" : messenger.getUsernameView(msg->getSenderIdView());
+            
+            out << "\n[" << msg->getMessageIdView() << "]\n";
+            out << sender << ": ";
+            msg->writeContent(out);
+            
+            if (msg->getLikeCount() > 0) {
+                out << " [" << msg->getLikeCount() << " ❤️]";
+            }
+            out << '\n';
+        }
+    }
+
     void handleViewConversation() {
         string otherUserId;
         cout << "Enter user ID to view conversation: ";
@@ -92,24 +114,15 @@ private:
 
         printSeparator("CONVERSATION WITH " + messenger.getUsername(otherUserId));
         
-        auto messages = conv->getMessages();
-        if (messages.empty()) {
+        const auto& messages = conv->getMessagesView();
+        if (messages.empty() && conv->getArchivedCount() == 0) {
             cout << "No messages yet." << endl;
             return;
         }
 
-        for (const auto& msg : messages) {
-            bool isMine = (msg->getSenderId() == messenger.getCurrentUserId());
-            string sender = isMine ? "You" : messenger.getUsername(msg->getSenderId());
-            
-            cout << "\n[" << msg->getMessageId() << "]" << endl;
-            cout << sender << ": " << msg->getContent();
-            
-            if (msg->getLikeCount() > 0) {
-                cout << " [" << msg->getLikeCount() << " ❤️]";
-            }
-            cout << endl;
-        }
+        RenderBuffer out;
+        renderArchivedNote(out, conv->getArchivedCount());
+        renderMessages(out, messages);
     }
 
     void handleCreateGroup() {
@@ -166,16 +179,17 @@ private:
         if (myGroups.empty()) {
             cout << "You are not in any groups yet." << endl;
         } else {
-            cout << "You are in " << myGroups.size() << " group(s):" << endl;
+            RenderBuffer out;
+            out << "You are in " << myGroups.size() << " group(s):\n";
             for (const auto& g : myGroups) {
-                cout << "  - " << g->getGroupName() 
-                     << " (ID: " << g->getGroupId() << ")"
-                     << " - " << g->getParticipantCount() << " member(s)"
-                     << " - " << g->getMessageCount() << " message(s)";
-                if (g->getAdminId() == messenger.getCurrentUserId()) {
-                    cout << " [You are admin]";
+                out << "  - " << g->getGroupName() 
+                    << " (ID: " << g->getGroupId() << ")"
+                    << " - " << g->getParticipantCount() << " member(s)"
+                    << " - " << g->getMessageCount() << " message(s)";
+                if (g->getAdminId() == messenger.getCurrentUserIdView()) {
+                    out << " [You are admin]";
                 }
-                cout << endl;
+                out << '\n';
             }
         }
     }
@@ -205,37 +219,32 @@ private:
         }
         cout << endl;
         
-        cout << "\nMembers (" << group->getParticipantCount() << "):" << endl;
-        for (const auto& pid : group->getParticipantIds()) {
-            cout << "  - " << messenger.getUsername(pid);
-            if (pid == messenger.getCurrentUserId()) {
-                cout << " (You)";
-            }
-            if (pid == group->getAdminId()) {
-                cout << " [Admin]";
+        {
+            RenderBuffer out;
+            const string adminId = group->getAdminId();
+            out << "\nMembers (" << group->getParticipantCount() << "):\n";
+            for (const auto& pid : group->getParticipantIdsView()) {
+                out << "  - " << messenger.getUsernameView(pid);
+                if (pid == messenger.getCurrentUserIdView()) {
+                    out << " (You)";
+                }
+                if (pid == adminId) {
+                    out << " [Admin]";
+                }
+                out << '\n';
             }
-            cout << endl;
         }
 
         cout << "\nMessages:" << endl;
-        auto messages = group->getMessages();
-        if (messages.empty()) {
+        const auto& messages = group->getMessagesView();
+        if (messages.empty() && group->getArchivedCount() == 0) {
             cout << "No messages yet." << endl;
             return;
         }
 
-        for (const auto& msg : messages) {
-            bool isMine = (msg->getSenderId() == messenger.getCurrentUserId());
-            string sender = isMine ? "You" : messenger.getUsername(msg->getSenderId());
-            
-            cout << "\n[" << msg->getMessageId() << "]" << endl;
-            cout << sender << ": " << msg->getContent();
-            
-            if (msg->getLikeCount() > 0) {
-                cout << " [" << msg->getLikeCount() << " ❤️]";
-            }
-            cout << endl;
-        }
+        RenderBuffer out;
+        renderArchivedNote(out, group->getArchivedCount());
+        renderMessages(out, messages);
     }
 
     void handleLikeUnlike() {
@@ -264,7 +273,97 @@ private:
         }
     }
 
+    void renderArchivedNote(RenderBuffer& out, int archived) {
+        if (archived > 0) {
+            out << "\n(" << archived << " older message(s) archived - option 11 shows them)\n";
+        }
+    }
+
+    // Pages backwards through a chat's history, archived messages included
+    void handleViewOlderMessages() {
+        string chatId;
+        char typeChoice;
+        cout << "Is this a (c)onversation or (g)roup? ";
+        cin >> typeChoice;
+        cin.ignore();
+        bool isGroup = (typeChoice == 'g' || typeChoice == 'G');
+
+        cout << "Enter " << (isGroup ? "group" : "conversation") << " ID: ";
+        getline(cin, chatId);
+
+        int total = 0;
+        if (isGroup) {
+            auto group = messenger.getGroup(chatId);
+            total = group ? group->getMessageCount() : 0;
+        } else {
+            for (const auto& conv : messenger.getMyConversations()) {
+                if (conv->getConversationId() == chatId) total = conv->getMessageCount();
+            }
+        }
+
+        int end = total;
+        while (end > 0) {
+            int offset = max(0, end - OLDER_PAGE_SIZE);
+            auto page = messenger.getMessagePage(chatId, isGroup, offset, end - offset);
+            if (page.empty()) return;
+
+            printSeparator("MESSAGES " + to_string(offset + 1) + "-" + to_string(end) + " OF " + to_string(total));
+            {
+                RenderBuffer out;
+                renderMessages(out, page);
+            }
+            end = offset;
+            if (end == 0) break;
+
+            char more;
+            cout << "\nShow older messages? (y/n): ";
+            cin >> more;
+            cin.ignore();
+            if (more != 'y' && more != 'Y') break;
+        }
+        if (total == 0) cout << "No messages found." << endl;
+    }
+
+    void handleRetention() {
+        string chatId;
+        char typeChoice;
+        RetentionPolicy policy;
+        cout << "Is this a (c)onversation or (g)roup? ";
+        cin >> typeChoice;
+        cin.ignore();
+        bool isGroup = (typeChoice == 'g' || typeChoice == 'G');
+
+        cout << "Enter " << (isGroup ? "group" : "conversation") << " ID: ";
+        getline(cin, chatId);
+        RetentionPolicy current = messenger.getRetention(chatId);
+        cout << "Current: " << current.maxAgeDays << " day(s), " << current.maxMessages
+             << " message(s) (0 = no limit)" << endl;
+        cout << "Keep messages for how many days? (0 = forever): ";
+        cin >> policy.maxAgeDays;
+        cout << "Keep at most how many messages? (0 = all): ";
+        cin >> policy.maxMessages;
+        cin.ignore();
+        if (!cin) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << "Invalid number!" << endl;
+            return;
+        }
+        messenger.setRetention(chatId, isGroup, policy);
+    }
+
+    void handleLatencyReport() {
+        printSeparator("LATENCY REPORT");
+        LatencyTrace::report(cout);
+        if (LatencyTrace::dump(LATENCY_REPORT_FILE)) {
+            cout << "Saved to " << LATENCY_REPORT_FILE << endl;
+        }
+    }
+
 public:
+    static constexpr const char* LATENCY_REPORT_FILE = "messenger_latency.txt";
+    static constexpr int OLDER_PAGE_SIZE = 20;
+
     MessengerUI(MessengerManager& mgr) : messenger(mgr) {}
 
     void runChatInterface() {
@@ -285,6 +384,10 @@ public:
                 case 7: handleViewGroupDetails(); break;
                 case 8: handleLikeUnlike(); break;
                 case 9: messenger.displayAllUsers(); break;
+                case 10: handleLatencyReport(); break;
+                case 11: handleViewOlderMessages(); break;
+                case 12: handleRetention(); break;
+                case 13: messenger.archiveOldMessages(); break;
                 case 0: 
                     messenger.logout();
                     cout << "Logged out successfully!" << endl;
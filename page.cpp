@@ -1,46 +1,788 @@
-#include "Page.h"
+#include "page.h"
 #include "User.h"
 #include "Post.h"
+#include "AuthenticationService.h"
+#include "PostStore.h"
+#include "Like.h"
+#include "Comment.h"
+#include "RenderBuffer.h"
+#include "RecordIO.h"
 #include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
 #include<limits>
 
 using namespace std;
+using namespace recordio;
 
-Page::Page(const string& name) : pageName(name) {}
+const char Page::MAGIC[8] = {'S', 'N', 'P', 'A', 'G', 'E', 'S', '1'};
 
-bool Page::addFollower(User* user)
+Page::Page(const string& name, AuthenticationService& auth, PostStore& store, const string& file)
+    : pageName(name), path(file.empty() ? fileFor(name) : file),
+      authService(auth), postStore(store)
+{
+    load();
+
+    log.open(path, ios::binary | ios::app);
+    if (!log.is_open())
+    {
+        cout << "Error: Could not open " << path << " for writing!\n";
+    }
+    else if (logSize == 0)
+    {
+        log.write(MAGIC, sizeof(MAGIC));
+        logSize = sizeof(MAGIC);
+
+        string payload;
+        putString(payload, pageName);
+        appendRecord(REC_INFO, payload);
+    }
+
+    reader.open(path, ios::binary);
+
+    Post::addObserver(this);
+}
+
+Page::~Page()
+{
+    Post::removeObserver(this);
+    if (feed)
+        feed->removeSource(this);
+}
+
+string Page::fileFor(const string& name)
+{
+    string key;
+    for (char c : name)
+    {
+        unsigned char u = static_cast<unsigned char>(c);
+        key += isalnum(u) ? static_cast<char>(tolower(u)) : '_';
+    }
+    return "page_" + key + ".dat";
+}
+
+vector<string> Page::findSavedPages()
+{
+    vector<string> names;
+    error_code ec;
+    for (const auto& file : filesystem::directory_iterator(".", ec))
+    {
+        string fileName = file.path().filename().string();
+        if (fileName.rfind("page_", 0) != 0 || file.path().extension() != ".dat")
+            continue;
+
+        // The display name is the first record after the magic
+        ifstream in(file.path(), ios::binary);
+        char magic[sizeof(MAGIC)];
+        char header[RECORD_HEADER_SIZE];
+        if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+            continue;
+        if (!in.read(header, sizeof(header)) || header[0] != REC_INFO)
+            continue;
+
+        uint32_t length;
+        memcpy(&length, header + 1, sizeof(length));
+        string payload(length, '\0');
+        if (!in.read(&payload[0], length))
+            continue;
+
+        RecordReader rec(payload.data(), payload.size());
+        string name = rec.str();
+        if (rec.good())
+            names.push_back(name);
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
+
+// ─────────────── Log ───────────────
+
+void Page::load()
+{
+    error_code ec;
+    uintmax_t fileSize = filesystem::file_size(path, ec);
+    if (ec || fileSize == 0)
+        return;
+
+    if (fileSize < sizeof(MAGIC))
+    {
+        filesystem::resize_file(path, 0, ec);
+        return;
+    }
+
+    size_t validBytes = visitFile(path, fileSize,
+        [this](const char* data, size_t size) { return replay(data, size); });
+    if (validBytes == 0)
+    {
+        cout << "Error: Could not read " << path << "\n";
+        return;
+    }
+
+    if (validBytes < fileSize)
+    {
+        // Drop a torn tail so new records are appended after the last good one
+        filesystem::resize_file(path, validBytes, ec);
+    }
+    logSize = validBytes;
+}
+
+// Indexes posts and replays follows; post bodies are left on disk
+size_t Page::replay(const char* data, size_t size)
+{
+    if (memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        cout << "Error: " << path << " is not a page file; ignoring it.\n";
+        return size;
+    }
+
+    unordered_map<int, User*> usersById;
+    for (User& u : authService.getUsers())
+        usersById[u.getUserId()] = &u;
+
+    int lastPostId = 0;
+    size_t offset = sizeof(MAGIC);
+    while (size - offset >= RECORD_HEADER_SIZE)
+    {
+        uint8_t type = static_cast<uint8_t>(data[offset]);
+        uint32_t length;
+        memcpy(&length, data + offset + 1, sizeof(length));
+
+        if (size - offset - RECORD_HEADER_SIZE < length)
+            break;   // torn record
+
+        RecordReader rec(data + offset + RECORD_HEADER_SIZE, length);
+        if (type == REC_INFO)
+        {
+            string name = rec.str();
+            if (rec.good())
+                pageName = name;
+        }
+        else if (type == REC_POST)
+        {
+            int postId = rec.i32();
+            rec.i32();                                  // author
+            time_t createdAt = static_cast<time_t>(rec.i64());
+            if (rec.good())
+            {
+                entries.push_back({postId, createdAt, offset, length});
+                lastPostId = max(lastPostId, postId);
+            }
+        }
+        else if (type == REC_FOLLOW || type == REC_UNFOLLOW)
+        {
+            int userId = rec.i32();
+            time_t at = static_cast<time_t>(rec.i64());
+            if (rec.good())
+            {
+                auto it = usersById.find(userId);
+                if (type == REC_UNFOLLOW)
+                {
+                    if (unfollow(userId))
+                        analytics.record(PageAnalytics::UNFOLLOW, at);
+                }
+                else if (it != usersById.end() && follow(it->second))
+                {
+                    analytics.record(PageAnalytics::FOLLOW, at);
+                }
+            }
+        }
+        else if (type >= REC_LIKE && type <= REC_SHARE)
+        {
+            // Only indexed here; materialize replays it onto the post
+            int postId = rec.i32();
+            if (type != REC_SHARE)
+                rec.i32();                              // user
+            time_t at = static_cast<time_t>(rec.i64());
+            if (rec.good())
+            {
+                PageAnalytics::Event event = type == REC_LIKE   ? PageAnalytics::LIKE
+                                           : type == REC_UNLIKE ? PageAnalytics::UNLIKE
+                                           : type == REC_SHARE  ? PageAnalytics::SHARE
+                                                                : PageAnalytics::COMMENT;
+                analytics.record(event, at, postId);
+                engagementOffsets[postId].push_back(offset);
+            }
+        }
+        else if (type == REC_ENGAGEMENT)
+        {
+            int event = rec.i32();
+            int postId = rec.i32();
+            time_t at = static_cast<time_t>(rec.i64());
+            if (rec.good() && event >= PageAnalytics::LIKE && event <= PageAnalytics::UNLIKE)
+                analytics.record(static_cast<PageAnalytics::Event>(event), at, postId);
+        }
+
+        offset += RECORD_HEADER_SIZE + length;
+    }
+
+    if (lastPostId > 0)
+        postStore.reservePostIds(lastPostId);
+    return offset;
+}
+
+uint64_t Page::appendRecord(RecordType type, const string& payload)
+{
+    lock_guard<mutex> lock(pageMutex);
+    return appendRecordLocked(type, payload);
+}
+
+// Caller holds pageMutex
+uint64_t Page::appendRecordLocked(RecordType type, const string& payload)
+{
+    uint64_t offset = logSize;
+    if (!log.is_open())
+        return offset;
+
+    writeRecord(log, type, payload);
+    log.flush();
+    logSize += RECORD_HEADER_SIZE + payload.size();
+    return offset;
+}
+
+// Caller holds pageMutex
+bool Page::readRecord(uint64_t offset, uint8_t& type, string& payload) const
+{
+    char header[RECORD_HEADER_SIZE];
+    reader.clear();
+    reader.seekg(static_cast<streamoff>(offset));
+    if (!reader.read(header, sizeof(header)))
+        return false;
+
+    uint32_t length;
+    memcpy(&length, header + 1, sizeof(length));
+    type = static_cast<uint8_t>(header[0]);
+    payload.assign(length, '\0');
+    return static_cast<bool>(reader.read(&payload[0], length));
+}
+
+// Replays one logged like, unlike, comment or share onto a post being read
+// back. The post is not in loaded yet, so the hooks do not log it again.
+void Page::applyEngagement(Post& post, uint8_t type, const string& payload) const
+{
+    RecordReader rec(payload.data(), payload.size());
+    rec.i32();                                      // post ID
+    if (type == REC_SHARE)
+    {
+        post.sharePost();
+        return;
+    }
+
+    User* user = authService.findUserById(rec.i32());
+    time_t at = static_cast<time_t>(rec.i64());
+    if (!rec.good() || !user)
+        return;
+
+    if (type == REC_LIKE)
+    {
+        post.addLike(user, at);
+    }
+    else if (type == REC_UNLIKE)
+    {
+        post.removeLike(post.findLikeBy(user->getUserId()));
+    }
+    else if (type == REC_COMMENT || type == REC_REPLY)
+    {
+        int capacity = rec.i32();
+        int parentId = 0;
+        if (type == REC_REPLY)
+        {
+            int32_t parentPos = rec.i32();
+            const AppendOnlyList<Comment*>& existing = post.getComments();
+            if (parentPos < 0 || static_cast<size_t>(parentPos) >= existing.size())
+                return;
+            parentId = existing[static_cast<size_t>(parentPos)]->getCommentId();
+        }
+        string text = rec.str();
+        if (rec.good())
+            post.addComment(user, text, static_cast<size_t>(capacity), at, parentId);
+    }
+}
+
+Post* Page::materialize(const PostEntry& entry) const
 {
-    for (auto* u : followers)
-        if (u == user)
-            return false;
+    string payload;
+    vector<pair<uint8_t, string>> engagement;
+    {
+        lock_guard<mutex> lock(pageMutex);
+        auto it = loaded.find(entry.postId);
+        if (it != loaded.end())
+            return it->second.get();
 
+        uint8_t type;
+        if (!readRecord(entry.offset, type, payload))
+            return nullptr;
+
+        auto offsets = engagementOffsets.find(entry.postId);
+        if (offsets != engagementOffsets.end())
+        {
+            for (uint64_t offset : offsets->second)
+            {
+                engagement.emplace_back();
+                if (!readRecord(offset, engagement.back().first, engagement.back().second))
+                    engagement.pop_back();
+            }
+        }
+    }
+
+    RecordReader rec(payload.data(), payload.size());
+    int postId       = rec.i32();
+    int authorId     = rec.i32();
+    time_t createdAt = static_cast<time_t>(rec.i64());
+    int capacity     = rec.i32();
+    string category  = rec.str();
+    string text      = rec.str();
+    User* author = authService.findUserById(authorId);
+    if (!rec.good() || !author)
+        return nullptr;
+
+    // Built and replayed outside pageMutex: the engagement hooks take it
+    unique_ptr<Post> post(new Post(postId, author, text, static_cast<size_t>(capacity), category, createdAt));
+    for (const auto& [type, record] : engagement)
+        applyEngagement(*post, type, record);
+
+    lock_guard<mutex> lock(pageMutex);
+    auto [it, added] = loaded.emplace(postId, nullptr);
+    if (added)
+        it->second = std::move(post);    // else another thread read it back first
+    return it->second.get();
+}
+
+size_t Page::boundFor(const FeedCursor& cursor) const
+{
+    if (cursor.fromNewest)
+        return entries.size();
+
+    auto it = lower_bound(entries.begin(), entries.end(), cursor,
+        [](const PostEntry& e, const FeedCursor& c)
+        {
+            if (e.createdAt != c.createdAt)
+                return e.createdAt < c.createdAt;
+            return e.postId < c.postId;
+        });
+    return static_cast<size_t>(it - entries.begin());
+}
+
+// ─────────────── Followers ───────────────
+
+bool Page::follow(User* user)
+{
+    if (followerSlots.count(user->getUserId()))
+        return false;
+
+    followerSlots[user->getUserId()] = followers.size();
     followers.push_back(user);
-    cout << user->getUsername() << " followed " << pageName << endl;
     return true;
 }
 
-void Page::addPost(Post* post)
+bool Page::unfollow(int userId)
+{
+    auto it = followerSlots.find(userId);
+    if (it == followerSlots.end())
+        return false;
+
+    // Move the last follower into the freed slot
+    size_t slot = it->second;
+    followerSlots.erase(it);
+    if (slot != followers.size() - 1)
+    {
+        followers[slot] = followers.back();
+        followerSlots[followers[slot]->getUserId()] = slot;
+    }
+    followers.pop_back();
+    return true;
+}
+
+void Page::attachFeed(FeedService* feedService)
+{
+    if (feed)
+        feed->removeSource(this);
+
+    feed = feedService;
+    if (!feed)
+        return;
+
+    // Followers already here get the recent posts on their next feed read
+    feed->addSource(this);
+}
+
+bool Page::addFollower(User* user)
+{
+    if (!user || followerSlots.count(user->getUserId()))
+        return false;
+
+    follow(user);
+
+    time_t now = time(nullptr);
+    string payload;
+    putI32(payload, user->getUserId());
+    putI64(payload, static_cast<int64_t>(now));
+    {
+        lock_guard<mutex> lock(pageMutex);
+        appendRecordLocked(REC_FOLLOW, payload);
+        analytics.record(PageAnalytics::FOLLOW, now);
+    }
+
+    cout << user->getUsernameView() << " followed " << pageName << endl;
+
+    if (feed)
+        feed->backfillFollower(user->getUserId(), this);
+    return true;
+}
+
+bool Page::removeFollower(User* user)
+{
+    if (!user || !followerSlots.count(user->getUserId()))
+        return false;
+
+    unfollow(user->getUserId());
+
+    time_t now = time(nullptr);
+    string payload;
+    putI32(payload, user->getUserId());
+    putI64(payload, static_cast<int64_t>(now));
+    {
+        lock_guard<mutex> lock(pageMutex);
+        appendRecordLocked(REC_UNFOLLOW, payload);
+        analytics.record(PageAnalytics::UNFOLLOW, now);
+    }
+
+    cout << user->getUsernameView() << " unfollowed " << pageName << endl;
+
+    if (feed)
+        feed->removeFollower(user->getUserId(), this);
+    return true;
+}
+
+size_t Page::getFollowerCount() const
+{
+    return followers.size();
+}
+
+const string& Page::getName() const
+{
+    return pageName;
+}
+
+const PageAnalytics& Page::getAnalytics() const
+{
+    return analytics;
+}
+
+// ─────────────── Posts ───────────────
+
+Post* Page::addPost(User* author, const string& text, const string& category)
+{
+    if (!author)
+        return nullptr;
+
+    Post* post = new Post(postStore.allocatePostId(), author, text, 500, category);
+
+    string payload;
+    putI32(payload, post->getPostId());
+    putI32(payload, author->getUserId());
+    putI64(payload, static_cast<int64_t>(post->getCreationTime()));
+    putI32(payload, static_cast<int32_t>(post->getMaxCapacity()));
+    putString(payload, post->getCategoryView());
+    putString(payload, post->getTextView());
+    uint64_t offset;
+    {
+        lock_guard<mutex> lock(pageMutex);
+        loaded[post->getPostId()].reset(post);
+        offset = appendRecordLocked(REC_POST, payload);
+    }
+
+    entries.push_back({post->getPostId(), post->getCreationTime(), offset,
+                       static_cast<uint32_t>(payload.size())});
+    fanOut(post);
+    return post;
+}
+
+size_t Page::getPostCount() const
+{
+    return entries.size();
+}
+
+void Page::fanOut(Post* post)
+{
+    if (!feed || !post)
+        return;
+
+    if (isPulled())
+    {
+        // Too many timelines to write; followers pull this page instead
+        feed->indexPost(post);
+        return;
+    }
+
+    vector<int> batch;
+    batch.reserve(min(FANOUT_BATCH, followers.size()));
+    for (size_t start = 0; start < followers.size(); start += FANOUT_BATCH)
+    {
+        size_t end = min(start + FANOUT_BATCH, followers.size());
+        batch.clear();
+        for (size_t i = start; i < end; ++i)
+            batch.push_back(followers[i]->getUserId());
+        feed->fanOut(post, batch.data(), batch.size());
+    }
+    if (followers.empty())
+        feed->indexPost(post);
+}
+
+FeedPage Page::getTimelinePage(size_t pageSize, const FeedCursor& cursor) const
+{
+    FeedPage page;
+    size_t i = boundFor(cursor);
+    while (i > 0 && page.posts.size() < pageSize)
+    {
+        Post* p = materialize(entries[--i]);
+        if (p && !p->isDeletedPost())
+            page.posts.push_back(p);
+    }
+
+    if (!page.posts.empty())
+    {
+        const Post* last = page.posts.back();
+        page.next.createdAt = last->getCreationTime();
+        page.next.postId = last->getPostId();
+        page.next.fromNewest = false;
+    }
+    page.hasMore = i > 0;
+    return page;
+}
+
+// ─────────────── FeedSource ───────────────
+
+bool Page::isFollowedBy(int userId) const
+{
+    return followerSlots.count(userId) != 0;
+}
+
+bool Page::isPulled() const
+{
+    return followers.size() > PULL_THRESHOLD;
+}
+
+vector<Post*> Page::postsBefore(const FeedCursor& cursor, size_t limit) const
+{
+    size_t end = boundFor(cursor);
+    size_t begin = end - min(limit, end);
+
+    vector<Post*> result;
+    result.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (Post* p = materialize(entries[i]))
+            result.push_back(p);
+    }
+    return result;
+}
+
+bool Page::hasPost(const FeedEntry& entry) const
+{
+    FeedCursor after;
+    after.createdAt = entry.createdAt;
+    after.postId = entry.postId + 1;
+    after.fromNewest = false;
+    size_t i = boundFor(after);
+    return i > 0 && entries[i - 1].postId == entry.postId;
+}
+
+// ─────────────── Engagement ───────────────
+
+// Page posts are only engaged with once something has loaded them.
+// Caller holds pageMutex, as for recordEngagement.
+bool Page::isPagePost(int postId) const
+{
+    return loaded.count(postId) != 0;
+}
+
+void Page::recordEngagement(RecordType type, const string& payload,
+                            PageAnalytics::Event event, int postId, time_t at)
+{
+    engagementOffsets[postId].push_back(appendRecordLocked(type, payload));
+    analytics.record(event, at, postId);
+}
+
+void Page::onLikeAdded(const Post& post, const Like& like)
+{
+    lock_guard<mutex> lock(pageMutex);
+    if (!isPagePost(post.getPostId()) || !like.getUser())
+        return;
+
+    string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, like.getUser()->getUserId());
+    putI64(payload, static_cast<int64_t>(like.getTime()));
+    recordEngagement(REC_LIKE, payload, PageAnalytics::LIKE, post.getPostId(), like.getTime());
+}
+
+// Logged at the like's own time, so it comes out of the bucket it went into
+void Page::onLikeRemoved(const Post& post, const Like& like)
+{
+    lock_guard<mutex> lock(pageMutex);
+    if (!isPagePost(post.getPostId()) || !like.getUser())
+        return;
+
+    string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, like.getUser()->getUserId());
+    putI64(payload, static_cast<int64_t>(like.getTime()));
+    recordEngagement(REC_UNLIKE, payload, PageAnalytics::UNLIKE, post.getPostId(), like.getTime());
+}
+
+void Page::onCommentAdded(const Post& post, const Comment& comment)
+{
+    lock_guard<mutex> lock(pageMutex);
+    if (!isPagePost(post.getPostId()) || !comment.getAuthor())
+        return;
+
+    string payload;
+    putI32(payload, post.getPostId());
+    putI32(payload, comment.getAuthor()->getUserId());
+    putI64(payload, static_cast<int64_t>(comment.getCreationTime()));
+    putI32(payload, static_cast<int32_t>(comment.getMaxCapacity()));
+
+    RecordType type = REC_COMMENT;
+    if (comment.isReply())
+    {
+        // As in PostStore, a reply refers to its parent by position
+        int parentPos = post.getCommentIndexLocked(comment.getParentId());
+        if (parentPos < 0)
+        {
+            cout << "Error: Parent of comment #" << comment.getCommentId() << " not found on post #"
+                 << post.getPostId() << "; reply not saved.\n";
+            return;
+        }
+        putI32(payload, static_cast<int32_t>(parentPos));
+        type = REC_REPLY;
+    }
+    putString(payload, comment.getTextView());
+    recordEngagement(type, payload, PageAnalytics::COMMENT, post.getPostId(), comment.getCreationTime());
+}
+
+void Page::onPostShared(const Post& post)
 {
-    posts.push_back(post);
+    lock_guard<mutex> lock(pageMutex);
+    if (!isPagePost(post.getPostId()))
+        return;
+
+    time_t now = time(nullptr);
+    string payload;
+    putI32(payload, post.getPostId());
+    putI64(payload, static_cast<int64_t>(now));
+    recordEngagement(REC_SHARE, payload, PageAnalytics::SHARE, post.getPostId(), now);
 }
 
+// ─────────────── Display ───────────────
+
 void Page::showPageInfo() const
 {
-    cout << "\nPage Name : " << pageName << endl;
-    cout << "Followers : " << followers.size() << endl;
+    RenderBuffer out;
+    out << "\nPage Name : " << pageName << '\n';
+    out << "Followers : " << followers.size() << '\n';
+    out << "Posts     : " << entries.size() << '\n';
+
+    time_t now = time(nullptr);
+    EngagementCounts week;
+    {
+        lock_guard<mutex> lock(pageMutex);
+        week = analytics.totals(now - 7 * PageAnalytics::DAY_SECONDS, now);
+    }
+    out << "This week : +" << week.follows << " / -" << week.unfollows << " followers\n";
+    if (isPulled())
+        out << "Delivery  : pulled by followers at read time\n";
 }
 
 void Page::showTimeline() const
 {
+    const size_t TIMELINE_PAGE_SIZE = 5;
+    FeedCursor cursor;
+    string inputLine;
+
     cout << "\n===== " << pageName << " Timeline =====\n";
-    for (auto* p : posts)
-        p->viewPost();   // FROM Post.cpp
+    if (entries.empty())
+    {
+        cout << "No posts yet.\n";
+        return;
+    }
+
+    while (true)
+    {
+        FeedPage page = getTimelinePage(TIMELINE_PAGE_SIZE, cursor);
+        {
+            RenderBuffer out;
+            for (auto* p : page.posts)
+                p->viewPost(out);   // FROM Post.cpp
+        }
+
+        if (!page.hasMore)
+            break;
+
+        cout << "Press Enter for older posts, or 0 to go back: ";
+        getline(cin, inputLine);
+        if (inputLine == "0")
+            break;
+        cursor = page.next;
+    }
 }
 
 void Page::showLatestPost() const
 {
-    if (!posts.empty())
-        posts.back()->viewPost();
+    if (entries.empty())
+    {
+        cout << "No posts yet.\n";
+        return;
+    }
+
+    if (Post* p = materialize(entries.back()))
+        p->viewPost();
+}
+
+void Page::showAnalytics() const
+{
+    const int DAYS = 7;
+    const size_t RECENT_POSTS = 5;
+
+    time_t now = time(nullptr);
+    time_t dayStart = now - now % PageAnalytics::DAY_SECONDS;
+
+    lock_guard<mutex> lock(pageMutex);
+    RenderBuffer out;
+    out << "\n===== " << pageName << " Analytics =====\n";
+    out << "Followers now: " << analytics.getFollowerCount() << "\n\n";
+
+    out.left("Day (UTC)", 12).right("Follows", 8).right("Unfol.", 8).right("Followers", 10)
+       .right("Likes", 8).right("Comments", 10).right("Shares", 8) << '\n';
+
+    vector<AnalyticsBucket> days = analytics.query(dayStart - (DAYS - 1) * PageAnalytics::DAY_SECONDS,
+                                                   dayStart + PageAnalytics::DAY_SECONDS,
+                                                   PageAnalytics::DAILY);
+    for (const AnalyticsBucket& d : days)
+    {
+        char label[16];
+        strftime(label, sizeof(label), "%Y-%m-%d", gmtime(&d.start));
+        out.left(label, 12).right(d.counts.follows, 8).right(d.counts.unfollows, 8)
+           .right(d.followersAtEnd, 10)
+           .right(d.counts.likes, 8).right(d.counts.comments, 10).right(d.counts.shares, 8) << '\n';
+    }
+
+    EngagementCounts lastDay = analytics.totals(now - PageAnalytics::DAY_SECONDS, now);
+    out << "\nLast 24 hours: " << lastDay.follows << " follows, "
+        << lastDay.likes << " likes, " << lastDay.comments << " comments, "
+        << lastDay.shares << " shares\n";
+
+    if (!entries.empty())
+    {
+        out << "\nRecent posts:\n";
+        for (size_t i = entries.size(); i-- > 0 && entries.size() - i <= RECENT_POSTS; )
+        {
+            EngagementCounts c = analytics.getPostTotals(entries[i].postId);
+            out << "  Post " << entries[i].postId << ": " << c.likes << " likes, "
+                << c.comments << " comments, " << c.shares << " shares\n";
+        }
+    }
 }
 
 void Page::showMenu(vector<User*>& users)
@@ -57,6 +799,8 @@ void Page::showMenu(vector<User*>& users)
         cout << "3. Add Post\n";
         cout << "4. Follow Page\n";
         cout << "5. View Latest Post\n";
+        cout << "6. Unfollow Page\n";
+        cout << "7. View Analytics\n";
         cout << "0. Exit\n";
         cout << "Enter choice: ";
         cin >> choice;
@@ -88,8 +832,9 @@ void Page::showMenu(vector<User*>& users)
             {
                 if (u->getUserId() == uid)
                 {
-                    Post* p = new Post(posts.size() + 1, u, text);
-                    addPost(p);
+                    Post* p = addPost(u, text);
+                    if (p)
+                        cout << "Post published (ID: " << p->getPostId() << ")\n";
                     break;
                 }
             }
@@ -131,6 +876,34 @@ void Page::showMenu(vector<User*>& users)
             showLatestPost();
             break;
 
+        case 6:
+        {
+            int uid;
+            cout << "Enter user ID: ";
+            cin >> uid;
+            cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+            bool found = false;
+            for (auto* u : users)
+            {
+                if (u->getUserId() == uid)
+                {
+                    if (!removeFollower(u))
+                        cout << "User does not follow this page.\n";
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found)
+                cout << "User not found!\n";
+            break;
+        }
+
+        case 7:
+            showAnalytics();
+            break;
+
         case 0:
             cout << "Exiting...\n";
             break;
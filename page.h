@@ -1,33 +1,168 @@
 #ifndef PAGE_H
 #define PAGE_H
 
+#include "FeedService.h"
+#include "PostObserver.h"
+#include "PageAnalytics.h"
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <ctime>
+#include <cstddef>
+#include <cstdint>
 
 class User;
 class Post;
+class AuthenticationService;
+class PostStore;
 
-class Page
+// A page that users follow. Its posts and follows are kept in an
+// append-only log (page_<name>.dat, same record framing as PostStore).
+// Loading a page only indexes the log: each post is remembered by ID,
+// creation time and file offset, and the Post itself is read back the
+// first time a timeline page, the latest post or a follower's feed needs
+// it. Post IDs come from PostStore so they never collide with user posts.
+//
+// Likes, comments and shares on the page's posts are logged per post and
+// replayed onto a post when it is read back; they and follows also feed
+// PageAnalytics, so the rollups survive a restart.
+class Page : public FeedSource, public PostObserver
 {
+public:
+    enum RecordType : std::uint8_t
+    {
+        REC_INFO     = 1,     // page display name, first record
+        REC_POST     = 2,
+        REC_FOLLOW   = 3,
+        REC_UNFOLLOW = 4,
+        REC_ENGAGEMENT = 5,   // PageAnalytics::Event, post ID, time (analytics only, older logs)
+        REC_LIKE     = 6,     // post ID, user ID, time
+        REC_UNLIKE   = 7,     // post ID, user ID, time of the like
+        REC_COMMENT  = 8,     // post ID, user ID, time, capacity, text
+        REC_REPLY    = 9,     // same, with the parent's position before the text
+        REC_SHARE    = 10     // post ID, time
+    };
+
+    // Followers are pushed new posts FANOUT_BATCH at a time; past
+    // PULL_THRESHOLD followers the page stops pushing and readers pull
+    static constexpr std::size_t FANOUT_BATCH = 1024;
+    static constexpr std::size_t PULL_THRESHOLD = 100000;
+
 private:
+    struct PostEntry
+    {
+        int postId;
+        time_t createdAt;
+        std::uint64_t offset;      // start of the record in the log
+        std::uint32_t length;      // payload length
+    };
+
     std::string pageName;
+    std::string path;
+
+    AuthenticationService& authService;
+    PostStore& postStore;
+
+    // Followers in follow order; followerSlots maps a user ID to its slot
+    // so follow, unfollow and membership checks are O(1)
     std::vector<User*> followers;
-    std::vector<Post*> posts;
+    std::unordered_map<int, std::size_t> followerSlots;
+
+    std::vector<PostEntry> entries;                                  // creation order
+    mutable std::unordered_map<int, std::unique_ptr<Post>> loaded;   // post ID -> Post
+
+    // Offsets of each post's engagement records, in log order
+    std::unordered_map<int, std::vector<std::uint64_t>> engagementOffsets;
+
+    std::ofstream log;
+    mutable std::ifstream reader;
+    std::uint64_t logSize = 0;
+
+    FeedService* feed = nullptr;     // not owned
+
+    PageAnalytics analytics;
+
+    // Engagement hooks arrive from any thread that touches a page post;
+    // guards loaded, the log, the reader and analytics
+    mutable std::mutex pageMutex;
+
+    static const char MAGIC[8];
+
+    void load();
+    std::size_t replay(const char* data, std::size_t size);
+    std::uint64_t appendRecord(RecordType type, const std::string& payload);
+    std::uint64_t appendRecordLocked(RecordType type, const std::string& payload);
+
+    Post* materialize(const PostEntry& entry) const;
+    bool readRecord(std::uint64_t offset, std::uint8_t& type, std::string& payload) const;
+    void applyEngagement(Post& post, std::uint8_t type, const std::string& payload) const;
+
+    // Index of the first post that is not older than cursor
+    std::size_t boundFor(const FeedCursor& cursor) const;
+
+    // Return false when nothing changed
+    bool follow(User* user);
+    bool unfollow(int userId);
+    void fanOut(Post* post);
+
+    bool isPagePost(int postId) const;
+    void recordEngagement(RecordType type, const std::string& payload,
+                          PageAnalytics::Event event, int postId, time_t at);
 
 public:
-    Page(const std::string& name);
+    Page(const std::string& name, AuthenticationService& auth, PostStore& store,
+         const std::string& file = "");
+    ~Page() override;
+
+    Page(const Page&) = delete;
+    Page& operator=(const Page&) = delete;
+
+    static std::string fileFor(const std::string& name);
+
+    // Display names of the pages saved in the working directory
+    static std::vector<std::string> findSavedPages();
+
+    // Delivers this page's new posts to followers' news feeds
+    void attachFeed(FeedService* feedService);
 
-    
     bool addFollower(User* user);
-    void addPost(Post* post);
+    bool removeFollower(User* user);
+    std::size_t getFollowerCount() const;
+
+    // Creates, logs and fans out a new page post
+    Post* addPost(User* author, const std::string& text, const std::string& category = "General");
+
+    std::size_t getPostCount() const;
+
+    // Newest-first page of posts older than cursor; only these are loaded
+    FeedPage getTimelinePage(std::size_t pageSize, const FeedCursor& cursor = FeedCursor()) const;
+
 
-    
     void showMenu(std::vector<User*>& users);
 
-    
+
     void showPageInfo() const;
     void showTimeline() const;
     void showLatestPost() const;
+    void showAnalytics() const;
+
+    const std::string& getName() const;
+    const PageAnalytics& getAnalytics() const;    // not while other threads engage
+
+    // FeedSource
+    bool isFollowedBy(int userId) const override;
+    bool isPulled() const override;
+    std::vector<Post*> postsBefore(const FeedCursor& cursor, std::size_t limit) const override;
+    bool hasPost(const FeedEntry& entry) const override;
+
+    // PostObserver, for engagement with this page's posts
+    void onLikeAdded(const Post& post, const Like& like) override;
+    void onLikeRemoved(const Post& post, const Like& like) override;
+    void onCommentAdded(const Post& post, const Comment& comment) override;
+    void onPostShared(const Post& post) override;
 };
 
 #endif